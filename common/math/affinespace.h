@@ -163,6 +163,57 @@ namespace embree
   typedef AffineSpaceT<LinearSpace3fa> AffineSpace3fa;
   typedef AffineSpaceT<Quaternion3f > OrthonormalSpace3f;
 
+  ////////////////////////////////////////////////////////////////////////////////
+  // Quaternion Decomposition
+  ////////////////////////////////////////////////////////////////////////////////
+
+  /*! affine transformation decomposed into translation * rotation * scale/skew/shift,
+   *  interpolating this representation keeps rotations rigid */
+  struct QuaternionDecomposition
+  {
+    __forceinline QuaternionDecomposition () {}
+
+    __forceinline QuaternionDecomposition (OneTy)
+      : scale(one), skew(zero), shift(zero), quaternion(one), translation(zero) {}
+
+    __forceinline QuaternionDecomposition (const Vec3fa& scale, const Vec3fa& skew, const Vec3fa& shift, const Quaternion3f& quaternion, const Vec3fa& translation)
+      : scale(scale), skew(skew), shift(shift), quaternion(quaternion), translation(translation) {}
+
+    /*! returns the upper triangular scale/skew/shift part of the transformation */
+    __forceinline AffineSpace3fa scaleSkewShift() const
+    {
+      return AffineSpace3fa(Vec3fa(scale.x,0.0f,0.0f),
+                            Vec3fa(skew.x,scale.y,0.0f),
+                            Vec3fa(skew.y,skew.z,scale.z),
+                            shift);
+    }
+
+    /*! converts the decomposition into an affine transformation */
+    __forceinline AffineSpace3fa affineSpace() const
+    {
+      const AffineSpace3fa S = scaleSkewShift();
+      const LinearSpace3fa R = LinearSpace3fa(quaternion);
+      return AffineSpace3fa(R*S.l,R*S.p+translation);
+    }
+
+  public:
+    Vec3fa scale;            //!< scale along x, y, and z
+    Vec3fa skew;             //!< skew xy, xz, and yz
+    Vec3fa shift;            //!< shift applied before the rotation
+    Quaternion3f quaternion; //!< unit quaternion describing the rotation
+    Vec3fa translation;      //!< translation applied after the rotation
+  };
+
+  /*! blending, rotations get spherically interpolated */
+  __forceinline QuaternionDecomposition lerp(const QuaternionDecomposition& d0, const QuaternionDecomposition& d1, const float t)
+  {
+    return QuaternionDecomposition(lerp(d0.scale,d1.scale,t),
+                                   lerp(d0.skew,d1.skew,t),
+                                   lerp(d0.shift,d1.shift,t),
+                                   slerp(d0.quaternion,d1.quaternion,t),
+                                   lerp(d0.translation,d1.translation,t));
+  }
+
   ////////////////////////////////////////////////////////////////////////////////
   /*! Template Specialization for 2D: return matrix for rotation around point (rotation around arbitrarty vector is not meaningful in 2D) */
   template<> __forceinline AffineSpace2f AffineSpace2f::rotate(const Vec2f& p, const float& r) { return translate(+p) * AffineSpace2f(LinearSpace2f::rotate(r)) * translate(-p); }
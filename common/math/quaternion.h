@@ -113,6 +113,27 @@ namespace embree
   template<typename T> __forceinline Vec3<T> xfmVector( const QuaternionT<T>& a, const Vec3<T>&       b ) { return (a*QuaternionT<T>(b)*conj(a)).v(); }
   template<typename T> __forceinline Vec3<T> xfmNormal( const QuaternionT<T>& a, const Vec3<T>&       b ) { return (a*QuaternionT<T>(b)*conj(a)).v(); }
 
+  template<typename T> __forceinline T dot( const QuaternionT<T>& a, const QuaternionT<T>& b ) { return a.r*b.r + a.i*b.i + a.j*b.j + a.k*b.k; }
+
+  /*! spherical linear interpolation of two unit quaternions along the shortest arc */
+  template<typename T> __forceinline QuaternionT<T> slerp( const QuaternionT<T>& q0, const QuaternionT<T>& q1_in, const T& t )
+  {
+    T cosTheta = dot(q0,q1_in);
+    const QuaternionT<T> q1 = cosTheta < T(zero) ? -q1_in : q1_in;
+    cosTheta = abs(cosTheta);
+    if (cosTheta > T(0.9995f)) 
+      return normalize((T(one)-t)*q0 + t*q1);
+    
+    const T theta = acos(cosTheta);
+    const T rcpSinTheta = rcp(sin(theta));
+    return (sin((T(one)-t)*theta)*rcpSinTheta)*q0 + (sin(t*theta)*rcpSinTheta)*q1;
+  }
+
+  /*! returns the angle between the two rotations represented by two unit quaternions */
+  template<typename T> __forceinline T rotationAngle( const QuaternionT<T>& q0, const QuaternionT<T>& q1 ) {
+    return T(2.0f)*acos(min(abs(dot(q0,q1)),T(one)));
+  }
+
   ////////////////////////////////////////////////////////////////////////////////
   /// Comparison Operators
   ////////////////////////////////////////////////////////////////////////////////
@@ -175,6 +175,48 @@ namespace embree
   void os_advise(void *ptr, size_t bytes)
   {
   }
+
+  void* os_map_file(const char* fileName, size_t offset, size_t bytes, void*& base, size_t& mappedBytes)
+  {
+    HANDLE file = CreateFileA(fileName,GENERIC_READ,FILE_SHARE_READ,nullptr,OPEN_EXISTING,FILE_ATTRIBUTE_NORMAL,nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+      return nullptr;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file,&fileSize) || size_t(fileSize.QuadPart) < offset+bytes) {
+      CloseHandle(file);
+      return nullptr;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file,nullptr,PAGE_READONLY,0,0,nullptr);
+    CloseHandle(file);
+    if (mapping == nullptr)
+      return nullptr;
+
+    /* views have to start at a multiple of the allocation granularity, 
+     * padding behind the file region gets mapped as far as available */
+    SYSTEM_INFO info; GetSystemInfo(&info);
+    const size_t alignedOffset = offset - offset % info.dwAllocationGranularity;
+    mappedBytes = offset-alignedOffset+bytes+16;
+    if (alignedOffset+mappedBytes > size_t(fileSize.QuadPart))
+      mappedBytes = size_t(fileSize.QuadPart)-alignedOffset;
+    base = MapViewOfFile(mapping,FILE_MAP_READ,DWORD(uint64_t(alignedOffset) >> 32),DWORD(alignedOffset),mappedBytes);
+    CloseHandle(mapping);
+    if (base == nullptr)
+      return nullptr;
+
+    return (char*)base + (offset-alignedOffset);
+  }
+
+  void os_unmap_file(void* base, size_t mappedBytes)
+  {
+    if (!UnmapViewOfFile(base))
+      throw std::bad_alloc();
+  }
+
+  void os_advise_access(void* ptr, size_t bytes, OSAccessPattern pattern)
+  {
+  }
 }
 
 #endif
@@ -186,6 +228,9 @@ namespace embree
 #if defined(__UNIX__)
 
 #include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
 #include <errno.h>
 #include <stdlib.h>
 #include <string.h>
@@ -314,6 +359,57 @@ namespace embree
     madvise(pptr,bytes,MADV_HUGEPAGE); 
 #endif
   }
+
+  void* os_map_file(const char* fileName, size_t offset, size_t bytes, void*& base, size_t& mappedBytes)
+  {
+    int fd = open(fileName,O_RDONLY);
+    if (fd == -1)
+      return nullptr;
+
+    struct stat st;
+    if (fstat(fd,&st) == -1 || size_t(st.st_size) < offset+bytes) {
+      close(fd);
+      return nullptr;
+    }
+
+    /* reserve one additional page behind the file region, such that
+     * 16 byte loads of the last element never read past the mapping */
+    const size_t pageSize = sysconf(_SC_PAGESIZE);
+    const size_t alignedOffset = offset & ~(pageSize-1);
+    const size_t fileBytes = (offset-alignedOffset+bytes+pageSize-1) & ~(pageSize-1);
+    mappedBytes = fileBytes+pageSize;
+    base = mmap(0, mappedBytes, PROT_READ, MAP_PRIVATE | MAP_ANON, -1, 0);
+    if (base == MAP_FAILED) {
+      close(fd);
+      return nullptr;
+    }
+
+    void* ptr = mmap(base, fileBytes, PROT_READ, MAP_SHARED | MAP_FIXED, fd, alignedOffset);
+    close(fd);
+    if (ptr == MAP_FAILED) {
+      munmap(base,mappedBytes);
+      return nullptr;
+    }
+    return (char*)base + (offset-alignedOffset);
+  }
+
+  void os_unmap_file(void* base, size_t mappedBytes)
+  {
+    if (munmap(base,mappedBytes) == -1)
+      throw std::bad_alloc();
+  }
+
+  void os_advise_access(void* ptr, size_t bytes, OSAccessPattern pattern)
+  {
+    const size_t pageSize = sysconf(_SC_PAGESIZE);
+    char* begin = (char*)(size_t(ptr) & ~(pageSize-1));
+    bytes += (char*)ptr-begin;
+    switch (pattern) {
+    case OS_ACCESS_NORMAL    : madvise(begin,bytes,MADV_NORMAL); break;
+    case OS_ACCESS_SEQUENTIAL: madvise(begin,bytes,MADV_SEQUENTIAL); break;
+    case OS_ACCESS_RANDOM    : madvise(begin,bytes,MADV_RANDOM); break;
+    }
+  }
 }
 
 #endif
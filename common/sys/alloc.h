@@ -74,6 +74,14 @@ namespace embree
   void  os_free   (void* ptr, size_t bytes, bool hugepages);
   void  os_advise (void* ptr, size_t bytes);
 
+  /*! expected access pattern of file mappings */
+  enum OSAccessPattern { OS_ACCESS_NORMAL, OS_ACCESS_SEQUENTIAL, OS_ACCESS_RANDOM };
+
+  /*! maps a region of a file read-only, returns nullptr on failure */
+  void* os_map_file   (const char* fileName, size_t offset, size_t bytes, void*& base, size_t& mappedBytes);
+  void  os_unmap_file (void* base, size_t mappedBytes);
+  void  os_advise_access (void* ptr, size_t bytes, OSAccessPattern pattern);
+
   /*! allocator that performs OS allocations */
   template<typename T>
     struct os_allocator
@@ -428,6 +428,20 @@ namespace embree
     GetProcessMemoryInfo( GetCurrentProcess( ), &info, sizeof(info) );
     return (size_t)info.WorkingSetSize;
   }
+
+  unsigned int getNumberOfNumaNodes()
+  {
+    ULONG highestNode = 0;
+    if (!GetNumaHighestNodeNumber(&highestNode)) return 1;
+    return highestNode+1;
+  }
+
+  unsigned int getNumaNodeOfCurrentThread()
+  {
+    UCHAR node = 0;
+    if (!GetNumaProcessorNode((UCHAR)GetCurrentProcessorNumber(),&node) || node == 0xFF) return 0;
+    return node;
+  }
 }
 #endif
 
@@ -439,6 +453,7 @@ namespace embree
 
 #include <stdio.h>
 #include <unistd.h>
+#include <sched.h>
 
 namespace embree
 {
@@ -467,6 +482,50 @@ namespace embree
     buffer >> virt >> resident >> shared;
     return resident*sysconf(_SC_PAGE_SIZE);
   }
+
+  /* maps each logical CPU to its NUMA node as reported by /sys/devices/system/node */
+  static const std::vector<unsigned int>& getNumaNodeOfCPU()
+  {
+    static const std::vector<unsigned int> cpuToNode = [] ()
+    {
+      std::vector<unsigned int> nodes;
+      for (unsigned int node=0;;node++)
+      {
+        std::ifstream fs("/sys/devices/system/node/node" + toString(node) + "/cpulist");
+        if (fs.fail()) break;
+
+        /* parse list of CPU ranges, e.g. 0-3,8-11 */
+        size_t begin, end;
+        while (fs >> begin)
+        {
+          end = begin;
+          if (fs.peek() == '-') { fs.ignore(); fs >> end; }
+          if (nodes.size() <= end) nodes.resize(end+1,0);
+          for (size_t cpu=begin; cpu<=end; cpu++) nodes[cpu] = node;
+          if (fs.peek() == ',') fs.ignore();
+        }
+      }
+      return nodes;
+    }();
+    return cpuToNode;
+  }
+
+  unsigned int getNumberOfNumaNodes()
+  {
+    const std::vector<unsigned int>& nodes = getNumaNodeOfCPU();
+    unsigned int numNodes = 1;
+    for (size_t i=0; i<nodes.size(); i++)
+      numNodes = max(numNodes,nodes[i]+1);
+    return numNodes;
+  }
+
+  unsigned int getNumaNodeOfCurrentThread()
+  {
+    const int cpu = sched_getcpu();
+    const std::vector<unsigned int>& nodes = getNumaNodeOfCPU();
+    if (cpu < 0 || size_t(cpu) >= nodes.size()) return 0;
+    return nodes[cpu];
+  }
 }
 
 #endif
@@ -499,6 +558,14 @@ namespace embree
   size_t getResidentMemoryBytes() {
     return 0;
   }
+
+  unsigned int getNumberOfNumaNodes() {
+    return 1;
+  }
+
+  unsigned int getNumaNodeOfCurrentThread() {
+    return 0;
+  }
 }
 
 #endif
@@ -529,6 +596,14 @@ namespace embree
   size_t getResidentMemoryBytes() {
     return 0;
   }
+
+  unsigned int getNumberOfNumaNodes() {
+    return 1;
+  }
+
+  unsigned int getNumaNodeOfCurrentThread() {
+    return 0;
+  }
 }
 
 #endif
@@ -18,6 +18,7 @@
 #include "../math/math.h"
 #include "../sys/sysinfo.h"
 #include <algorithm>
+#include <iomanip>
 
 namespace embree
 {
@@ -29,6 +30,9 @@ namespace embree
   std::vector<Ref<TaskScheduler>> g_instance_vector;
   __thread TaskScheduler::Thread* TaskScheduler::thread_local_thread = nullptr;
   TaskScheduler::ThreadPool* TaskScheduler::threadPool = nullptr;
+  TaskScheduler::SpawnTasksFunction TaskScheduler::spawnTasksFunction = nullptr;
+  static __thread size_t g_poolThreadIndex = 0;
+  void* TaskScheduler::spawnTasksUserPtr = nullptr;
 
   template<typename Predicate, typename Body>
   __forceinline void TaskScheduler::steal_loop(Thread& thread, const Predicate& pred, const Body& body)
@@ -150,8 +154,9 @@ namespace embree
     pool->thread_loop(threadIndex);
   }
 
-  TaskScheduler::ThreadPool::ThreadPool(bool set_affinity)
-    : numThreads(0), numThreadsRunning(0), set_affinity(set_affinity), running(false) {}
+  TaskScheduler::ThreadPool::ThreadPool(bool set_affinity, bool numa_aware, double idle_spin_time)
+    : numThreads(0), numThreadsRunning(0), set_affinity(set_affinity), numa_aware(numa_aware), idle_spin_time(idle_spin_time), running(false),
+      statistics(getNumberOfLogicalThreads()) {}
 
   dll_export void TaskScheduler::ThreadPool::startThreads()
   {
@@ -223,8 +228,46 @@ namespace embree
     }
   }
 
+  void TaskScheduler::ThreadPool::addStatistics(const Thread& thread)
+  {
+    Lock<MutexSys> lock(statisticsMutex);
+    ThreadStatistics& stats = statistics[g_poolThreadIndex < statistics.size() ? g_poolThreadIndex : 0];
+    stats.workTime += thread.workTime;
+    stats.spinTime += thread.spinTime;
+    stats.parkTime += thread.parkTime;
+  }
+
+  TaskScheduler::ThreadStatistics TaskScheduler::ThreadPool::getStatistics()
+  {
+    Lock<MutexSys> lock(statisticsMutex);
+    ThreadStatistics total;
+    for (size_t i=0; i<statistics.size(); i++) {
+      total.workTime += statistics[i].workTime;
+      total.spinTime += statistics[i].spinTime;
+      total.parkTime += statistics[i].parkTime;
+    }
+    return total;
+  }
+
+  void TaskScheduler::ThreadPool::printStatistics()
+  {
+    Lock<MutexSys> lock(statisticsMutex);
+    std::cout << "worker thread statistics:" << std::endl;
+    for (size_t i=0; i<statistics.size(); i++)
+    {
+      const ThreadStatistics& stats = statistics[i];
+      if (stats.workTime == 0.0 && stats.spinTime == 0.0 && stats.parkTime == 0.0) continue;
+      if (i == 0) std::cout << "  application threads: ";
+      else        std::cout << "  thread " << std::setw(3) << i << "         : ";
+      std::cout << "work = " << std::setw(8) << 1000.0*stats.workTime << " ms, "
+                << "spin = " << std::setw(8) << 1000.0*stats.spinTime << " ms, "
+                << "parked = " << std::setw(8) << 1000.0*stats.parkTime << " ms" << std::endl;
+    }
+  }
+
   void TaskScheduler::ThreadPool::thread_loop(size_t globalThreadIndex)
   {
+    g_poolThreadIndex = globalThreadIndex;
     while (globalThreadIndex < numThreadsRunning)
     {
       Ref<TaskScheduler> scheduler = NULL;
@@ -241,7 +284,7 @@ namespace embree
   }
 
   TaskScheduler::TaskScheduler()
-    : threadCounter(0), anyTasksRunning(0), hasRootTask(false)
+    : threadCounter(0), anyTasksRunning(0), hasRootTask(false), maxExternalThreads(0), numParkedThreads(0), wakeEpoch(0)
   {
     threadLocal.resize(2*getNumberOfLogicalThreads()); // FIXME: this has to be 2x as in the compatibility join mode with rtcCommitScene the worker threads also join. When disallowing rtcCommitScene to join a build we can remove the 2x.
     for (size_t i=0; i<threadLocal.size(); i++)
@@ -281,9 +324,9 @@ namespace embree
     return g_instance;
   }
 
-  void TaskScheduler::create(size_t numThreads, bool set_affinity, bool start_threads)
+  void TaskScheduler::create(size_t numThreads, bool set_affinity, bool start_threads, bool numa_aware, double idle_spin_time)
   {
-    if (!threadPool) threadPool = new TaskScheduler::ThreadPool(set_affinity);
+    if (!threadPool) threadPool = new TaskScheduler::ThreadPool(set_affinity,numa_aware,idle_spin_time);
     threadPool->setNumThreads(numThreads,start_threads);
   }
 
@@ -291,6 +334,13 @@ namespace embree
     delete threadPool; threadPool = nullptr;
   }
 
+  void TaskScheduler::setSpawnTasksFunction(SpawnTasksFunction spawnTasks, void* userPtr)
+  {
+    Lock<MutexSys> lock(g_mutex);
+    spawnTasksFunction = spawnTasks;
+    spawnTasksUserPtr = userPtr;
+  }
+
   dll_export ssize_t TaskScheduler::allocThreadIndex()
   {
     size_t threadIndex = threadCounter++;
@@ -346,18 +396,10 @@ namespace embree
     Thread* oldThread = swapThread(&thread);
 
     /* main thread loop */
-    while (anyTasksRunning)
-    {
-      steal_loop(thread,
-                 [&] () { return anyTasksRunning > 0; },
-                 [&] () {
-                   anyTasksRunning++;
-                   while (thread.tasks.execute_local_internal(thread,nullptr));
-                   anyTasksRunning--;
-                 });
-    }
+    worker_loop(thread);
     threadLocal[threadIndex].store(nullptr);
     swapThread(oldThread);
+    if (threadPool) threadPool->addStatistics(thread);
 
     /* remember exception to throw */
     std::exception_ptr except = nullptr;
@@ -383,11 +425,110 @@ namespace embree
     return except;
   }
 
+  void TaskScheduler::worker_loop(Thread& thread)
+  {
+    const double idleSpinTime = threadPool ? threadPool->idleSpinTime() : -1.0;
+    double idleBegin = getSeconds();
+    size_t numFailedSteals = 0;
+
+    while (anyTasksRunning)
+    {
+      bool stolen = steal_from_other_threads(thread);
+
+      if (!stolen)
+      {
+        /*! some spinning rounds before yielding */
+        numFailedSteals += thread.threadCount();
+        if (numFailedSteals < 1024) continue;
+        numFailedSteals = 0;
+        yield();
+
+        /*! park the thread when it did not find any work for too long */
+        if (idleSpinTime < 0.0) continue;
+        const double parkBegin = getSeconds();
+        if (parkBegin-idleBegin < idleSpinTime) continue;
+        thread.spinTime += parkBegin-idleBegin;
+        stolen = park(thread);
+        idleBegin = getSeconds();
+        thread.parkTime += idleBegin-parkBegin;
+        if (!stolen) continue;
+      }
+
+      /* execute stolen task and all its local subtasks */
+      const double workBegin = getSeconds();
+      thread.spinTime += workBegin-idleBegin;
+      anyTasksRunning++;
+      while (thread.tasks.execute_local_internal(thread,nullptr));
+      if (--anyTasksRunning == 0 && numParkedThreads) wakeParkedThreads();
+      idleBegin = getSeconds();
+      thread.workTime += idleBegin-workBegin;
+      numFailedSteals = 0;
+    }
+    thread.spinTime += getSeconds()-idleBegin;
+  }
+
+  bool TaskScheduler::park(Thread& thread)
+  {
+    /* announce parking before the last steal attempt, such that
+       spawning threads either see us parked or we see their task */
+    numParkedThreads++;
+    const size_t epoch = wakeEpoch;
+    if (steal_from_other_threads(thread)) {
+      numParkedThreads--;
+      return true;
+    }
+
+    {
+      Lock<MutexSys> lock(mutex);
+      condition.wait(mutex, [&] () { return wakeEpoch != epoch || anyTasksRunning == 0; });
+    }
+    numParkedThreads--;
+    return false;
+  }
+
+  dll_export void TaskScheduler::wakeParkedThreads()
+  {
+    Lock<MutexSys> lock(mutex);
+    wakeEpoch++;
+    condition.notify_all();
+  }
+
+  TaskScheduler::ThreadStatistics TaskScheduler::getThreadStatistics()
+  {
+    Lock<MutexSys> lock(g_mutex);
+    if (!threadPool) return ThreadStatistics();
+    return threadPool->getStatistics();
+  }
+
+  void TaskScheduler::printThreadStatistics()
+  {
+    Lock<MutexSys> lock(g_mutex);
+    if (threadPool) threadPool->printStatistics();
+  }
+
   bool TaskScheduler::steal_from_other_threads(Thread& thread)
   {
     const size_t threadIndex = thread.threadIndex;
     const size_t threadCount = this->threadCounter;
 
+    /* in NUMA aware mode we first try to steal from threads of the same NUMA node */
+    if (threadPool && threadPool->numaAware())
+    {
+      for (size_t i=1; i<threadCount; i++)
+      {
+        size_t otherThreadIndex = threadIndex+i;
+        if (otherThreadIndex >= threadCount) otherThreadIndex -= threadCount;
+
+        Thread* othread = threadLocal[otherThreadIndex].load();
+        if (!othread || othread->numaNode != thread.numaNode)
+          continue;
+
+        pause_cpu(32);
+        if (othread->tasks.steal(thread))
+          return true;
+      }
+    }
+
     for (size_t i=1; i<threadCount; i++)
     {
       pause_cpu(32);
@@ -405,12 +546,51 @@ namespace embree
     return false;
   }
 
-  dll_export void TaskScheduler::startThreads() {
+  dll_export void TaskScheduler::startThreads()
+  {
+    /* threads of the external job system are used instead of the thread pool */
+    if (spawnTasksFunction) return;
     threadPool->startThreads();
   }
 
-  dll_export void TaskScheduler::addScheduler(const Ref<TaskScheduler>& scheduler) {
-    threadPool->add(scheduler);
+  dll_export void TaskScheduler::addScheduler(const Ref<TaskScheduler>& scheduler)
+  {
+    SpawnTasksFunction spawnTasks = nullptr;
+    void* userPtr = nullptr;
+    {
+      Lock<MutexSys> lock(g_mutex);
+      spawnTasks = spawnTasksFunction;
+      userPtr = spawnTasksUserPtr;
+    }
+    if (!spawnTasks) {
+      threadPool->add(scheduler);
+      return;
+    }
+
+    /* each external task keeps the scheduler alive as it may start after the root task finished */
+    const size_t numTasks = threadPool->size()-1;
+    if (numTasks == 0) return;
+    scheduler.ptr->maxExternalThreads = threadPool->size();
+    for (size_t i=0; i<numTasks; i++) scheduler.ptr->refInc();
+    spawnTasks(userPtr,executeExternalTask,scheduler.ptr,(unsigned int)numTasks);
+  }
+
+  void TaskScheduler::executeExternalTask(void* taskPtr)
+  {
+    TaskScheduler* scheduler = (TaskScheduler*) taskPtr;
+
+    /* only join if the work is not already done, tasks that start
+       late may otherwise oversubscribe a later root task */
+    ssize_t threadIndex = -1;
+    {
+      Lock<MutexSys> lock(scheduler->mutex);
+      if (scheduler->anyTasksRunning && scheduler->threadCounter < scheduler->maxExternalThreads)
+        threadIndex = scheduler->allocThreadIndex();
+    }
+
+    /* exceptions get re-thrown by the thread that spawned the root task */
+    if (threadIndex >= 0) scheduler->thread_loop(threadIndex);
+    scheduler->refDec();
   }
 
   dll_export void TaskScheduler::removeScheduler(const Ref<TaskScheduler>& scheduler) {
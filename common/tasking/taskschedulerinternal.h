@@ -182,22 +182,39 @@ namespace embree
       ALIGNED_STRUCT_(64);
 
       Thread (size_t threadIndex, const Ref<TaskScheduler>& scheduler)
-      : threadIndex(threadIndex), task(nullptr), scheduler(scheduler) {}
+      : threadIndex(threadIndex), numaNode(getNumaNodeOfCurrentThread()), task(nullptr), scheduler(scheduler),
+        workTime(0.0), spinTime(0.0), parkTime(0.0) {}
 
       __forceinline size_t threadCount() {
         return scheduler->threadCounter;
       }
 
       size_t threadIndex;              //!< ID of this thread
+      size_t numaNode;                 //!< NUMA node this thread got started on
       TaskQueue tasks;                 //!< local task queue
       Task* task;                      //!< current active task
       Ref<TaskScheduler> scheduler;     //!< pointer to task scheduler
+
+      double workTime;                 //!< seconds spent executing stolen tasks
+      double spinTime;                 //!< seconds spent spinning for tasks to steal
+      double parkTime;                 //!< seconds spent parked waiting for new tasks
+    };
+
+    /*! time statistics of one worker thread */
+    struct ThreadStatistics
+    {
+      ThreadStatistics () 
+        : workTime(0.0), spinTime(0.0), parkTime(0.0) {}
+
+      double workTime;                 //!< seconds spent executing stolen tasks
+      double spinTime;                 //!< seconds spent spinning for tasks to steal
+      double parkTime;                 //!< seconds spent parked waiting for new tasks
     };
 
     /*! pool of worker threads */
     struct ThreadPool
     {
-      ThreadPool (bool set_affinity);
+      ThreadPool (bool set_affinity, bool numa_aware, double idle_spin_time);
       ~ThreadPool ();
 
       /*! starts the threads */
@@ -215,6 +232,21 @@ namespace embree
       /*! returns number of threads of the thread pool */
       size_t size() const { return numThreads; }
 
+      /*! returns true if threads should first steal from threads of the same NUMA node */
+      bool numaAware() const { return numa_aware; }
+
+      /*! returns the seconds idle threads spin before they get parked, negative values disable parking */
+      double idleSpinTime() const { return idle_spin_time; }
+
+      /*! adds the time statistics of a thread that leaves a scheduler */
+      void addStatistics(const Thread& thread);
+
+      /*! returns the time statistics accumulated over all threads */
+      ThreadStatistics getStatistics();
+
+      /*! prints the time statistics of each thread */
+      void printStatistics();
+
       /*! main loop for all threads */
       void thread_loop(size_t threadIndex);
 
@@ -222,6 +254,8 @@ namespace embree
       std::atomic<size_t> numThreads;
       std::atomic<size_t> numThreadsRunning;
       bool set_affinity;
+      bool numa_aware;
+      double idle_spin_time;
       std::atomic<bool> running;
       std::vector<thread_t> threads;
 
@@ -229,17 +263,27 @@ namespace embree
       MutexSys mutex;
       ConditionSys condition;
       std::list<Ref<TaskScheduler> > schedulers;
+
+    private:
+      MutexSys statisticsMutex;
+      std::vector<ThreadStatistics> statistics; //!< slot 0 for application threads, slot i for pool thread i
     };
 
+    /*! callback that asynchronously runs numTasks invocations of task(taskPtr) on threads of an external job system */
+    typedef void (*SpawnTasksFunction)(void* userPtr, void (*task)(void* taskPtr), void* taskPtr, unsigned int numTasks);
+
     TaskScheduler ();
     ~TaskScheduler ();
 
     /*! initializes the task scheduler */
-    static void create(size_t numThreads, bool set_affinity, bool start_threads);
+    static void create(size_t numThreads, bool set_affinity, bool start_threads, bool numa_aware, double idle_spin_time);
 
     /*! destroys the task scheduler again */
     static void destroy();
 
+    /*! lets threads of an external job system instead of the thread pool participate in parallel work */
+    static void setSpawnTasksFunction(SpawnTasksFunction spawnTasks, void* userPtr);
+
     /*! lets new worker threads join the tasking system */
     void join();
     void reset();
@@ -253,6 +297,21 @@ namespace embree
     /*! thread loop for all worker threads */
     std::exception_ptr thread_loop(size_t threadIndex);
 
+    /*! steals and executes tasks until all tasks are finished, parks the thread when idle for too long */
+    void worker_loop(Thread& thread);
+
+    /*! parks the thread until new tasks got spawned or all tasks finished, returns true if a task got stolen instead */
+    bool park(Thread& thread);
+
+    /*! wakes up all threads parked in the worker loop */
+    dll_export void wakeParkedThreads();
+
+    /*! returns the time statistics accumulated over all worker threads */
+    static ThreadStatistics getThreadStatistics();
+
+    /*! prints the time statistics of each worker thread */
+    static void printThreadStatistics();
+
     /*! steals a task from a different thread */
     bool steal_from_other_threads(Thread& thread);
 
@@ -282,7 +341,7 @@ namespace embree
       if (useThreadPool) addScheduler(this);
 
       while (thread.tasks.execute_local(thread,nullptr));
-      anyTasksRunning--;
+      if (--anyTasksRunning == 0 && numParkedThreads) wakeParkedThreads();
       if (useThreadPool) removeScheduler(this);
 
       threadLocal[threadIndex] = nullptr;
@@ -307,8 +366,12 @@ namespace embree
     static __forceinline void spawn(size_t size, const Closure& closure)
     {
       Thread* thread = TaskScheduler::thread();
-      if (likely(thread != nullptr)) thread->tasks.push_right(*thread,size,closure);
-      else                           instance()->spawn_root(closure,size);
+      if (likely(thread != nullptr)) {
+        thread->tasks.push_right(*thread,size,closure);
+        if (unlikely(thread->scheduler->numParkedThreads != 0)) thread->scheduler->wakeParkedThreads();
+      }
+      else
+        instance()->spawn_root(closure,size);
     }
 
     /* spawn a new task at the top of the threads task stack */
@@ -365,11 +428,17 @@ namespace embree
     /*! remove the task scheduler object again */
     dll_export static void removeScheduler(const Ref<TaskScheduler>& scheduler);
 
+    /*! lets a thread of an external job system join the scheduler */
+    static void executeExternalTask(void* taskPtr);
+
   private:
     std::vector<atomic<Thread*>> threadLocal;
     std::atomic<size_t> threadCounter;
     std::atomic<size_t> anyTasksRunning;
     std::atomic<bool> hasRootTask;
+    std::atomic<size_t> maxExternalThreads;
+    std::atomic<size_t> numParkedThreads;
+    std::atomic<size_t> wakeEpoch;
     std::exception_ptr cancellingException;
     MutexSys mutex;
     ConditionSys condition;
@@ -379,6 +448,8 @@ namespace embree
     static __thread TaskScheduler* g_instance;
     static __thread Thread* thread_local_thread;
     static ThreadPool* threadPool;
+    static SpawnTasksFunction spawnTasksFunction;
+    static void* spawnTasksUserPtr;
   };
 
   RTC_NAMESPACE_END
@@ -42,7 +42,7 @@ namespace embree
   struct TaskScheduler
   {
     /*! initializes the task scheduler */
-    static void create(size_t numThreads, bool set_affinity, bool start_threads);
+    static void create(size_t numThreads, bool set_affinity, bool start_threads, bool numa_aware, double idle_spin_time);
 
     /*! destroys the task scheduler again */
     static void destroy();
@@ -52,6 +52,9 @@ RTC_API RTCBuffer rtcNewBuffer(RTCDevice device, size_t byteSize);
 /* Creates a new shared buffer. */
 RTC_API RTCBuffer rtcNewSharedBuffer(RTCDevice device, void* ptr, size_t byteSize);
 
+/* Creates a new buffer that maps a file region read-only. */
+RTC_API RTCBuffer rtcNewMappedBuffer(RTCDevice device, const char* fileName, size_t byteOffset, size_t byteSize);
+
 /* Returns a pointer to the buffer data. */
 RTC_API void* rtcGetBufferData(RTCBuffer buffer);
 
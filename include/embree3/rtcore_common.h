@@ -183,12 +183,27 @@ struct RTC_ALIGN(16) RTCLinearBounds
   struct RTCBounds bounds1;
 };
 
+/* Decomposed affine transformation with the rotation stored as a quaternion */
+struct RTC_ALIGN(16) RTCQuaternionDecomposition
+{
+  float scale_x, scale_y, scale_z;
+  float skew_xy, skew_xz, skew_yz;
+  float shift_x, shift_y, shift_z;
+  float quaternion_r, quaternion_i, quaternion_j, quaternion_k;
+  float translation_x, translation_y, translation_z;
+};
+
 /* Intersection context flags */
 enum RTCIntersectContextFlags
 {
   RTC_INTERSECT_CONTEXT_FLAG_NONE       = 0,
   RTC_INTERSECT_CONTEXT_FLAG_INCOHERENT = (0 << 0), // optimize for incoherent rays
-  RTC_INTERSECT_CONTEXT_FLAG_COHERENT   = (1 << 0)  // optimize for coherent rays
+  RTC_INTERSECT_CONTEXT_FLAG_COHERENT   = (1 << 0), // optimize for coherent rays
+
+  RTC_INTERSECT_CONTEXT_FLAG_CULL_BACKFACES  = (1 << 1), // ignore back facing surface hits
+  RTC_INTERSECT_CONTEXT_FLAG_CULL_FRONTFACES = (1 << 2), // ignore front facing surface hits
+  RTC_INTERSECT_CONTEXT_FLAG_OPAQUE          = (1 << 3), // treat all geometries as opaque and skip filter functions
+  RTC_INTERSECT_CONTEXT_FLAG_TERMINATE_ON_FIRST_HIT = (1 << 4) // rtcIntersect may stop at the first hit found
 };
 
 /* Arguments for RTCFilterFunctionN */
@@ -211,6 +226,10 @@ struct RTCIntersectContext
   enum RTCIntersectContextFlags flags;               // intersection flags
   RTCFilterFunctionN filter;                         // filter function to execute
   unsigned int instID[RTC_MAX_INSTANCE_LEVEL_COUNT]; // will be set to geomID of instance when instance is entered
+  float lodScale;                                    // scales the distance used to select the level of detail of instances
+  unsigned int ignoreGeomID;                         // geometry ID of the primitive to ignore, e.g. the primitive the ray starts on
+  unsigned int ignorePrimID;                         // primitive ID of the primitive to ignore
+  unsigned int ignoreInstID;                         // instance ID of the primitive to ignore
 };
 
 /* Initializes an intersection context. */
@@ -219,6 +238,10 @@ RTC_FORCEINLINE void rtcInitIntersectContext(struct RTCIntersectContext* context
   context->flags = RTC_INTERSECT_CONTEXT_FLAG_INCOHERENT;
   context->filter = NULL;
   context->instID[0] = RTC_INVALID_GEOMETRY_ID;
+  context->lodScale = 1.0f;
+  context->ignoreGeomID = RTC_INVALID_GEOMETRY_ID;
+  context->ignorePrimID = RTC_INVALID_GEOMETRY_ID;
+  context->ignoreInstID = RTC_INVALID_GEOMETRY_ID;
 }
   
 RTC_NAMESPACE_END
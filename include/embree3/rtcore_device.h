@@ -57,8 +57,16 @@ enum RTCDeviceProperty
   RTC_DEVICE_PROPERTY_USER_GEOMETRY_SUPPORTED        = 100,
   RTC_DEVICE_PROPERTY_POINT_GEOMETRY_SUPPORTED       = 101,
 
-  RTC_DEVICE_PROPERTY_TASKING_SYSTEM        = 128,
-  RTC_DEVICE_PROPERTY_JOIN_COMMIT_SUPPORTED = 129
+  RTC_DEVICE_PROPERTY_TASKING_SYSTEM                 = 128,
+  RTC_DEVICE_PROPERTY_JOIN_COMMIT_SUPPORTED          = 129,
+  RTC_DEVICE_PROPERTY_SPAWN_TASKS_FUNCTION_SUPPORTED = 130,
+  RTC_DEVICE_PROPERTY_TASKING_WORK_TIME              = 131,
+  RTC_DEVICE_PROPERTY_TASKING_SPIN_TIME              = 132,
+  RTC_DEVICE_PROPERTY_TASKING_PARK_TIME              = 133,
+
+  RTC_DEVICE_PROPERTY_TESSELLATION_CACHE_HITS      = 160,
+  RTC_DEVICE_PROPERTY_TESSELLATION_CACHE_MISSES    = 161,
+  RTC_DEVICE_PROPERTY_TESSELLATION_CACHE_EVICTIONS = 162
 };
 
 /* Gets a device property. */
@@ -94,4 +102,31 @@ typedef bool (*RTCMemoryMonitorFunction)(void* ptr, ssize_t bytes, bool post);
 /* Sets the memory monitor callback function. */
 RTC_API void rtcSetDeviceMemoryMonitorFunction(RTCDevice device, RTCMemoryMonitorFunction memoryMonitor, void* userPtr);
 
+/* Task function that lets a thread of the application participate in parallel work of Embree */
+typedef void (*RTCTaskFunction)(void* taskPtr);
+
+/* Spawn tasks callback function */
+typedef void (*RTCSpawnTasksFunction)(void* userPtr, RTCTaskFunction task, void* taskPtr, unsigned int numTasks);
+
+/* Sets the callback function used to run worker tasks on threads of the application. */
+RTC_API void rtcSetDeviceSpawnTasksFunction(RTCDevice device, RTCSpawnTasksFunction spawnTasks, void* userPtr);
+
+/* Memory allocation categories */
+enum RTCAllocationCategory
+{
+  RTC_ALLOCATION_CATEGORY_BVH                = 0,
+  RTC_ALLOCATION_CATEGORY_PRIMREFS           = 1,
+  RTC_ALLOCATION_CATEGORY_BUFFER             = 2,
+  RTC_ALLOCATION_CATEGORY_TESSELLATION_CACHE = 3
+};
+
+/* Allocation callback function */
+typedef void* (*RTCAllocFunction)(void* userPtr, size_t bytes, size_t alignment, enum RTCAllocationCategory category);
+
+/* Free callback function */
+typedef void (*RTCFreeFunction)(void* userPtr, void* ptr, size_t bytes, enum RTCAllocationCategory category);
+
+/* Sets the callback functions used to allocate and free memory of the device. */
+RTC_API void rtcSetDeviceAllocator(RTCDevice device, RTCAllocFunction alloc, RTCFreeFunction free, void* userPtr);
+
 RTC_NAMESPACE_END
@@ -95,6 +95,8 @@ struct RTCIntersectFunctionNArguments
   struct RTCIntersectContext* context;
   struct RTCRayHitN* rayhit;
   unsigned int N;
+  const unsigned int* primIDs;
+  unsigned int primCount;
 };
 
 /* Intersection callback function */
@@ -109,6 +111,8 @@ struct RTCOccludedFunctionNArguments
   struct RTCIntersectContext* context;
   struct RTCRayN* ray;
   unsigned int N;
+  const unsigned int* primIDs;
+  unsigned int primCount;
 };
 
 /* Occlusion callback function */
@@ -186,6 +190,9 @@ RTC_API void* rtcGetGeometryBufferData(RTCGeometry geometry, enum RTCBufferType
 /* Updates a geometry buffer. */
 RTC_API void rtcUpdateGeometryBuffer(RTCGeometry geometry, enum RTCBufferType type, unsigned int slot);
 
+/* Updates a range of items of a geometry buffer. */
+RTC_API void rtcUpdateGeometryBufferRange(RTCGeometry geometry, enum RTCBufferType type, unsigned int slot, unsigned int first, unsigned int count);
+
 
 /* Sets the intersection filter callback function of the geometry. */
 RTC_API void rtcSetGeometryIntersectFilterFunction(RTCGeometry geometry, RTCFilterFunctionN filter);
@@ -203,6 +210,9 @@ RTC_API void* rtcGetGeometryUserData(RTCGeometry geometry);
 /* Sets the number of primitives of a user geometry. */
 RTC_API void rtcSetGeometryUserPrimitiveCount(RTCGeometry geometry, unsigned int userPrimitiveCount);
 
+/* Sets the maximal number of primitives passed to a single invocation of the intersect and occluded callbacks of a user geometry. */
+RTC_API void rtcSetGeometryUserPrimitiveBatchSize(RTCGeometry geometry, unsigned int batchSize);
+
 /* Sets the bounding callback function to calculate bounding boxes for user primitives. */
 RTC_API void rtcSetGeometryBoundsFunction(RTCGeometry geometry, RTCBoundsFunction bounds, void* userPtr);
 
@@ -222,9 +232,15 @@ RTC_API void rtcFilterOcclusion(const struct RTCOccludedFunctionNArguments* args
 /* Sets the instanced scene of an instance geometry. */
 RTC_API void rtcSetGeometryInstancedScene(RTCGeometry geometry, RTCScene scene);
 
+/* Sets a coarser level of detail of an instance geometry, used for rays starting at least the specified distance away from the instance. */
+RTC_API void rtcSetGeometryInstancedSceneLevel(RTCGeometry geometry, unsigned int level, RTCScene scene, float distance);
+
 /* Sets the transformation of an instance for the specified time step. */
 RTC_API void rtcSetGeometryTransform(RTCGeometry geometry, unsigned int timeStep, enum RTCFormat format, const void* xfm);
 
+/* Sets the transformation of an instance for the specified time step as a quaternion decomposition. */
+RTC_API void rtcSetGeometryTransformQuaternion(RTCGeometry geometry, unsigned int timeStep, const struct RTCQuaternionDecomposition* qd);
+
 /* Returns the interpolated transformation of an instance for the specified time. */
 RTC_API void rtcGetGeometryTransform(RTCGeometry geometry, float time, enum RTCFormat format, void* xfm);
 
@@ -232,6 +248,19 @@ RTC_API void rtcGetGeometryTransform(RTCGeometry geometry, float time, enum RTCF
 /* Sets the uniform tessellation rate of the geometry. */
 RTC_API void rtcSetGeometryTessellationRate(RTCGeometry geometry, float tessellationRate);
 
+/* Camera used to calculate view-dependent tessellation levels */
+struct RTCTessellationCamera
+{
+  float pos_x, pos_y, pos_z; // position of the camera
+  float fov;                 // field of view in radians along the larger image dimension
+  unsigned int width;        // image width in pixels
+  unsigned int height;       // image height in pixels
+  float edgeLength;          // desired length of tessellated edges in pixels
+};
+
+/* Sets the camera to calculate view-dependent tessellation levels of the geometry. */
+RTC_API void rtcSetGeometryTessellationCamera(RTCGeometry geometry, const struct RTCTessellationCamera* camera);
+
 /* Sets the number of topologies of a subdivision surface. */
 RTC_API void rtcSetGeometryTopologyCount(RTCGeometry geometry, unsigned int topologyCount);
 
@@ -34,7 +34,9 @@ enum RTCSceneFlags
   RTC_SCENE_FLAG_DYNAMIC                 = (1 << 0),
   RTC_SCENE_FLAG_COMPACT                 = (1 << 1),
   RTC_SCENE_FLAG_ROBUST                  = (1 << 2),
-  RTC_SCENE_FLAG_CONTEXT_FILTER_FUNCTION = (1 << 3)
+  RTC_SCENE_FLAG_CONTEXT_FILTER_FUNCTION = (1 << 3),
+  RTC_SCENE_FLAG_AUTOTUNE                = (1 << 4),
+  RTC_SCENE_FLAG_REORDER_VERTICES        = (1 << 5)
 };
 
 /* Creates a new scene. */
@@ -66,6 +68,9 @@ RTC_API void rtcCommitScene(RTCScene scene);
 /* Commits the scene from multiple threads. */
 RTC_API void rtcJoinCommitScene(RTCScene scene);
 
+/* Commits multiple scenes, instanced scenes get committed before the scenes instancing them. */
+RTC_API void rtcCommitScenes(RTCScene* scenes, size_t numScenes);
+
 
 /* Progress monitor callback function */
 typedef bool (*RTCProgressMonitorFunction)(void* ptr, double n);
@@ -73,6 +78,12 @@ typedef bool (*RTCProgressMonitorFunction)(void* ptr, double n);
 /* Sets the progress monitor callback function of the scene. */
 RTC_API void rtcSetSceneProgressMonitorFunction(RTCScene scene, RTCProgressMonitorFunction progress, void* ptr);
 
+/* Lazy build callback function */
+typedef void (*RTCLazyBuildFunction)(void* ptr, RTCScene scene);
+
+/* Defers the build of the scene until the first ray enters an instance of it, the callback function can create the geometries of the scene before that build. */
+RTC_API void rtcSetSceneLazyBuildFunction(RTCScene scene, RTCLazyBuildFunction build, void* ptr, const struct RTCBounds* bounds);
+
 /* Sets the build quality of the scene. */
 RTC_API void rtcSetSceneBuildQuality(RTCScene scene, enum RTCBuildQuality quality);
 
@@ -16,6 +16,13 @@
 
 #include "bvh.h"
 #include "bvh_statistics.h"
+#include "../geometry/triangle.h"
+#include "../geometry/trianglev.h"
+#include "../geometry/trianglei.h"
+#include "../geometry/quadv.h"
+#include "../geometry/quadi.h"
+#include "../geometry/object.h"
+#include "../geometry/instance.h"
 
 namespace embree
 {
@@ -122,6 +129,221 @@ namespace embree
     else return node;
   }
 
+  /*! vertex access of the indexed primitive types */
+  template<typename Primitive> struct IndexedPrimitive;
+
+  template<> struct IndexedPrimitive<Triangle4i>
+  {
+    typedef TriangleMesh Mesh;
+    static const size_t numVertices = 3;
+
+    static __forceinline unsigned int& vertex(Triangle4i& prim, size_t k, size_t i) {
+      return k == 0 ? prim.v0[i] : k == 1 ? prim.v1[i] : prim.v2[i];
+    }
+
+    static __forceinline unsigned int meshVertex(const Mesh* mesh, size_t primID, size_t k) {
+      return mesh->triangle(primID).v[k];
+    }
+  };
+
+  template<> struct IndexedPrimitive<Quad4i>
+  {
+    typedef QuadMesh Mesh;
+    static const size_t numVertices = 4;
+
+    static __forceinline unsigned int& vertex(Quad4i& prim, size_t k, size_t i) {
+      return k == 0 ? prim.v0[i] : k == 1 ? prim.v1[i] : k == 2 ? prim.v2[i] : prim.v3[i];
+    }
+
+    static __forceinline unsigned int meshVertex(const Mesh* mesh, size_t primID, size_t k) {
+      return mesh->quad(primID).v[k];
+    }
+  };
+
+  /*! collects the leaves of a BVH built from aligned nodes in depth first order */
+  template<int N>
+  static bool gatherLeaves(typename BVHN<N>::NodeRef node, std::vector<typename BVHN<N>::NodeRef>& leaves)
+  {
+    if (node.isLeaf()) {
+      leaves.push_back(node);
+      return true;
+    }
+    if (!node.isAlignedNode())
+      return false;
+
+    typename BVHN<N>::AlignedNode* n = node.alignedNode();
+    for (size_t c=0; c<N; c++) {
+      if (n->child(c) == BVHN<N>::emptyNode) continue;
+      if (!gatherLeaves<N>(n->child(c),leaves)) return false;
+    }
+    return true;
+  }
+
+  /*! copies the vertices of all meshes in the order of their first
+   *  reference from the leaves and updates the vertex offsets of
+   *  the leaves to index these copies */
+  template<int N, typename Primitive>
+  static void reorderLeafVertices(BVHN<N>* bvh)
+  {
+    typedef IndexedPrimitive<Primitive> IP;
+    typedef typename IP::Mesh Mesh;
+    Scene* scene = bvh->scene;
+
+    std::vector<typename BVHN<N>::NodeRef> leaves;
+    if (!gatherLeaves<N>(bvh->root,leaves))
+      return;
+
+    /* motion blur meshes are always accessed through their own vertex buffers */
+    for (size_t l=0; l<leaves.size(); l++)
+    {
+      size_t num; Primitive* prims = (Primitive*) leaves[l].leaf(num);
+      for (size_t j=0; j<num; j++)
+        if (scene->get<Mesh>(prims[j].geomID(0))->numTimeSteps != 1)
+          return;
+    }
+
+    /* assign new vertex indices in order of first reference */
+    std::vector<std::vector<unsigned int>> newIndex(scene->size());
+    std::vector<unsigned int> numUsed(scene->size(),0);
+    for (size_t l=0; l<leaves.size(); l++)
+    {
+      size_t num; Primitive* prims = (Primitive*) leaves[l].leaf(num);
+      for (size_t j=0; j<num; j++)
+      {
+        Primitive& prim = prims[j];
+        for (size_t i=0; i<Primitive::max_size(); i++)
+        {
+          /* invalid slots just point to the first vertex of the leaf */
+          if (!prim.valid(i)) {
+            for (size_t k=0; k<IP::numVertices; k++)
+              IP::vertex(prim,k,i) = IP::vertex(prim,0,0);
+            continue;
+          }
+
+          const unsigned int geomID = prim.geomID(i);
+          const Mesh* mesh = scene->get<Mesh>(geomID);
+          std::vector<unsigned int>& index = newIndex[geomID];
+          if (index.empty()) index.resize(mesh->numVertices(),unsigned(-1));
+
+          for (size_t k=0; k<IP::numVertices; k++)
+          {
+            const unsigned int v = IP::meshVertex(mesh,prim.primID(i),k);
+            if (index[v] == unsigned(-1)) index[v] = numUsed[geomID]++;
+            IP::vertex(prim,k,i) = index[v]*(sizeof(Vec3fa)/4);
+          }
+        }
+      }
+    }
+
+    /* copy the vertices into the new order */
+    parallel_for(newIndex.size(), [&] (size_t geomID)
+    {
+      const std::vector<unsigned int>& index = newIndex[geomID];
+      if (index.empty()) return;
+      Mesh* mesh = scene->get<Mesh>(geomID);
+      Vec3fa* vertices = mesh->allocLeafOrderVertices(numUsed[geomID]);
+      for (size_t v=0; v<index.size(); v++)
+        if (index[v] != unsigned(-1))
+          vertices[index[v]] = mesh->vertex(v);
+    });
+  }
+
+  template<int N>
+  void BVHN<N>::reorderVertices()
+  {
+    if (primTy == &Triangle4i::type)
+      reorderLeafVertices<N,Triangle4i>(this);
+    else if (primTy == &Quad4i::type)
+      reorderLeafVertices<N,Quad4i>(this);
+  }
+
+#if defined(EMBREE_RAY_MASK)
+
+  /*! geometry mask of the primitives of a leaf */
+  template<typename Primitive>
+  struct LeafMask
+  {
+    static __forceinline unsigned int get(const Scene* scene, const Primitive& prim)
+    {
+      unsigned int mask = 0;
+      for (size_t i=0; i<Primitive::max_size(); i++)
+        if (prim.valid(i)) mask |= scene->get(prim.geomID(i))->mask;
+      return mask;
+    }
+  };
+
+  template<> struct LeafMask<Object>
+  {
+    static __forceinline unsigned int get(const Scene* scene, const Object& prim) {
+      return scene->get(prim.geomID())->mask;
+    }
+  };
+
+  template<> struct LeafMask<InstancePrimitive>
+  {
+    static __forceinline unsigned int get(const Scene* scene, const InstancePrimitive& prim) {
+      return prim.instance->mask;
+    }
+  };
+
+  /*! stores the OR of the geometry masks of each subtree in its parent
+   *  node and returns the mask of the entire subtree, subtrees below other
+   *  than aligned nodes conservatively get all mask bits set */
+  template<int N, typename Primitive>
+  static unsigned int updateSubtreeMasks(const Scene* scene, typename BVHN<N>::NodeRef node)
+  {
+    if (node.isLeaf())
+    {
+      size_t num; const Primitive* prims = (const Primitive*) node.leaf(num);
+      unsigned int mask = 0;
+      for (size_t i=0; i<num; i++)
+        mask |= LeafMask<Primitive>::get(scene,prims[i]);
+      return mask;
+    }
+    if (!node.isAlignedNode())
+      return unsigned(-1);
+
+    typename BVHN<N>::AlignedNode* n = node.alignedNode();
+    unsigned int mask = 0;
+    for (size_t c=0; c<N; c++) {
+      if (n->child(c) == BVHN<N>::emptyNode) continue;
+      n->mask[c] = updateSubtreeMasks<N,Primitive>(scene,n->child(c));
+      mask |= n->mask[c];
+    }
+    return mask;
+  }
+
+  template<int N, typename Primitive>
+  static void updateNodeMasks(BVHN<N>* bvh)
+  {
+    typename BVHN<N>::NodeRef root = bvh->root;
+    if (root.isLeaf() || !root.isAlignedNode())
+      return;
+
+    /* the subtrees of the root are processed in parallel */
+    typename BVHN<N>::AlignedNode* n = root.alignedNode();
+    parallel_for(size_t(N), [&] (size_t c) {
+      if (n->child(c) != BVHN<N>::emptyNode)
+        n->mask[c] = updateSubtreeMasks<N,Primitive>(bvh->scene,n->child(c));
+    });
+  }
+
+#endif
+
+  template<int N>
+  void BVHN<N>::updateMasks()
+  {
+#if defined(EMBREE_RAY_MASK)
+    if      (primTy == &Triangle4::type)         updateNodeMasks<N,Triangle4>(this);
+    else if (primTy == &Triangle4v::type)        updateNodeMasks<N,Triangle4v>(this);
+    else if (primTy == &Triangle4i::type)        updateNodeMasks<N,Triangle4i>(this);
+    else if (primTy == &Quad4v::type)            updateNodeMasks<N,Quad4v>(this);
+    else if (primTy == &Quad4i::type)            updateNodeMasks<N,Quad4i>(this);
+    else if (primTy == &Object::type)            updateNodeMasks<N,Object>(this);
+    else if (primTy == &InstancePrimitive::type) updateNodeMasks<N,InstancePrimitive>(this);
+#endif
+  }
+
   template<int N>
   double BVHN<N>::preBuild(const std::string& builderName)
   {
@@ -480,6 +480,9 @@ namespace embree
       __forceinline void clear() {
         lower_x = lower_y = lower_z = pos_inf;
         upper_x = upper_y = upper_z = neg_inf;
+#if defined(EMBREE_RAY_MASK)
+        mask = vint<N>(-1);
+#endif
         BaseNode::clear();
       }
 
@@ -538,6 +541,9 @@ namespace embree
         std::swap(upper_x[i],upper_x[j]);
         std::swap(upper_y[i],upper_y[j]);
         std::swap(upper_z[i],upper_z[j]);
+#if defined(EMBREE_RAY_MASK)
+        std::swap(mask[i],mask[j]);
+#endif
       }
 
       /*! Returns reference to specified child */
@@ -568,6 +574,9 @@ namespace embree
       vfloat<N> upper_y;           //!< Y dimension of upper bounds of all N children.
       vfloat<N> lower_z;           //!< Z dimension of lower bounds of all N children.
       vfloat<N> upper_z;           //!< Z dimension of upper bounds of all N children.
+#if defined(EMBREE_RAY_MASK)
+      vint<N> mask;                //!< OR of the geometry masks of all N subtrees.
+#endif
     };
 
     /*! Motion Blur AlignedNode */
@@ -1439,6 +1448,12 @@ namespace embree
     void layoutLargeNodes(size_t num);
     NodeRef layoutLargeNodesRecursion(NodeRef& node, const FastAllocator::CachedAllocator& allocator);
 
+    /*! stores the mesh vertices in the order the leaves reference them */
+    void reorderVertices();
+
+    /*! recalculates the geometry masks stored in the aligned nodes */
+    void updateMasks();
+
     /*! called by all builders before build starts */
     double preBuild(const std::string& builderName);
 
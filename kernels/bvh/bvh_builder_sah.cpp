@@ -596,10 +596,34 @@ namespace embree
 
 #if defined(EMBREE_GEOMETRY_USER)
 
+    /* user geometries with batched callbacks get leaves of up to their batch size */
+    template<int N>
+    struct BVHNBuilderSAHVirtual : public BVHNBuilderSAH<N,UserGeometry,Object>
+    {
+      typedef BVHNBuilderSAH<N,UserGeometry,Object> Base;
+      const size_t minLeafSize;
+      const size_t maxLeafSize;
+
+      BVHNBuilderSAHVirtual (BVHN<N>* bvh, Scene* scene, const size_t mode)
+        : Base(bvh,scene,N,1.0f,scene->device->object_accel_min_leaf_size,scene->device->object_accel_max_leaf_size,mode),
+          minLeafSize(this->settings.minLeafSize), maxLeafSize(this->settings.maxLeafSize) {}
+
+      void build()
+      {
+        size_t batchSize = 1;
+        Scene::Iterator<UserGeometry,false> iter(this->scene);
+        for (size_t i=0; i<iter.size(); i++)
+          if (UserGeometry* geom = iter.at(i))
+            batchSize = max(batchSize,size_t(geom->batchSize));
+
+        this->settings.maxLeafSize = min(max(maxLeafSize,batchSize),Object::max_size()*BVHN<N>::maxLeafBlocks);
+        this->settings.minLeafSize = min(max(minLeafSize,batchSize),this->settings.maxLeafSize);
+        Base::build();
+      }
+    };
+
     Builder* BVH4VirtualSceneBuilderSAH    (void* bvh, Scene* scene, size_t mode) {
-      int minLeafSize = scene->device->object_accel_min_leaf_size;
-      int maxLeafSize = scene->device->object_accel_max_leaf_size;
-      return new BVHNBuilderSAH<4,UserGeometry,Object>((BVH4*)bvh,scene,4,1.0f,minLeafSize,maxLeafSize,mode);
+      return new BVHNBuilderSAHVirtual<4>((BVH4*)bvh,scene,mode);
     }
 
     Builder* BVH4VirtualMeshBuilderSAH    (void* bvh, UserGeometry* mesh, size_t mode) {
@@ -608,9 +632,7 @@ namespace embree
 #if defined(__AVX__)
 
     Builder* BVH8VirtualSceneBuilderSAH    (void* bvh, Scene* scene, size_t mode) {
-      int minLeafSize = scene->device->object_accel_min_leaf_size;
-      int maxLeafSize = scene->device->object_accel_max_leaf_size;
-      return new BVHNBuilderSAH<8,UserGeometry,Object>((BVH8*)bvh,scene,8,1.0f,minLeafSize,maxLeafSize,mode);
+      return new BVHNBuilderSAHVirtual<8>((BVH8*)bvh,scene,mode);
     }
 
     Builder* BVH8VirtualMeshBuilderSAH    (void* bvh, UserGeometry* mesh, size_t mode) {
@@ -41,19 +41,37 @@ namespace embree
     typedef FastAllocator::CachedAllocator Allocator;
 
     template<int N>
-    struct BVHNSubdivPatch1BuilderSAH : public Builder
+    struct BVHNSubdivPatch1BuilderSAH : public Builder, public BVHNRefitter<N>::LeafBoundsInterface
     {
       ALIGNED_STRUCT_(64);
 
       typedef BVHN<N> BVH;
       typedef typename BVH::NodeRef NodeRef;
 
+      struct MeshState
+      {
+        __forceinline MeshState (SubdivMesh* mesh = nullptr)
+          : mesh(mesh), numFaces(mesh ? mesh->size() : 0) {}
+
+        __forceinline bool operator!= (const MeshState& other) const {
+          return mesh != other.mesh || numFaces != other.numFaces;
+        }
+
+        SubdivMesh* mesh;
+        size_t numFaces;
+      };
+
       BVH* bvh;
       Scene* scene;
       mvector<PrimRef> prims;
+      mvector<GridSOA*> grids;       //!< all subgrids in order of creation, kept for dynamic scenes
+      mvector<size_t> faceGrids;     //!< index of the first subgrid of each face
+      std::vector<MeshState> meshes; //!< state of all meshes at last build
+      std::unique_ptr<BVHNRefitter<N>> refitter;
             
       BVHNSubdivPatch1BuilderSAH (BVH* bvh, Scene* scene)
-        : bvh(bvh), scene(scene), prims(scene->device,0) {}
+        : bvh(bvh), scene(scene), prims(scene->device,0), grids(scene->device,0), faceGrids(scene->device,0), 
+          refitter(new BVHNRefitter<N>(bvh,*(typename BVHNRefitter<N>::LeafBoundsInterface*)this)) {}
 
 #define SUBGRID 9
 
@@ -66,7 +84,7 @@ namespace embree
         return w*h;
       }
 
-      __forceinline static unsigned createEager(SubdivPatch1Base& patch, Scene* scene, SubdivMesh* mesh, unsigned primID, Allocator& alloc, PrimRef* prims)
+      __forceinline static unsigned createEager(SubdivPatch1Base& patch, Scene* scene, SubdivMesh* mesh, unsigned primID, Allocator& alloc, PrimRef* prims, GridSOA** grids)
       {
         unsigned NN = 0;
         const unsigned x0 = 0, x1 = patch.grid_u_res-1;
@@ -81,14 +99,99 @@ namespace embree
             BBox3fa bounds;
             GridSOA* leaf = GridSOA::create(&patch,1,lx0,lx1,ly0,ly1,scene,alloc,&bounds);
             *prims = PrimRef(bounds,BVH4::encodeTypedLeaf(leaf,1)); prims++;
+            if (grids) grids[NN] = leaf;
+            NN++;
+          }
+        }
+        return NN;
+      }
+
+      /* re-tessellates all subgrids of a patch in place, the grid size of the patch must not have changed */
+      __forceinline static unsigned updateEager(SubdivPatch1Base& patch, Scene* scene, GridSOA** grids)
+      {
+        unsigned NN = 0;
+        const unsigned x0 = 0, x1 = patch.grid_u_res-1;
+        const unsigned y0 = 0, y1 = patch.grid_v_res-1;
+        
+        for (unsigned y=y0; y<y1; y+=SUBGRID-1)
+        {
+          for (unsigned x=x0; x<x1; x+=SUBGRID-1) 
+          {
+            const unsigned lx0 = x, lx1 = min(lx0+SUBGRID-1,x1);
+            const unsigned ly0 = y, ly1 = min(ly0+SUBGRID-1,y1);
+            GridSOA::update(grids[NN],&patch,1,lx0,lx1,ly0,ly1,scene);
             NN++;
           }
         }
         return NN;
       }
 
+      virtual const BBox3fa leafBounds (NodeRef& ref) const
+      {
+        if (unlikely(ref == BVH::emptyNode)) return empty;
+        size_t num; const GridSOA* grid = (const GridSOA*) ref.leaf(num);
+        const BVH4::NodeRef root = grid->root(0);
+        if (root.isAlignedNode()) return root.alignedNode()->bounds();
+        return grid->calculateBounds(0,GridRange(0,grid->width-1,0,grid->height-1));
+      }
+
+      /* checks if only faces of meshes changed that got marked as modified */
+      bool partiallyModified()
+      {
+        Scene::Iterator<SubdivMesh> iter(scene);
+        if (meshes.size() == 0 || meshes.size() != iter.size()) 
+          return false;
+
+        for (size_t i=0; i<iter.size(); i++)
+        {
+          SubdivMesh* mesh = iter.at(i);
+          if (MeshState(mesh) != meshes[i]) return false;
+          if (mesh && !mesh->partiallyModified()) return false;
+        }
+        return true;
+      }
+
+      /* re-tessellates all modified faces and refits the BVH */
+      void update()
+      {
+        double t0 = bvh->preBuild(TOSTRING(isa) "::BVH" + toString(N) + "SubdivPatch1Update");
+
+        Scene::Iterator<SubdivMesh> iter(scene);
+        for (size_t i=0, faceOffset=0; i<iter.size(); i++)
+        {
+          SubdivMesh* mesh = iter.at(i);
+          if (!mesh) continue;
+          
+          parallel_for(size_t(0), mesh->size(), size_t(1024), [&](const range<size_t>& r) 
+          {
+            for (size_t f=r.begin(); f!=r.end(); ++f) 
+            {
+              if (!mesh->faceModified(f) || !mesh->valid(f)) continue;
+              size_t g = faceGrids[faceOffset+f];
+              patch_eval_subdivision(mesh->getHalfEdge(0,f),[&](const Vec2f uv[4], const int subdiv[4], const float edge_level[4], int subPatch)
+              {
+                SubdivPatch1Base patch(mesh->geomID,unsigned(f),subPatch,mesh,0,uv,edge_level,subdiv,VSIZEX);
+                g += updateEager(patch,scene,&grids[g]);
+              });
+              assert(g == faceGrids[faceOffset+f+1]);
+            }
+          });
+          faceOffset += mesh->size();
+        }
+
+        refitter->refit();
+        bvh->postBuild(t0);
+      }
+
       void build() 
       {
+        /* only re-tessellate modified faces when only vertices moved */
+        if (partiallyModified()) {
+          update();
+          return;
+        }
+        meshes.clear();
+
         /* skip build for empty scene */
         const size_t numPrimitives = scene->getNumPrimitives<SubdivMesh,false>();
         if (numPrimitives == 0) {
@@ -140,18 +243,24 @@ namespace embree
           return;
         }
 
+        /* remember subgrids of each face for later updates of dynamic scenes */
+        const bool dynamic = !scene->isStaticAccel();
+        grids.resize(dynamic ? pinfo1.end : 0);
+        faceGrids.resize(dynamic ? pstate.size()+1 : 0);
+
         PrimInfo pinfo3 = parallel_for_for_prefix_sum1( pstate, iter, PrimInfo(empty), [&](SubdivMesh* mesh, const range<size_t>& r, size_t k, const PrimInfo& base) -> PrimInfo
         {
           Allocator alloc = bvh->alloc.getCachedAllocator();
           
           PrimInfo s(empty);
           for (size_t f=r.begin(); f!=r.end(); ++f) {
+            if (dynamic) faceGrids[k+f-r.begin()] = base.end+s.end;
             if (!mesh->valid(f)) continue;
             
             patch_eval_subdivision(mesh->getHalfEdge(0,f),[&](const Vec2f uv[4], const int subdiv[4], const float edge_level[4], int subPatch)
             {
               SubdivPatch1Base patch(mesh->geomID,unsigned(f),subPatch,mesh,0,uv,edge_level,subdiv,VSIZEX);
-              size_t num = createEager(patch,scene,mesh,unsigned(f),alloc,&prims[base.end+s.end]);
+              size_t num = createEager(patch,scene,mesh,unsigned(f),alloc,&prims[base.end+s.end],dynamic ? &grids[base.end+s.end] : nullptr);
               assert(num == getNumEagerLeaves(patch.grid_u_res,patch.grid_v_res));
               for (size_t i=0; i<num; i++)
                 s.add_center2(prims[base.end+s.end]);
@@ -181,6 +290,14 @@ namespace embree
         NodeRef root = BVHNBuilderVirtual<N>::build(&bvh->alloc,createLeaf,virtualprogress,prims.data(),pinfo,settings);
         bvh->set(root,LBBox3fa(pinfo.geomBounds),pinfo.size());
         bvh->layoutLargeNodes(size_t(pinfo.size()*0.005f));
+
+        /* record mesh states the subgrids got created for */
+        if (dynamic) 
+        {
+          faceGrids[pstate.size()] = pinfo3.end;
+          for (size_t i=0; i<iter.size(); i++)
+            meshes.push_back(MeshState(iter.at(i)));
+        }
         
 	/* clear temporary data for static geometry */
 	if (scene->isStaticAccel()) {
@@ -193,6 +310,9 @@ namespace embree
 
       void clear() {
         prims.clear();
+        grids.clear();
+        faceGrids.clear();
+        meshes.clear();
       }
     };
 
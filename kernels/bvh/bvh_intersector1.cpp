@@ -105,6 +105,9 @@ namespace embree
           STAT3(normal.trav_nodes,1,1,1);
           bool nodeIntersected = BVHNNodeIntersector1<N, Nx, types, robust>::intersect(cur, tray, ray.time(), tNear, mask);
           if (unlikely(!nodeIntersected)) { STAT3(normal.trav_nodes,-1,-1,-1); break; }
+#if defined(EMBREE_RAY_MASK)
+          mask &= maskNode<N,types>(cur, ray.mask);
+#endif
 
           /* if no child is hit, pop next node */
           if (unlikely(mask == 0))
@@ -122,6 +125,10 @@ namespace embree
         PrimitiveIntersector1::intersect(This, pre, ray, context, prim, num, tray, lazy_node);
         tray.tfar = ray.tfar;
 
+        /* stop traversal at the first hit found if the context allows it */
+        if (unlikely(context->terminateOnFirstHit()) && ray.geomID != RTC_INVALID_GEOMETRY_ID)
+          break;
+
         /* push lazy node onto stack */
         if (unlikely(lazy_node)) {
           stackPtr->ptr = lazy_node;
@@ -187,6 +194,9 @@ namespace embree
           STAT3(shadow.trav_nodes,1,1,1);
           bool nodeIntersected = BVHNNodeIntersector1<N, Nx, types, robust>::intersect(cur, tray, ray.time(), tNear, mask);
           if (unlikely(!nodeIntersected)) { STAT3(shadow.trav_nodes,-1,-1,-1); break; }
+#if defined(EMBREE_RAY_MASK)
+          mask &= maskNode<N,types>(cur, ray.mask);
+#endif
 
           /* if no child is hit, pop next node */
           if (unlikely(mask == 0))
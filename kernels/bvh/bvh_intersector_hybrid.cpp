@@ -95,6 +95,9 @@ namespace embree
           size_t mask = 0;
           vfloat<Nx> tNear;
           BVHNNodeIntersector1<N, Nx, types, robust>::intersect(cur, tray1, ray.time()[k], tNear, mask);
+#if defined(EMBREE_RAY_MASK)
+          mask &= maskNode<N,types>(cur, ray.mask[k]);
+#endif
 
           /* if no child is hit, pop next node */
           if (unlikely(mask == 0))
@@ -114,6 +117,10 @@ namespace embree
 
         tray1.tfar = ray.tfar[k];
 
+        /* stop traversal at the first hit found if the context allows it */
+        if (unlikely(context->terminateOnFirstHit()) && ray.geomID[k] != RTC_INVALID_GEOMETRY_ID)
+          break;
+
         if (unlikely(lazy_node)) {
           stackPtr->ptr = lazy_node;
           stackPtr->dist = neg_inf;
@@ -266,6 +273,8 @@ namespace embree
                 intersect1(This, bvh, cur, i, pre, ray, tray, context);
               }
               tray.tfar = min(tray.tfar, ray.tfar);
+              if (unlikely(context->terminateOnFirstHit()))
+                tray.tfar = select(ray.geomID != vuint<K>(RTC_INVALID_GEOMETRY_ID), vfloat<K>(neg_inf), tray.tfar);
               continue;
             }
           }
@@ -291,6 +300,9 @@ namespace embree
               vfloat<K> lnearP;
               vbool<K> lhit = valid_node;
               BVHNNodeIntersectorK<N, K, types, robust>::intersect(nodeRef, i, tray, ray.time(), lnearP, lhit);
+#if defined(EMBREE_RAY_MASK)
+              lhit &= maskNodeK<N,K,types>(nodeRef, i, ray.mask);
+#endif
 
               /* if we hit the child we choose to continue with that child if it
                  is closer than the current next child, or we push it onto the stack */
@@ -381,6 +393,10 @@ namespace embree
           PrimitiveIntersectorK::intersect(valid_leaf, This, pre, ray, context, prim, items, tray, lazy_node);
           tray.tfar = select(valid_leaf, ray.tfar, tray.tfar);
 
+          /* rays that found a hit stop traversal if the context allows it */
+          if (unlikely(context->terminateOnFirstHit()))
+            tray.tfar = select(ray.geomID != vuint<K>(RTC_INVALID_GEOMETRY_ID), vfloat<K>(neg_inf), tray.tfar);
+
           if (unlikely(lazy_node)) {
             *sptr_node = lazy_node; sptr_node++;
             *sptr_near = neg_inf;   sptr_near++;
@@ -475,6 +491,9 @@ namespace embree
               vbool<K> lhit = false; // motion blur is not supported, so the initial value will be ignored
               STAT3(normal.trav_nodes, 1, 1, 1);
               BVHNNodeIntersectorK<N, K, types, robust>::intersect(nodeRef, i, tray, ray.time(), lnearP, lhit);
+#if defined(EMBREE_RAY_MASK)
+              lhit &= maskNodeK<N,K,types>(nodeRef, i, ray.mask);
+#endif
 
               if (likely(any(lhit)))
               {                                
@@ -589,6 +608,9 @@ namespace embree
             size_t mask = 0;
             vfloat<Nx> tNear;
             BVHNNodeIntersector1<N, Nx, types, robust>::intersect(cur, tray1, ray.time()[k], tNear, mask);
+#if defined(EMBREE_RAY_MASK)
+            mask &= maskNode<N,types>(cur, ray.mask[k]);
+#endif
 
             /* if no child is hit, pop next node */
             if (unlikely(mask == 0))
@@ -739,6 +761,9 @@ namespace embree
             vfloat<K> lnearP;
             vbool<K> lhit = valid_node;
             BVHNNodeIntersectorK<N, K, types, robust>::intersect(nodeRef, i, tray, ray.time(), lnearP, lhit);
+#if defined(EMBREE_RAY_MASK)
+            lhit &= maskNodeK<N,K,types>(nodeRef, i, ray.mask);
+#endif
 
             /* if we hit the child we push the previously hit node onto the stack, and continue with the currently hit child */
             if (likely(any(lhit)))
@@ -889,6 +914,9 @@ namespace embree
               vbool<K> lhit = false; // motion blur is not supported, so the initial value will be ignored
               STAT3(normal.trav_nodes, 1, 1, 1);
               BVHNNodeIntersectorK<N, K, types, robust>::intersect(nodeRef, i, tray, ray.time(), lnearP, lhit);
+#if defined(EMBREE_RAY_MASK)
+              lhit &= maskNodeK<N,K,types>(nodeRef, i, ray.mask);
+#endif
 
               if (likely(any(lhit)))
               {                                
@@ -22,6 +22,7 @@
 #include "../geometry/trianglev.h"
 #include "../geometry/trianglei.h"
 #include "../geometry/quadv.h"
+#include "../geometry/quadi.h"
 #include "../geometry/object.h"
 
 namespace embree
@@ -178,30 +179,469 @@ namespace embree
       return merge<N>(bounds);
     }
 
+    template<int N>
+    void BVHNRefitter<N>::gather_leaves(std::vector<NodeRef>& leaves)
+    {
+      leaves.clear();
+      subTreeInfos.clear();
+      gather_leaves(bvh->root,leaves);
+    }
+
+    template<int N>
+    typename BVHNRefitter<N>::SubtreeInfo BVHNRefitter<N>::gather_leaves(NodeRef& ref, std::vector<NodeRef>& leaves)
+    {
+      if (ref.isLeaf())
+      {
+        if (unlikely(ref == BVH::emptyNode)) return SubtreeInfo(0,0);
+        leaves.push_back(ref);
+        return SubtreeInfo(0,1);
+      }
+
+      /* reserve slot for this node before visiting the children to get depth first order */
+      const size_t innerID = subTreeInfos.size();
+      subTreeInfos.push_back(SubtreeInfo(1,0));
+
+      SubtreeInfo info(1,0);
+      AlignedNode* node = ref.alignedNode();
+      for (size_t i=0; i<N; i++)
+      {
+        NodeRef& child = node->child(i);
+        if (unlikely(child == BVH::emptyNode)) continue;
+        const SubtreeInfo cinfo = gather_leaves(child,leaves);
+        info.numInner  += cinfo.numInner;
+        info.numLeaves += cinfo.numLeaves;
+      }
+      subTreeInfos[innerID] = info;
+      return info;
+    }
+
+    template<int N>
+    void BVHNRefitter<N>::refit_partial(const std::vector<unsigned int>& leafIDs)
+    {
+      if (leafIDs.empty())
+        return;
+
+      if (bvh->root.isLeaf())
+        bvh->bounds = LBBox3fa(leafBounds.leafBounds(bvh->root));
+      else
+        bvh->bounds = LBBox3fa(recurse_partial(bvh->root,0,0,leafIDs.data(),leafIDs.data()+leafIDs.size()));
+    }
+
+    template<int N>
+    BBox3fa BVHNRefitter<N>::recurse_partial(NodeRef& ref, size_t innerID, size_t leafID,
+                                             const unsigned int* leafIDs_begin,
+                                             const unsigned int* leafIDs_end)
+    {
+      AlignedNode* node = ref.alignedNode();
+      size_t childInnerID = innerID+1;
+      size_t childLeafID = leafID;
+      BBox3fa bounds[N];
+
+      for (size_t i=0; i<N; i++)
+      {
+        NodeRef& child = node->child(i);
+        if (unlikely(child == BVH::emptyNode)) {
+          bounds[i] = BBox3fa(empty);
+          continue;
+        }
+
+        /* recalculate bounds of modified leaves only */
+        if (child.isLeaf())
+        {
+          if (leafIDs_begin != leafIDs_end && *leafIDs_begin == childLeafID) {
+            bounds[i] = leafBounds.leafBounds(child);
+            leafIDs_begin++;
+          }
+          else
+            bounds[i] = node->bounds(i);
+          childLeafID++;
+        }
+
+        /* descend only into subtrees containing modified leaves */
+        else
+        {
+          const SubtreeInfo& info = subTreeInfos[childInnerID];
+          const unsigned int* end = std::lower_bound(leafIDs_begin,leafIDs_end,unsigned(childLeafID+info.numLeaves));
+          if (end != leafIDs_begin)
+            bounds[i] = recurse_partial(child,childInnerID,childLeafID,leafIDs_begin,end);
+          else
+            bounds[i] = node->bounds(i);
+          leafIDs_begin = end;
+          childInnerID += info.numInner;
+          childLeafID += info.numLeaves;
+        }
+      }
+
+      /* AOS to SOA transform */
+      BBox3vf<N> boundsT = transpose<N>(bounds);
+
+      /* set new bounds */
+      node->lower_x = boundsT.lower.x;
+      node->lower_y = boundsT.lower.y;
+      node->lower_z = boundsT.lower.z;
+      node->upper_x = boundsT.upper.x;
+      node->upper_y = boundsT.upper.y;
+      node->upper_z = boundsT.upper.z;
+
+      return merge<N>(bounds);
+    }
+
+    // =========================================================
+    // =========================================================
+    // =========================================================
+
+    template<int N>
+    BVHNRefitterMB<N>::BVHNRefitterMB (BVH* bvh, const LeafBoundsInterface& leafBounds)
+      : bvh(bvh), leafBounds(leafBounds), numSubTrees(0)
+    {
+    }
+
+    template<int N>
+    void BVHNRefitterMB<N>::refit(const BBox1f& time_range)
+    {
+      if (bvh->numPrimitives <= SINGLE_THREAD_THRESHOLD) {
+        bvh->bounds = recurse_bottom(bvh->root,time_range);
+      }
+      else
+      {
+        LBBox3fa subTreeBounds[MAX_NUM_SUB_TREES];
+        numSubTrees = 0;
+        gather_subtree_refs(bvh->root,time_range,numSubTrees,0);
+        if (numSubTrees)
+          parallel_for(size_t(0), numSubTrees, size_t(1), [&](const range<size_t>& r) {
+              for (size_t i=r.begin(); i<r.end(); i++) {
+                NodeRef& ref = subTrees[i];
+                subTreeBounds[i] = recurse_bottom(ref,subTreeTimeRanges[i]);
+              }
+            });
+
+        numSubTrees = 0;
+        bvh->bounds = refit_toplevel(bvh->root,time_range,numSubTrees,subTreeBounds,0);
+      }
+    }
+
+    template<int N>
+    __forceinline LBBox3fa BVHNRefitterMB<N>::setChildBounds(NodeRef& ref, size_t i, const LBBox3fa& bounds, const BBox1f& ctime_range, const BBox1f& time_range)
+    {
+      if (likely(ref.isAlignedNodeMB())) {
+        ref.alignedNodeMB()->setBounds(i,bounds,ctime_range);
+        return bounds;
+      }
+
+      /* child of a node with time splits covers only part of the node time
+       * range, extrapolating its bounds keeps them conservative inside that part */
+      ref.alignedNodeMB4D()->setBounds(i,bounds,ctime_range);
+      const float rcp_size = 1.0f/time_range.size();
+      const BBox1f dt((ctime_range.lower-time_range.lower)*rcp_size,(ctime_range.upper-time_range.lower)*rcp_size);
+      return bounds.global(dt);
+    }
+
+    template<int N>
+    void BVHNRefitterMB<N>::gather_subtree_refs(NodeRef& ref,
+                                                const BBox1f& time_range,
+                                                size_t &subtrees,
+                                                const size_t depth)
+    {
+      if (depth >= MAX_SUB_TREE_EXTRACTION_DEPTH)
+      {
+        assert(subtrees < MAX_NUM_SUB_TREES);
+        subTreeTimeRanges[subtrees] = time_range;
+        subTrees[subtrees++] = ref;
+        return;
+      }
+
+      if (ref.isAlignedNodeMB() || ref.isAlignedNodeMB4D())
+      {
+        AlignedNodeMB* node = ref.alignedNodeMB();
+        for (size_t i=0; i<N; i++) {
+          NodeRef& child = node->child(i);
+          if (unlikely(child == BVH::emptyNode)) continue;
+          gather_subtree_refs(child,childTimeRange(ref,i,time_range),subtrees,depth+1);
+        }
+      }
+    }
+
+    template<int N>
+    LBBox3fa BVHNRefitterMB<N>::refit_toplevel(NodeRef& ref,
+                                               const BBox1f& time_range,
+                                               size_t &subtrees,
+                                               const LBBox3fa *const subTreeBounds,
+                                               const size_t depth)
+    {
+      if (depth >= MAX_SUB_TREE_EXTRACTION_DEPTH)
+      {
+        assert(subtrees < MAX_NUM_SUB_TREES);
+        assert(subTrees[subtrees] == ref);
+        return subTreeBounds[subtrees++];
+      }
+
+      if (ref.isAlignedNodeMB() || ref.isAlignedNodeMB4D())
+      {
+        AlignedNodeMB* node = ref.alignedNodeMB();
+        LBBox3fa bounds = empty;
+
+        for (size_t i=0; i<N; i++)
+        {
+          NodeRef& child = node->child(i);
+          if (unlikely(child == BVH::emptyNode)) continue;
+
+          const BBox1f ctime_range = childTimeRange(ref,i,time_range);
+          const LBBox3fa cbounds = refit_toplevel(child,ctime_range,subtrees,subTreeBounds,depth+1);
+          bounds.extend(setChildBounds(ref,i,cbounds,ctime_range,time_range));
+        }
+        return bounds;
+      }
+      else
+        return leafBounds.leafBounds(ref,time_range);
+    }
+
+    template<int N>
+    LBBox3fa BVHNRefitterMB<N>::recurse_bottom(NodeRef& ref, const BBox1f& time_range)
+    {
+      /* this is a leaf node */
+      if (unlikely(ref.isLeaf()))
+        return leafBounds.leafBounds(ref,time_range);
+
+      /* recurse if this is an internal node */
+      AlignedNodeMB* node = ref.alignedNodeMB();
+
+      /* enable exclusive prefetch for >= AVX platforms */
+#if defined(__AVX__)
+      ref.prefetchW();
+#endif
+      LBBox3fa bounds = empty;
+
+      for (size_t i=0; i<N; i++)
+      {
+        NodeRef& child = node->child(i);
+        if (unlikely(child == BVH::emptyNode)) continue;
+
+        const BBox1f ctime_range = childTimeRange(ref,i,time_range);
+        const LBBox3fa cbounds = recurse_bottom(child,ctime_range);
+        bounds.extend(setChildBounds(ref,i,cbounds,ctime_range,time_range));
+      }
+      return bounds;
+    }
+
+    /* invokes the function for the ID of each valid primitive of a leaf block */
+    template<typename Primitive, typename Func>
+    __forceinline void foreachPrimID(const Primitive& prim, const Func& func)
+    {
+      for (size_t i=0; i<Primitive::max_size(); i++)
+        if (prim.valid(i)) func(prim.primID(i));
+    }
+
+    template<typename Func>
+    __forceinline void foreachPrimID(const Object& prim, const Func& func) {
+      func(prim.primID());
+    }
+
+    /* vertex access for meshes that support partial refits */
+    template<typename Mesh>
+    struct PartialRefitMesh
+    {
+      static __forceinline const ModifiedRanges* modifiedVertices(const Mesh* mesh) { return nullptr; }
+      static __forceinline size_t numVertices(const Mesh* mesh) { return 0; }
+      static __forceinline size_t primVertices(const Mesh* mesh, size_t primID, unsigned int* vtx) { return 0; }
+    };
+
+    template<>
+    struct PartialRefitMesh<TriangleMesh>
+    {
+      static __forceinline const ModifiedRanges* modifiedVertices(const TriangleMesh* mesh) {
+        return mesh->partiallyModified() ? &mesh->modifiedVertices : nullptr;
+      }
+
+      static __forceinline size_t numVertices(const TriangleMesh* mesh) {
+        return mesh->numVertices();
+      }
+
+      static __forceinline size_t primVertices(const TriangleMesh* mesh, size_t primID, unsigned int* vtx)
+      {
+        const TriangleMesh::Triangle& tri = mesh->triangle(primID);
+        vtx[0] = tri.v[0]; vtx[1] = tri.v[1]; vtx[2] = tri.v[2];
+        return 3;
+      }
+    };
+
+    template<>
+    struct PartialRefitMesh<QuadMesh>
+    {
+      static __forceinline const ModifiedRanges* modifiedVertices(const QuadMesh* mesh) {
+        return mesh->partiallyModified() ? &mesh->modifiedVertices : nullptr;
+      }
+
+      static __forceinline size_t numVertices(const QuadMesh* mesh) {
+        return mesh->numVertices();
+      }
+
+      static __forceinline size_t primVertices(const QuadMesh* mesh, size_t primID, unsigned int* vtx)
+      {
+        const QuadMesh::Quad& quad = mesh->quad(primID);
+        vtx[0] = quad.v[0]; vtx[1] = quad.v[1]; vtx[2] = quad.v[2]; vtx[3] = quad.v[3];
+        return 4;
+      }
+    };
+
     template<int N, typename Mesh, typename Primitive>
     BVHNRefitT<N,Mesh,Primitive>::BVHNRefitT (BVH* bvh, Builder* builder, Mesh* mesh, size_t mode)
-      : bvh(bvh), builder(builder), refitter(new BVHNRefitter<N>(bvh,*(typename BVHNRefitter<N>::LeafBoundsInterface*)this)), mesh(mesh) {}
+      : bvh(bvh), builder(builder), refitter(new BVHNRefitter<N>(bvh,*(typename BVHNRefitter<N>::LeafBoundsInterface*)this)), mesh(mesh),
+        partialRefitMaps(false), numLeaves(0) {}
 
     template<int N, typename Mesh, typename Primitive>
     void BVHNRefitT<N,Mesh,Primitive>::clear()
     {
       if (builder) 
         builder->clear();
+
+      partialRefitMaps = false;
+      std::vector<unsigned int>().swap(leafOfPrim);
+      std::vector<unsigned int>().swap(vertexPrimsOfs);
+      std::vector<unsigned int>().swap(vertexPrims);
+      std::vector<unsigned int>().swap(dirtyLeaves);
+    }
+
+    template<int N, typename Mesh, typename Primitive>
+    void BVHNRefitT<N,Mesh,Primitive>::buildPartialRefitMaps()
+    {
+      /* map each primitive to the depth first index of its leaf */
+      std::vector<NodeRef> leaves;
+      refitter->gather_leaves(leaves);
+      numLeaves = leaves.size();
+
+      leafOfPrim.assign(mesh->size(),unsigned(-1));
+      for (size_t i=0; i<leaves.size(); i++)
+      {
+        size_t num; char* prim = leaves[i].leaf(num);
+        for (size_t j=0; j<num; j++)
+          foreachPrimID(((Primitive*)prim)[j],[&] (unsigned int primID) { leafOfPrim[primID] = unsigned(i); });
+      }
+
+      /* count the primitives referencing each vertex */
+      const size_t numVertices = PartialRefitMesh<Mesh>::numVertices(mesh);
+      vertexPrimsOfs.assign(numVertices+1,0);
+      unsigned int vtx[4];
+      for (size_t primID=0; primID<leafOfPrim.size(); primID++)
+      {
+        if (leafOfPrim[primID] == unsigned(-1)) continue;
+        const size_t num = PartialRefitMesh<Mesh>::primVertices(mesh,primID,vtx);
+        for (size_t k=0; k<num; k++)
+          if (vtx[k] < numVertices) vertexPrimsOfs[vtx[k]]++;
+      }
+
+      /* inclusive prefix sum yields the end of the primitives of each vertex */
+      for (size_t v=1; v<=numVertices; v++)
+        vertexPrimsOfs[v] += vertexPrimsOfs[v-1];
+
+      /* filling backwards moves each offset to the start of its primitives */
+      vertexPrims.resize(vertexPrimsOfs[numVertices]);
+      for (size_t primID=leafOfPrim.size(); primID-- > 0; )
+      {
+        if (leafOfPrim[primID] == unsigned(-1)) continue;
+        const size_t num = PartialRefitMesh<Mesh>::primVertices(mesh,primID,vtx);
+        for (size_t k=0; k<num; k++)
+          if (vtx[k] < numVertices) vertexPrims[--vertexPrimsOfs[vtx[k]]] = unsigned(primID);
+      }
+
+      partialRefitMaps = true;
+    }
+
+    template<int N, typename Mesh, typename Primitive>
+    bool BVHNRefitT<N,Mesh,Primitive>::refitPartial(const ModifiedRanges& modifiedVertices)
+    {
+      const size_t numVertices = PartialRefitMesh<Mesh>::numVertices(mesh);
+      if (modifiedVertices.numItems() > numVertices/4)
+        return false;
+
+      /* a new vertex buffer may have changed the number of vertices */
+      if (!partialRefitMaps || vertexPrimsOfs.size() != numVertices+1)
+        buildPartialRefitMaps();
+
+      /* gather the leaves of all primitives referencing a modified vertex */
+      dirtyLeaves.clear();
+      for (const auto& r : modifiedVertices.get())
+      {
+        for (size_t v=r.begin(); v<min(size_t(r.end()),numVertices); v++)
+        {
+          for (size_t j=vertexPrimsOfs[v]; j<vertexPrimsOfs[v+1]; j++)
+            dirtyLeaves.push_back(leafOfPrim[vertexPrims[j]]);
+        }
+      }
+      std::sort(dirtyLeaves.begin(),dirtyLeaves.end());
+      dirtyLeaves.erase(std::unique(dirtyLeaves.begin(),dirtyLeaves.end()),dirtyLeaves.end());
+
+      if (dirtyLeaves.size() > numLeaves/4)
+        return false;
+
+      refitter->refit_partial(dirtyLeaves);
+      return true;
     }
     
     template<int N, typename Mesh, typename Primitive>
     void BVHNRefitT<N,Mesh,Primitive>::build()
     {
       if (mesh->topologyChanged()) {
+        partialRefitMaps = false;
         builder->build();
       }
       else
-        refitter->refit();
+      {
+        const ModifiedRanges* modifiedVertices = PartialRefitMesh<Mesh>::modifiedVertices(mesh);
+        if (!modifiedVertices || !refitPartial(*modifiedVertices))
+          refitter->refit();
+      }
+    }
+
+    template<int N, typename Mesh, typename Primitive>
+    BVHNRefitMBlurT<N,Mesh,Primitive>::BVHNRefitMBlurT (BVH* bvh, Builder* builder, Scene* scene, size_t mode)
+      : bvh(bvh), builder(builder), refitter(new BVHNRefitterMB<N>(bvh,*(typename BVHNRefitterMB<N>::LeafBoundsInterface*)this)), scene(scene), time_range(empty), built(false) {}
+
+    template<int N, typename Mesh, typename Primitive>
+    void BVHNRefitMBlurT<N,Mesh,Primitive>::clear()
+    {
+      if (builder)
+        builder->clear();
+      built = false;
+    }
+
+    template<int N, typename Mesh, typename Primitive>
+    bool BVHNRefitMBlurT<N,Mesh,Primitive>::updateMeshStates()
+    {
+      Scene::Iterator<Mesh,true> iter(scene);
+      bool rebuild = !built || meshes.size() != iter.size();
+      meshes.resize(iter.size());
+
+      time_range = empty;
+      for (size_t i=0; i<iter.size(); i++)
+      {
+        Mesh* mesh = iter.at(i);
+        const MeshState state = mesh ? MeshState(mesh) : MeshState();
+        if (mesh) {
+          rebuild |= mesh->topologyChanged();
+          time_range.extend(mesh->time_range);
+        }
+        rebuild |= state != meshes[i];
+        meshes[i] = state;
+      }
+      return rebuild;
+    }
+
+    template<int N, typename Mesh, typename Primitive>
+    void BVHNRefitMBlurT<N,Mesh,Primitive>::build()
+    {
+      if (updateMeshStates()) {
+        builder->build();
+        built = true;
+      }
+      else if (bvh->root != BVH::emptyNode)
+        refitter->refit(time_range);
     }
 
     template class BVHNRefitter<4>;
+    template class BVHNRefitterMB<4>;
 #if defined(__AVX__)
     template class BVHNRefitter<8>;
+    template class BVHNRefitterMB<8>;
 #endif
     
 #if defined(EMBREE_GEOMETRY_TRIANGLE)
@@ -212,6 +652,9 @@ namespace embree
     Builder* BVH4Triangle4MeshRefitSAH  (void* accel, TriangleMesh* mesh, size_t mode) { return new BVHNRefitT<4,TriangleMesh,Triangle4> ((BVH4*)accel,BVH4Triangle4MeshBuilderSAH (accel,mesh,mode),mesh,mode); }
     Builder* BVH4Triangle4vMeshRefitSAH (void* accel, TriangleMesh* mesh, size_t mode) { return new BVHNRefitT<4,TriangleMesh,Triangle4v>((BVH4*)accel,BVH4Triangle4vMeshBuilderSAH(accel,mesh,mode),mesh,mode); }
     Builder* BVH4Triangle4iMeshRefitSAH (void* accel, TriangleMesh* mesh, size_t mode) { return new BVHNRefitT<4,TriangleMesh,Triangle4i>((BVH4*)accel,BVH4Triangle4iMeshBuilderSAH(accel,mesh,mode),mesh,mode); }
+
+    Builder* BVH4Triangle4iMBSceneBuilderSAH (void* bvh, Scene* scene, size_t mode);
+    Builder* BVH4Triangle4iMBSceneRefitSAH (void* accel, Scene* scene, size_t mode) { return new BVHNRefitMBlurT<4,TriangleMesh,Triangle4i>((BVH4*)accel,BVH4Triangle4iMBSceneBuilderSAH(accel,scene,mode),scene,mode); }
 #if  defined(__AVX__)
     Builder* BVH8Triangle4MeshBuilderSAH  (void* bvh, TriangleMesh* mesh, size_t mode);
     Builder* BVH8Triangle4vMeshBuilderSAH (void* bvh, TriangleMesh* mesh, size_t mode);
@@ -220,6 +663,9 @@ namespace embree
     Builder* BVH8Triangle4MeshRefitSAH  (void* accel, TriangleMesh* mesh, size_t mode) { return new BVHNRefitT<8,TriangleMesh,Triangle4> ((BVH8*)accel,BVH8Triangle4MeshBuilderSAH (accel,mesh,mode),mesh,mode); }
     Builder* BVH8Triangle4vMeshRefitSAH (void* accel, TriangleMesh* mesh, size_t mode) { return new BVHNRefitT<8,TriangleMesh,Triangle4v>((BVH8*)accel,BVH8Triangle4vMeshBuilderSAH(accel,mesh,mode),mesh,mode); }
     Builder* BVH8Triangle4iMeshRefitSAH (void* accel, TriangleMesh* mesh, size_t mode) { return new BVHNRefitT<8,TriangleMesh,Triangle4i>((BVH8*)accel,BVH8Triangle4iMeshBuilderSAH(accel,mesh,mode),mesh,mode); }
+
+    Builder* BVH8Triangle4iMBSceneBuilderSAH (void* bvh, Scene* scene, size_t mode);
+    Builder* BVH8Triangle4iMBSceneRefitSAH (void* accel, Scene* scene, size_t mode) { return new BVHNRefitMBlurT<8,TriangleMesh,Triangle4i>((BVH8*)accel,BVH8Triangle4iMBSceneBuilderSAH(accel,scene,mode),scene,mode); }
 #endif
 #endif
 
@@ -227,9 +673,15 @@ namespace embree
     Builder* BVH4Quad4vMeshBuilderSAH (void* bvh, QuadMesh* mesh, size_t mode);
     Builder* BVH4Quad4vMeshRefitSAH (void* accel, QuadMesh* mesh, size_t mode) { return new BVHNRefitT<4,QuadMesh,Quad4v>((BVH4*)accel,BVH4Quad4vMeshBuilderSAH(accel,mesh,mode),mesh,mode); }
 
+    Builder* BVH4Quad4iMBSceneBuilderSAH (void* bvh, Scene* scene, size_t mode);
+    Builder* BVH4Quad4iMBSceneRefitSAH (void* accel, Scene* scene, size_t mode) { return new BVHNRefitMBlurT<4,QuadMesh,Quad4i>((BVH4*)accel,BVH4Quad4iMBSceneBuilderSAH(accel,scene,mode),scene,mode); }
+
 #if  defined(__AVX__)
     Builder* BVH8Quad4vMeshBuilderSAH (void* bvh, QuadMesh* mesh, size_t mode);
     Builder* BVH8Quad4vMeshRefitSAH (void* accel, QuadMesh* mesh, size_t mode) { return new BVHNRefitT<8,QuadMesh,Quad4v>((BVH8*)accel,BVH8Quad4vMeshBuilderSAH(accel,mesh,mode),mesh,mode); }
+
+    Builder* BVH8Quad4iMBSceneBuilderSAH (void* bvh, Scene* scene, size_t mode);
+    Builder* BVH8Quad4iMBSceneRefitSAH (void* accel, Scene* scene, size_t mode) { return new BVHNRefitMBlurT<8,QuadMesh,Quad4i>((BVH8*)accel,BVH8Quad4iMBSceneBuilderSAH(accel,scene,mode),scene,mode); }
 #endif
 
 #endif
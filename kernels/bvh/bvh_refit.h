@@ -36,6 +36,18 @@ namespace embree
         virtual const BBox3fa leafBounds(NodeRef& ref) const = 0;
       };
 
+      /*! size of the subtree of an inner node */
+      struct SubtreeInfo
+      {
+        __forceinline SubtreeInfo () {}
+
+        __forceinline SubtreeInfo (unsigned int numInner, unsigned int numLeaves)
+          : numInner(numInner), numLeaves(numLeaves) {}
+
+        unsigned int numInner;  //!< number of inner nodes including the subtree root
+        unsigned int numLeaves; //!< number of non-empty leaves
+      };
+
     public:
     
       /*! Constructor. */
@@ -44,7 +56,23 @@ namespace embree
       /*! refits the BVH */
       void refit();
 
+      /*! gathers all non-empty leaves in depth first order, the index of
+       *  a leaf in this order identifies the leaf in refit_partial */
+      void gather_leaves(std::vector<NodeRef>& leaves);
+
+      /*! refits only the specified leaves and their ancestors, requires
+       *  sorted leaf indices and unchanged topology since gather_leaves */
+      void refit_partial(const std::vector<unsigned int>& leafIDs);
+
     private:
+      /* records the subtree sizes of all inner nodes in depth first order */
+      SubtreeInfo gather_leaves(NodeRef& ref, std::vector<NodeRef>& leaves);
+
+      /* refits the subtree containing the sorted leaves [leafIDs_begin,leafIDs_end) */
+      BBox3fa recurse_partial(NodeRef& ref, size_t innerID, size_t leafID,
+                              const unsigned int* leafIDs_begin,
+                              const unsigned int* leafIDs_end);
+
       /* single-threaded subtree extraction based on BVH depth */
       void gather_subtree_refs(NodeRef& ref, 
                                size_t &subtrees,
@@ -67,6 +95,69 @@ namespace embree
       static const size_t MAX_NUM_SUB_TREES             = (N==4) ? 256 : (N==8) ? 512 : N*N*N; // N ^ MAX_SUB_TREE_EXTRACTION_DEPTH
       size_t numSubTrees;
       NodeRef subTrees[MAX_NUM_SUB_TREES];
+      std::vector<SubtreeInfo> subTreeInfos; //!< subtree sizes of inner nodes in depth first order
+    };
+
+    template<int N>
+    class BVHNRefitterMB
+    {
+    public:
+
+      /*! Type shortcuts */
+      typedef BVHN<N> BVH;
+      typedef typename BVH::AlignedNodeMB AlignedNodeMB;
+      typedef typename BVH::AlignedNodeMB4D AlignedNodeMB4D;
+      typedef typename BVH::NodeRef NodeRef;
+
+      struct LeafBoundsInterface {
+        virtual const LBBox3fa leafBounds(NodeRef& ref, const BBox1f& time_range) const = 0;
+      };
+
+    public:
+
+      /*! Constructor. */
+      BVHNRefitterMB (BVH* bvh, const LeafBoundsInterface& leafBounds);
+
+      /*! refits the motion blur BVH whose root spans the specified time range */
+      void refit(const BBox1f& time_range);
+
+    private:
+      /* returns the time range of the i'th child of a node */
+      static __forceinline BBox1f childTimeRange(NodeRef& ref, size_t i, const BBox1f& time_range)
+      {
+        if (likely(ref.isAlignedNodeMB())) return time_range;
+        const AlignedNodeMB4D* node = ref.alignedNodeMB4D();
+        return BBox1f(node->lower_t[i],min(node->upper_t[i],1.0f));
+      }
+
+      /* updates the bounds of the i'th child and returns them relative to the parent time range */
+      LBBox3fa setChildBounds(NodeRef& ref, size_t i, const LBBox3fa& bounds, const BBox1f& ctime_range, const BBox1f& time_range);
+
+      /* single-threaded subtree extraction based on BVH depth */
+      void gather_subtree_refs(NodeRef& ref,
+                               const BBox1f& time_range,
+                               size_t &subtrees,
+                               const size_t depth = 0);
+
+      /* single-threaded top-level refit */
+      LBBox3fa refit_toplevel(NodeRef& ref,
+                              const BBox1f& time_range,
+                              size_t &subtrees,
+                              const LBBox3fa *const subTreeBounds,
+                              const size_t depth = 0);
+
+      /* single-threaded subtree refit */
+      LBBox3fa recurse_bottom(NodeRef& ref, const BBox1f& time_range);
+
+    public:
+      BVH* bvh;                              //!< BVH to refit
+      const LeafBoundsInterface& leafBounds; //!< calculates linear bounds of leaves
+
+      static const size_t MAX_SUB_TREE_EXTRACTION_DEPTH = (N==4) ? 4   : (N==8) ? 3    : 3;
+      static const size_t MAX_NUM_SUB_TREES             = (N==4) ? 256 : (N==8) ? 512 : N*N*N; // N ^ MAX_SUB_TREE_EXTRACTION_DEPTH
+      size_t numSubTrees;
+      NodeRef subTrees[MAX_NUM_SUB_TREES];
+      BBox1f subTreeTimeRanges[MAX_NUM_SUB_TREES];
     };
 
     template<int N, typename Mesh, typename Primitive>
@@ -97,11 +188,87 @@ namespace embree
         return bounds;
       }
       
+    private:
+      /* builds the maps from vertices to primitives and from primitives to leaves */
+      void buildPartialRefitMaps();
+
+      /* refits only the leaves of primitives referencing a modified vertex,
+       * returns false if a full refit is cheaper */
+      bool refitPartial(const ModifiedRanges& modifiedVertices);
+
     private:
       BVH* bvh;
       std::unique_ptr<Builder> builder;
       std::unique_ptr<BVHNRefitter<N>> refitter;
       Mesh* mesh;
+
+      bool partialRefitMaps;                    //!< true if the maps below are valid for the current BVH
+      size_t numLeaves;                         //!< number of non-empty leaves of the BVH
+      std::vector<unsigned int> leafOfPrim;     //!< leaf index of each primitive
+      std::vector<unsigned int> vertexPrimsOfs; //!< start of the primitives of each vertex in vertexPrims
+      std::vector<unsigned int> vertexPrims;    //!< primitives referencing each vertex
+      std::vector<unsigned int> dirtyLeaves;    //!< leaves to refit
+    };
+
+    /*! Refits a motion blur BVH built over all meshes of a scene, as long as
+     *  no mesh changed its topology, time steps, or time range. */
+    template<int N, typename Mesh, typename Primitive>
+    class BVHNRefitMBlurT : public Builder, public BVHNRefitterMB<N>::LeafBoundsInterface
+    {
+    public:
+
+      /*! Type shortcuts */
+      typedef BVHN<N> BVH;
+      typedef typename BVH::NodeRef NodeRef;
+
+      /*! state of a mesh the BVH got built for */
+      struct MeshState
+      {
+        __forceinline MeshState ()
+          : mesh(nullptr), numTimeSteps(0), time_range(empty) {}
+
+        __forceinline MeshState (Mesh* mesh)
+          : mesh(mesh), numTimeSteps(mesh->numTimeSteps), time_range(mesh->time_range) {}
+
+        __forceinline bool operator!= (const MeshState& other) const {
+          return mesh != other.mesh || numTimeSteps != other.numTimeSteps || time_range != other.time_range;
+        }
+
+        Mesh* mesh;
+        unsigned int numTimeSteps;
+        BBox1f time_range;
+      };
+
+    public:
+      BVHNRefitMBlurT (BVH* bvh, Builder* builder, Scene* scene, size_t mode);
+
+      virtual void build();
+
+      virtual void clear();
+
+      virtual const LBBox3fa leafBounds (NodeRef& ref, const BBox1f& time_range) const
+      {
+        if (unlikely(ref == BVH::emptyNode)) return empty;
+        size_t num; char* prim = ref.leaf(num);
+
+        LBBox3fa bounds = empty;
+        for (size_t i=0; i<num; i++)
+          bounds.extend(((Primitive*)prim)[i].linearBounds(scene,time_range));
+        return bounds;
+      }
+
+    private:
+      /* updates the recorded mesh states and returns true if the BVH has to get rebuilt */
+      bool updateMeshStates();
+
+    private:
+      BVH* bvh;
+      std::unique_ptr<Builder> builder;
+      std::unique_ptr<BVHNRefitterMB<N>> refitter;
+      Scene* scene;
+      std::vector<MeshState> meshes; //!< state of all meshes at last rebuild
+      BBox1f time_range;             //!< time range of the root node
+      bool built;                    //!< true if the BVH got built for the recorded mesh states
     };
   }
 }
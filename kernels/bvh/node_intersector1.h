@@ -385,6 +385,23 @@ namespace embree
       return mask;
     }
 
+#endif
+
+#if defined(EMBREE_RAY_MASK)
+
+    //////////////////////////////////////////////////////////////////////////////////////
+    // AlignedNode ray mask culling
+    //////////////////////////////////////////////////////////////////////////////////////
+
+    /*! Returns the children whose subtree contains geometry visible to the ray mask. */
+    template<int N, int types>
+      __forceinline size_t maskNode(const typename BVHN<N>::NodeRef& node, unsigned int mask)
+    {
+      if (!(types & BVH_FLAG_ALIGNED_NODE) || !node.isAlignedNode()) return size_t(-1);
+      const vint<N> m = node.alignedNode()->mask & vint<N>(mask);
+      return movemask(m != vint<N>(zero));
+    }
+
 #endif
 
     //////////////////////////////////////////////////////////////////////////////////////
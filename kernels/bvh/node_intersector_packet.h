@@ -196,6 +196,22 @@ namespace embree
       return lhit;
     }
 
+#if defined(EMBREE_RAY_MASK)
+
+    //////////////////////////////////////////////////////////////////////////////////////
+    // AlignedNode ray mask culling
+    //////////////////////////////////////////////////////////////////////////////////////
+
+    /*! Returns the rays whose mask intersects the subtree mask of the i'th child. */
+    template<int N, int K, int types>
+      __forceinline vbool<K> maskNodeK(const typename BVHN<N>::NodeRef& node, size_t i, const vint<K>& mask)
+    {
+      if (!(types & BVH_FLAG_ALIGNED_NODE) || !node.isAlignedNode()) return vbool<K>(true);
+      return (vint<K>(node.alignedNode()->mask[i]) & mask) != vint<K>(zero);
+    }
+
+#endif
+
     //////////////////////////////////////////////////////////////////////////////////////
     // Fast AlignedNodeMB intersection
     //////////////////////////////////////////////////////////////////////////////////////
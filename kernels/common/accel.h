@@ -37,6 +37,12 @@ namespace embree
 
     /*! notifies the acceleration structure about the deletion of some geometry */
     virtual void deleteGeometry(size_t geomID) {};
+
+    /*! reorders the geometry data to match the leaf order */
+    virtual void reorderVertices() {};
+
+    /*! updates the geometry masks stored in the hierarchy */
+    virtual void updateMasks() {};
    
     /*! clears the acceleration structure data */
     virtual void clear() = 0;
@@ -271,6 +277,14 @@ namespace embree
 	}        
       }
 
+      /*! opaque contexts never invoke filter functions and can use the kernels compiled without filter support */
+      template<typename Intersector>
+      __forceinline const Intersector& select(const Intersector& intersector, const Intersector& intersector_nofilter, IntersectContext* context) const
+      {
+        if (unlikely(context->isOpaque()) && intersector_nofilter) return intersector_nofilter;
+        return intersector;
+      }
+
       /*! Intersects a single ray with the scene. */
       __forceinline void intersect (RTCRayHit& ray, IntersectContext* context) {
         assert(intersector1.intersect);
@@ -280,26 +294,26 @@ namespace embree
       /*! Intersects a packet of 4 rays with the scene. */
       __forceinline void intersect4 (const void* valid, RTCRayHit4& ray, IntersectContext* context) {
         assert(intersector4.intersect);
-        intersector4.intersect(valid,this,ray,context);
+        select(intersector4,intersector4_nofilter,context).intersect(valid,this,ray,context);
       }
       
       /*! Intersects a packet of 8 rays with the scene. */
       __forceinline void intersect8 (const void* valid, RTCRayHit8& ray, IntersectContext* context) {
         assert(intersector8.intersect);
-        intersector8.intersect(valid,this,ray,context);
+        select(intersector8,intersector8_nofilter,context).intersect(valid,this,ray,context);
       }
       
       /*! Intersects a packet of 16 rays with the scene. */
       __forceinline void intersect16 (const void* valid, RTCRayHit16& ray, IntersectContext* context) {
         assert(intersector16.intersect);
-        intersector16.intersect(valid,this,ray,context);
+        select(intersector16,intersector16_nofilter,context).intersect(valid,this,ray,context);
       }
       
       /*! Intersects a stream of N rays in SOA layout with the scene. */
       __forceinline void intersectN (RTCRayHitN** rayN, const size_t N, IntersectContext* context)
       {
         assert(intersectorN.intersect);
-        intersectorN.intersect(this,rayN,N,context);
+        select(intersectorN,intersectorN_nofilter,context).intersect(this,rayN,N,context);
       }
       
 #if defined(__SSE__)
@@ -336,26 +350,26 @@ namespace embree
       /*! Tests if a packet of 4 rays is occluded by the scene. */
       __forceinline void occluded4 (const void* valid, RTCRay4& ray, IntersectContext* context) {
         assert(intersector4.occluded);
-        intersector4.occluded(valid,this,ray,context);
+        select(intersector4,intersector4_nofilter,context).occluded(valid,this,ray,context);
       }
       
       /*! Tests if a packet of 8 rays is occluded by the scene. */
       __forceinline void occluded8 (const void* valid, RTCRay8& ray, IntersectContext* context) {
         assert(intersector8.occluded);
-        intersector8.occluded(valid,this,ray,context);
+        select(intersector8,intersector8_nofilter,context).occluded(valid,this,ray,context);
       }
       
       /*! Tests if a packet of 16 rays is occluded by the scene. */
       __forceinline void occluded16 (const void* valid, RTCRay16& ray, IntersectContext* context) {
         assert(intersector16.occluded);
-        intersector16.occluded(valid,this,ray,context);
+        select(intersector16,intersector16_nofilter,context).occluded(valid,this,ray,context);
       }
       
       /*! Tests if a stream of N rays in SOA layout is occluded by the scene. */
       __forceinline void occludedN (RTCRayN** rayN, const size_t N, IntersectContext* context)
       {
         assert(intersectorN.occluded);
-        intersectorN.occluded(this,rayN,N,context);
+        select(intersectorN,intersectorN_nofilter,context).occluded(this,rayN,N,context);
       }
       
 #if defined(__SSE__)
@@ -433,6 +447,12 @@ namespace embree
 
     /*! makes the acceleration structure immutable */
     virtual void immutable () {}
+
+    /*! reorders the geometry data to match the leaf order */
+    virtual void reorderVertices () {}
+
+    /*! updates the geometry masks stored in the hierarchy */
+    virtual void updateMasks () {}
     
     /*! build acceleration structure */
     virtual void build () = 0;
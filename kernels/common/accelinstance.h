@@ -31,6 +31,14 @@ namespace embree
       builder.reset(nullptr);
     }
 
+    void reorderVertices () {
+      if (accel) accel->reorderVertices();
+    }
+
+    void updateMasks () {
+      if (accel) accel->updateMasks();
+    }
+
   public:
     void build () {
       if (builder) builder->build();
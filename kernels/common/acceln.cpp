@@ -169,6 +169,18 @@ namespace embree
       accels[i]->immutable();
   }
   
+  void AccelN::accels_reorderVertices ()
+  {
+    for (size_t i=0; i<accels.size(); i++)
+      accels[i]->reorderVertices();
+  }
+
+  void AccelN::accels_updateMasks ()
+  {
+    for (size_t i=0; i<accels.size(); i++)
+      accels[i]->updateMasks();
+  }
+  
   void AccelN::accels_build () 
   {
     /* reduce memory consumption */
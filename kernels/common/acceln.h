@@ -49,6 +49,8 @@ namespace embree
     void accels_print(size_t ident);
     void accels_immutable();
     void accels_build ();
+    void accels_reorderVertices ();
+    void accels_updateMasks ();
     void accels_select(bool filter);
     void accels_deleteGeometry(size_t geomID);
     void accels_clear ();
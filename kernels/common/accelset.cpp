@@ -20,7 +20,7 @@
 namespace embree
 {
   AccelSet::AccelSet (Device* device, Geometry::GType gtype, size_t numItems, size_t numTimeSteps) 
-    : Geometry(device,gtype,(unsigned int)numItems,(unsigned int)numTimeSteps), boundsFunc(nullptr) {}
+    : Geometry(device,gtype,(unsigned int)numItems,(unsigned int)numTimeSteps), boundsFunc(nullptr), batchSize(1) {}
 
   AccelSet::IntersectorN::IntersectorN (ErrorFunc error) 
     : intersect((IntersectFuncN)error), occluded((OccludedFuncN)error), name(nullptr) {}
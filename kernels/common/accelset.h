@@ -52,6 +52,9 @@ namespace embree
     typedef RTCOccludedFunctionN OccludedFuncN;
     typedef void (*ErrorFunc) ();
 
+    /*! maximal number of primitives of a batch, batches never exceed a BVH leaf */
+    static const size_t maxBatchSize = 8;
+
       struct IntersectorN
       {
         IntersectorN (ErrorFunc error = nullptr) ;
@@ -156,6 +159,14 @@ namespace embree
       __forceinline void intersect (RayHit& ray, size_t primID, IntersectContext* context, ReportIntersectionFunc report) 
       {
         assert(primID < size());
+        const unsigned int primIDs[1] = { (unsigned int)primID };
+        intersect(ray,primIDs,1,context,report);
+      }
+
+      /*! Intersects a single ray with a batch of primitives of the scene. */
+      __forceinline void intersect (RayHit& ray, const unsigned int* primIDs, size_t num, IntersectContext* context, ReportIntersectionFunc report) 
+      {
+        assert(num <= batchSize);
         assert(intersectorN.intersect);
         
         int mask = -1;
@@ -165,7 +176,9 @@ namespace embree
         args.context = context->user;
         args.rayhit = (RTCRayHitN*)&ray;
         args.N = 1;
-        args.primID = (unsigned int)primID;
+        args.primID = primIDs[0];
+        args.primIDs = primIDs;
+        args.primCount = (unsigned int)num;
         args.internal_context = context;
         args.geometry = this;
         args.report = report;
@@ -177,6 +190,14 @@ namespace embree
       __forceinline void occluded (Ray& ray, size_t primID, IntersectContext* context, ReportOcclusionFunc report)
       {
         assert(primID < size());
+        const unsigned int primIDs[1] = { (unsigned int)primID };
+        occluded(ray,primIDs,1,context,report);
+      }
+
+      /*! Tests if single ray is occluded by a batch of primitives of the scene. */
+      __forceinline void occluded (Ray& ray, const unsigned int* primIDs, size_t num, IntersectContext* context, ReportOcclusionFunc report)
+      {
+        assert(num <= batchSize);
         assert(intersectorN.occluded);
         
         int mask = -1;
@@ -186,7 +207,9 @@ namespace embree
         args.context = context->user;
         args.ray = (RTCRayN*)&ray;
         args.N = 1;
-        args.primID = (unsigned int)primID;
+        args.primID = primIDs[0];
+        args.primIDs = primIDs;
+        args.primCount = (unsigned int)num;
         args.internal_context = context;
         args.geometry = this;
         args.report = report;
@@ -199,6 +222,15 @@ namespace embree
         __forceinline void intersect (const vbool<K>& valid, RayHitK<K>& ray, size_t primID, IntersectContext* context, ReportIntersectionFunc report) 
       {
         assert(primID < size());
+        const unsigned int primIDs[1] = { (unsigned int)primID };
+        intersect(valid,ray,primIDs,1,context,report);
+      }
+
+      /*! Intersects a packet of K rays with a batch of primitives of the scene. */
+      template<int K>
+        __forceinline void intersect (const vbool<K>& valid, RayHitK<K>& ray, const unsigned int* primIDs, size_t num, IntersectContext* context, ReportIntersectionFunc report) 
+      {
+        assert(num <= batchSize);
         assert(intersectorN.intersect);
         
         vint<K> mask = valid.mask32();
@@ -208,7 +240,9 @@ namespace embree
         args.context = context->user;
         args.rayhit = (RTCRayHitN*)&ray;
         args.N = K;
-        args.primID = (unsigned int)primID;
+        args.primID = primIDs[0];
+        args.primIDs = primIDs;
+        args.primCount = (unsigned int)num;
         args.internal_context = context;
         args.geometry = this;
         args.report = report;
@@ -221,6 +255,15 @@ namespace embree
         __forceinline void occluded (const vbool<K>& valid, RayK<K>& ray, size_t primID, IntersectContext* context, ReportOcclusionFunc report)
       {
         assert(primID < size());
+        const unsigned int primIDs[1] = { (unsigned int)primID };
+        occluded(valid,ray,primIDs,1,context,report);
+      }
+
+      /*! Tests if a packet of K rays is occluded by a batch of primitives of the scene. */
+      template<int K>
+        __forceinline void occluded (const vbool<K>& valid, RayK<K>& ray, const unsigned int* primIDs, size_t num, IntersectContext* context, ReportOcclusionFunc report)
+      {
+        assert(num <= batchSize);
         assert(intersectorN.occluded);
         
         vint<K> mask = valid.mask32();
@@ -230,7 +273,9 @@ namespace embree
         args.context = context->user;
         args.ray = (RTCRayN*)&ray;
         args.N = K;
-        args.primID = (unsigned int)primID;
+        args.primID = primIDs[0];
+        args.primIDs = primIDs;
+        args.primCount = (unsigned int)num;
         args.internal_context = context;
         args.geometry = this;
         args.report = report;
@@ -241,6 +286,7 @@ namespace embree
     public:
       RTCBoundsFunction boundsFunc;
       IntersectorN intersectorN;
+      unsigned int batchSize; //!< maximal number of primitives passed to a single intersect or occluded call
   };
   
 #define DEFINE_SET_INTERSECTORN(symbol,intersector)                     \
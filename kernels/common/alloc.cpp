@@ -22,6 +22,50 @@ namespace embree
   __thread FastAllocator::ThreadLocal2* FastAllocator::thread_local_allocator2 = nullptr;
   SpinLock FastAllocator::s_thread_local_allocators_lock;
   std::vector<std::unique_ptr<FastAllocator::ThreadLocal2>> FastAllocator::s_thread_local_allocators;
+
+  void* BlockPool::take(bool os_malloced, size_t minBytes, size_t maxBytes, size_t& bytes_o, bool& huge_pages_o)
+  {
+    Lock<SpinLock> lock(mutex);
+
+    /* find smallest matching block */
+    size_t best = -1;
+    for (size_t i=0; i<entries.size(); i++)
+    {
+      const Entry& e = entries[i];
+      if (e.os_malloced != os_malloced || e.bytes < minBytes || e.bytes > maxBytes) continue;
+      if (best == size_t(-1) || e.bytes < entries[best].bytes) best = i;
+    }
+    if (best == size_t(-1)) return nullptr;
+
+    const Entry e = entries[best];
+    entries[best] = entries.back();
+    entries.pop_back();
+    bytes -= e.bytes;
+    bytes_o = e.bytes;
+    huge_pages_o = e.huge_pages;
+    return e.ptr;
+  }
+
+  bool BlockPool::give(void* ptr, bool os_malloced, size_t bytes_i, bool huge_pages)
+  {
+    Lock<SpinLock> lock(mutex);
+    if (bytes+bytes_i > maxBytes) return false;
+    Entry e; e.ptr = ptr; e.bytes = bytes_i; e.os_malloced = os_malloced; e.huge_pages = huge_pages;
+    entries.push_back(e);
+    bytes += bytes_i;
+    return true;
+  }
+
+  void BlockPool::clear()
+  {
+    Lock<SpinLock> lock(mutex);
+    for (const Entry& e : entries) {
+      if (e.os_malloced) os_free(e.ptr,e.bytes,e.huge_pages);
+      else               device->freeMemory(e.ptr,e.bytes,RTC_ALLOCATION_CATEGORY_BVH);
+    }
+    entries.clear();
+    bytes = 0;
+  }
    
   struct fast_allocator_regression_test : public RegressionTest
   {
@@ -23,6 +23,54 @@
 
 namespace embree
 {
+  /*! Device wide pool of freed allocation blocks. Allocators return
+   *  their blocks to the pool instead of freeing them and take blocks
+   *  from the pool before allocating new ones, thus new scenes and
+   *  rebuilds reuse memory that is already mapped and faulted in. */
+  class BlockPool
+  {
+  public:
+
+    BlockPool (Device* device, size_t maxBytes, bool huge_pages)
+      : huge_pages(huge_pages), device(device), maxBytes(maxBytes), bytes(0) {}
+
+    ~BlockPool () {
+      clear();
+    }
+
+    /*! takes the smallest pooled block of the specified allocation type that has between minBytes and maxBytes bytes */
+    void* take(bool os_malloced, size_t minBytes, size_t maxBytes, size_t& bytes_o, bool& huge_pages_o);
+
+    /*! returns a block to the pool, fails if the pool would exceed its retention limit */
+    bool give(void* ptr, bool os_malloced, size_t bytes, bool huge_pages);
+
+    /*! frees all pooled blocks */
+    void clear();
+
+    /*! returns the number of bytes retained by the pool */
+    size_t getRetainedBytes() const {
+      return bytes;
+    }
+
+  public:
+    const bool huge_pages;        //!< new blocks get allocated with huge pages
+    
+  private:
+    struct Entry
+    {
+      void* ptr;
+      size_t bytes;
+      bool os_malloced;
+      bool huge_pages;
+    };
+
+    SpinLock mutex;
+    Device* device;               //!< device that allocated the blocks
+    std::vector<Entry> entries;   //!< pooled blocks
+    const size_t maxBytes;        //!< retention limit of the pool
+    size_t bytes;                 //!< bytes of all pooled blocks
+  };
+
   class FastAllocator
   {
     /*! maximum supported alignment */
@@ -719,12 +767,20 @@ namespace embree
 
     struct Block
     {
-      static Block* create(MemoryMonitorInterface* device, size_t bytesAllocate, size_t bytesReserve, Block* next, AllocationType atype)
+      static Block* create(Device* device, size_t bytesAllocate, size_t bytesReserve, Block* next, AllocationType atype)
       {
+        BlockPool* pool = device ? device->blockPool.get() : nullptr;
+
         /* We avoid using os_malloc for small blocks as this could
          * cause a risk of fragmenting the virtual address space and
-         * reach the limit of vm.max_map_count = 65k under Linux. */
-        if (atype == OS_MALLOC && bytesAllocate < maxAllocationSize)
+         * reach the limit of vm.max_map_count = 65k under Linux. Blocks
+         * of a huge page pool get mapped only once and then reused. An
+         * application allocator always provides the memory. */
+        if (device && device->hasAllocator())
+          atype = ALIGNED_MALLOC;
+        else if (pool && pool->huge_pages)
+          atype = OS_MALLOC;
+        else if (atype == OS_MALLOC && bytesAllocate < maxAllocationSize)
           atype = ALIGNED_MALLOC;
 
         /* we need to additionally allocate some header */
@@ -738,6 +794,32 @@ namespace embree
           bytesReserve  = ((bytesReserve +PAGE_SIZE-1) & ~(PAGE_SIZE-1));
         }
 
+        /* reserve full 2MB pages for huge page pools */
+        if (pool && pool->huge_pages && atype == OS_MALLOC)
+          bytesReserve = ((max(bytesAllocate,bytesReserve)+PAGE_SIZE_2M-1) & ~(PAGE_SIZE_2M-1));
+
+        /* try to reuse a pooled block first */
+        if (pool)
+        {
+          const size_t bytesRequired = atype == OS_MALLOC ? bytesReserve : bytesAllocate;
+          size_t bytesPooled = 0; bool huge_pages = false;
+          void* ptr = pool->take(atype == OS_MALLOC,bytesRequired,2*bytesRequired,bytesPooled,huge_pages);
+          if (ptr)
+          {
+            const size_t bytesMonitored = atype == OS_MALLOC ? bytesAllocate : bytesPooled+maxAlignment;
+            try {
+              device->memoryMonitor(bytesMonitored,false);
+            } catch (...) {
+              if (!pool->give(ptr,atype == OS_MALLOC,bytesPooled,huge_pages)) free_block(device,ptr,atype,bytesPooled,huge_pages);
+              throw;
+            }
+            if (atype == OS_MALLOC)
+              return new (ptr) Block(OS_MALLOC,bytesAllocate-sizeof_Header,bytesPooled-sizeof_Header,next,0,huge_pages);
+            else
+              return new (ptr) Block(ALIGNED_MALLOC,bytesPooled-sizeof_Header,bytesPooled-sizeof_Header,next,maxAlignment);
+          }
+        }
+
         /* either use alignedMalloc or os_malloc */
         void *ptr = nullptr;
         if (atype == ALIGNED_MALLOC)
@@ -747,7 +829,7 @@ namespace embree
           {
             const size_t alignment = maxAlignment;
             if (device) device->memoryMonitor(bytesAllocate+alignment,false);
-            ptr = alignedMalloc(bytesAllocate,alignment);
+            ptr = alloc_block(device,bytesAllocate,alignment);
 
             /* give hint to transparently convert these pages to 2MB pages */
             const size_t ptr_aligned_begin = ((size_t)ptr) & ~size_t(PAGE_SIZE_2M-1);
@@ -761,7 +843,7 @@ namespace embree
           {
             const size_t alignment = maxAlignment;
             if (device) device->memoryMonitor(bytesAllocate+alignment,false);
-            ptr = alignedMalloc(bytesAllocate,alignment);
+            ptr = alloc_block(device,bytesAllocate,alignment);
             return new (ptr) Block(ALIGNED_MALLOC,bytesAllocate-sizeof_Header,bytesAllocate-sizeof_Header,next,alignment);
           }
         }
@@ -793,7 +875,7 @@ namespace embree
         return head;
       }
 
-      void clear_list(MemoryMonitorInterface* device)
+      void clear_list(Device* device)
       {
         Block* block = this;
         while (block) {
@@ -803,24 +885,37 @@ namespace embree
         }
       }
 
-      void clear_block (MemoryMonitorInterface* device)
+      void clear_block (Device* device)
       {
         const size_t sizeof_Header = offsetof(Block,data[0]);
         const ssize_t sizeof_Alloced = wasted+sizeof_Header+getBlockAllocatedBytes();
+        BlockPool* pool = device ? device->blockPool.get() : nullptr;
 
-        if (atype == ALIGNED_MALLOC) {
-          alignedFree(this);
+        if (atype == ALIGNED_MALLOC || atype == OS_MALLOC) {
+          const size_t sizeof_This = sizeof_Header+reserveEnd;
+          if (!pool || !pool->give(this,atype == OS_MALLOC,sizeof_This,huge_pages))
+            free_block(device,this,atype,sizeof_This,huge_pages);
           if (device) device->memoryMonitor(-sizeof_Alloced,true);
         }
 
-        else if (atype == OS_MALLOC) {
-         size_t sizeof_This = sizeof_Header+reserveEnd;
-         os_free(this,sizeof_This,huge_pages);
-         if (device) device->memoryMonitor(-sizeof_Alloced,true);
+        else /* if (atype == SHARED) */ {
         }
+      }
 
-        else /* if (atype == SHARED) */ {
+      static void* alloc_block(Device* device, size_t bytes, size_t align)
+      {
+        if (device) return device->allocMemory(bytes,align,RTC_ALLOCATION_CATEGORY_BVH);
+        else        return alignedMalloc(bytes,align);
+      }
+
+      static void free_block(Device* device, void* ptr, AllocationType atype, size_t bytes, bool huge_pages)
+      {
+        if (atype == ALIGNED_MALLOC) {
+          if (device) device->freeMemory(ptr,bytes,RTC_ALLOCATION_CATEGORY_BVH);
+          else        alignedFree(ptr);
         }
+        else
+          os_free(ptr,bytes,huge_pages);
       }
 
       void* malloc(MemoryMonitorInterface* device, size_t& bytes_in, size_t align, bool partial)
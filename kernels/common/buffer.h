@@ -27,11 +27,11 @@ namespace embree
   public:
     /*! Buffer construction */
     Buffer() 
-      : device(nullptr), ptr(nullptr), numBytes(0), shared(false) {}
+      : device(nullptr), ptr(nullptr), numBytes(0), shared(false), mapped(nullptr), mappedBytes(0) {}
 
     /*! Buffer construction */
     Buffer(Device* device, size_t numBytes_in, void* ptr_in = nullptr)
-      : device(device), numBytes(numBytes_in)
+      : device(device), numBytes(numBytes_in), mapped(nullptr), mappedBytes(0)
     {
       device->refInc();
       
@@ -47,6 +47,16 @@ namespace embree
       }
     }
     
+    /*! Buffer construction from a file region that gets mapped read-only */
+    Buffer(Device* device, const char* fileName, size_t offset, size_t numBytes_in)
+      : device(device), numBytes(numBytes_in), shared(true), mapped(nullptr), mappedBytes(0)
+    {
+      ptr = (char*) os_map_file(fileName,offset,numBytes,mapped,mappedBytes);
+      if (!ptr)
+        throw_RTCError(RTC_ERROR_INVALID_ARGUMENT,"cannot map file region");
+      device->refInc();
+    }
+
     /*! Buffer destruction */
     ~Buffer() {
       free();
@@ -90,19 +100,26 @@ namespace embree
     /*! allocated buffer */
     void alloc()
     {
-      if (device)
-        device->memoryMonitor(this->bytes(), false);
+      assert(device);
+      device->memoryMonitor(this->bytes(), false);
       size_t b = (this->bytes()+15) & ssize_t(-16);
-      ptr = (char*)alignedMalloc(b,16);
+      ptr = (char*)device->allocMemory(b,16,RTC_ALLOCATION_CATEGORY_BUFFER);
     }
     
     /*! frees the buffer */
     void free()
     {
+      if (mapped) {
+        os_unmap_file(mapped,mappedBytes);
+        mapped = nullptr;
+        ptr = nullptr;
+      }
       if (shared) return;
-      alignedFree(ptr); 
-      if (device)
+      if (device) {
+        size_t b = (this->bytes()+15) & ssize_t(-16);
+        device->freeMemory(ptr,b,RTC_ALLOCATION_CATEGORY_BUFFER);
         device->memoryMonitor(-ssize_t(this->bytes()), true);
+      }
       ptr = nullptr;
     }
     
@@ -132,11 +149,20 @@ namespace embree
       return ptr; 
     }
 
+    /*! hints the expected access pattern of mapped buffers */
+    void advise(OSAccessPattern pattern) const
+    {
+      if (mapped)
+        os_advise_access(ptr,numBytes,pattern);
+    }
+
   public:
     Device* device;  //!< device to report memory usage to
     char* ptr;       //!< pointer to buffer data
     size_t numBytes; //!< number of bytes in the buffer
     bool shared;     //!< set if memory is shared with application
+    void* mapped;    //!< base of the file mapping, or nullptr if not mapped
+    size_t mappedBytes; //!< number of bytes of the file mapping
   };
 
   /*! An untyped contiguous range of a buffer. This class does not own the buffer content. */
@@ -211,6 +237,13 @@ namespace embree
       return ptr_ofs; 
     }
 
+    /*! hints the expected access pattern if the buffer is mapped from a file */
+    __forceinline void advise(OSAccessPattern pattern) const
+    {
+      if (buffer)
+        buffer->advise(pattern);
+    }
+
     /*! checks padding to 16 byte check, fails hard */
     __forceinline void checkPadding16() const
     {
@@ -260,4 +293,79 @@ namespace embree
       vfloat4::storeu((float*)(ptr_ofs + i*stride), (vfloat4)v);
     }
   };
+
+  /*! Sorted and merged ranges of buffer items that got modified since
+   *  the last commit. Tracking stops when the entire buffer got
+   *  modified or when the ranges get too fragmented. */
+  class ModifiedRanges
+  {
+    static const size_t MAX_RANGES = 4096;
+    
+  public:
+    ModifiedRanges ()
+      : partial(false) {}
+
+    /*! marks the entire buffer as modified */
+    __forceinline void setAll() 
+    {
+      partial = false;
+      ranges.clear();
+    }
+
+    /*! starts tracking with no item modified */
+    __forceinline void reset() 
+    {
+      partial = true;
+      ranges.clear();
+    }
+
+    /*! adds the items [first,first+count) as modified */
+    void add(unsigned int first, unsigned int count)
+    {
+      if (!partial || count == 0) return;
+
+      /* merge all ranges overlapping or touching the new range */
+      range<unsigned int> r(first,first+count);
+      auto begin = std::lower_bound(ranges.begin(),ranges.end(),r,[] (const range<unsigned int>& a, const range<unsigned int>& b) { return a.end() < b.begin(); });
+      auto end = begin;
+      while (end != ranges.end() && end->begin() <= r.end()) {
+        r = range<unsigned int>(min(r.begin(),end->begin()),max(r.end(),end->end()));
+        end++;
+      }
+      begin = ranges.erase(begin,end);
+      ranges.insert(begin,r);
+      
+      if (ranges.size() > MAX_RANGES) 
+        setAll();
+    }
+
+    /*! returns true if only the items of the ranges got modified */
+    __forceinline bool isPartial() const {
+      return partial;
+    }
+
+    /*! returns the number of modified items */
+    size_t numItems() const 
+    {
+      size_t n = 0;
+      for (const auto& r : ranges) n += r.size();
+      return n;
+    }
+
+    /*! checks if the i'th item got modified */
+    __forceinline bool contains(unsigned int i) const
+    {
+      auto r = std::upper_bound(ranges.begin(),ranges.end(),i,[] (unsigned int i, const range<unsigned int>& r) { return i < r.end(); });
+      return r != ranges.end() && r->begin() <= i;
+    }
+
+    /*! access to the ranges */
+    __forceinline const std::vector<range<unsigned int>>& get() const {
+      return ranges;
+    }
+    
+  private:
+    std::vector<range<unsigned int>> ranges; //!< sorted non-overlapping ranges of modified items
+    bool partial;                            //!< true if only the items of the ranges got modified
+  };
 }
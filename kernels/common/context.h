@@ -40,7 +40,32 @@ namespace embree
     __forceinline bool isIncoherent() const {
       return embree::isIncoherent(user->flags);
     }
-    
+
+    __forceinline bool hasFaceCulling() const {
+      return user->flags & (RTC_INTERSECT_CONTEXT_FLAG_CULL_BACKFACES | RTC_INTERSECT_CONTEXT_FLAG_CULL_FRONTFACES);
+    }
+
+    __forceinline bool cullBackFaces() const {
+      return user->flags & RTC_INTERSECT_CONTEXT_FLAG_CULL_BACKFACES;
+    }
+
+    __forceinline bool cullFrontFaces() const {
+      return user->flags & RTC_INTERSECT_CONTEXT_FLAG_CULL_FRONTFACES;
+    }
+
+    __forceinline bool isOpaque() const {
+      return user->flags & RTC_INTERSECT_CONTEXT_FLAG_OPAQUE;
+    }
+
+    __forceinline bool terminateOnFirstHit() const {
+      return user->flags & RTC_INTERSECT_CONTEXT_FLAG_TERMINATE_ON_FIRST_HIT;
+    }
+
+    /* tests if a primitive of the current instance is the one the context asks to ignore */
+    __forceinline bool isIgnored(const unsigned int geomID, const unsigned int primID) const {
+      return geomID == user->ignoreGeomID && primID == user->ignorePrimID && instID == user->ignoreInstID;
+    }
+
   public:
     Scene* scene;
     RTCIntersectContext* user;
@@ -25,6 +25,7 @@
 #include "../subdiv/tessellation_cache.h"
 
 #include "acceln.h"
+#include "alloc.h"
 #include "geometry.h"
 
 #include "../geometry/cylinder.h"
@@ -72,6 +73,11 @@ namespace embree
       State::hugepages_success &= win_enable_selockmemoryprivilege(State::verbosity(3));
 #endif
     State::hugepages_success &= os_init(State::hugepages,State::verbosity(3));
+
+    /*! create pool that recycles allocation blocks across scenes and rebuilds */
+    numAllocations = 0;
+    if (State::block_pool_size)
+      blockPool = make_unique(new BlockPool(this,State::block_pool_size,State::block_pool_huge_pages));
     
     /*! set tessellation cache size */
     setCacheSize( State::tessellation_cache_size );
@@ -103,6 +109,7 @@ namespace embree
 #endif
 
     /* setup tasking system */
+    spawn_tasks_function_set = false;
     initTaskingSystem(numThreads);
 
     /* ray stream SOA to AOS conversion */
@@ -294,6 +301,41 @@ namespace embree
     }
   }
 
+  bool Device::hasAllocator() const {
+    return State::alloc_function != nullptr;
+  }
+
+  void* Device::allocMemory(size_t bytes, size_t align, RTCAllocationCategory category)
+  {
+    void* ptr = nullptr;
+    if (State::alloc_function) {
+      ptr = State::alloc_function(State::alloc_userptr,bytes,align,category);
+      if (ptr == nullptr && bytes != 0)
+        throw_RTCError(RTC_ERROR_OUT_OF_MEMORY,"application allocator failed");
+    }
+    else if (category == RTC_ALLOCATION_CATEGORY_PRIMREFS && bytes >= 14*PAGE_SIZE_2M) {
+      /* large builder arrays get mapped directly, full 2MB pages make freeing independent of the page size */
+      bool hugepages = false;
+      ptr = os_malloc((bytes+PAGE_SIZE_2M-1) & ~(PAGE_SIZE_2M-1),hugepages);
+    }
+    else
+      ptr = alignedMalloc(bytes,align);
+    if (ptr) numAllocations++;
+    return ptr;
+  }
+
+  void Device::freeMemory(void* ptr, size_t bytes, RTCAllocationCategory category)
+  {
+    if (ptr == nullptr) return;
+    if (State::free_function)
+      State::free_function(State::alloc_userptr,ptr,bytes,category);
+    else if (category == RTC_ALLOCATION_CATEGORY_PRIMREFS && bytes >= 14*PAGE_SIZE_2M)
+      os_free(ptr,(bytes+PAGE_SIZE_2M-1) & ~(PAGE_SIZE_2M-1),false);
+    else
+      alignedFree(ptr);
+    numAllocations--;
+  }
+
   size_t getMaxNumThreads()
   {
     size_t maxNumThreads = 0;
@@ -311,6 +353,20 @@ namespace embree
       maxCacheSize = max(maxCacheSize, (*i).second);
     return maxCacheSize;
   }
+
+  /* the cache gets allocated through the allocator of a device that requests the largest cache */
+  void updateTessellationCache()
+  {
+    size_t maxCacheSize = getMaxCacheSize();
+    for (std::map<Device*,size_t>::iterator i=g_cache_size_map.begin(); i!= g_cache_size_map.end(); i++) {
+      Device* device = (*i).first;
+      if ((*i).second == maxCacheSize && device->hasAllocator()) {
+        resizeTessellationCache(maxCacheSize,device->alloc_function,device->free_function,device->alloc_userptr);
+        return;
+      }
+    }
+    resizeTessellationCache(maxCacheSize,nullptr,nullptr,nullptr);
+  }
  
   void Device::setCacheSize(size_t bytes) 
   {
@@ -318,9 +374,29 @@ namespace embree
     Lock<MutexSys> lock(g_mutex);
     if (bytes == 0) g_cache_size_map.erase(this);
     else            g_cache_size_map[this] = bytes;
+    updateTessellationCache();
+#endif
+  }
+
+  void Device::setAllocator(RTCAllocFunction alloc, RTCFreeFunction free, void* userPtr)
+  {
+    if ((alloc == nullptr) != (free == nullptr))
+      throw_RTCError(RTC_ERROR_INVALID_ARGUMENT,"allocation and free function have to get specified together");
+
+    /* memory of the pool was allocated with the previous allocator */
+    if (blockPool) blockPool->clear();
     
-    size_t maxCacheSize = getMaxCacheSize();
-    resizeTessellationCache(maxCacheSize);
+    if (numAllocations != 0)
+      throw_RTCError(RTC_ERROR_INVALID_OPERATION,"allocator can only get changed when the device holds no memory");
+
+    State::alloc_function = alloc;
+    State::free_function = free;
+    State::alloc_userptr = userPtr;
+
+    /* move tessellation cache to the new allocator */
+#if defined(EMBREE_GEOMETRY_SUBDIVISION)
+    Lock<MutexSys> lock(g_mutex);
+    updateTessellationCache();
 #endif
   }
 
@@ -334,7 +410,7 @@ namespace embree
 
     /* create task scheduler */
     size_t maxNumThreads = getMaxNumThreads();
-    TaskScheduler::create(maxNumThreads,State::set_affinity,State::start_threads);
+    TaskScheduler::create(maxNumThreads,State::set_affinity,State::start_threads,State::numa_aware,1E-6*double(State::idle_spin_time));
 #if USE_TASK_ARENA
     arena = make_unique(new tbb::task_arena((int)min(maxNumThreads,TaskScheduler::threadCount())));
 #endif
@@ -345,6 +421,12 @@ namespace embree
     Lock<MutexSys> lock(g_mutex);
     g_num_threads_map.erase(this);
 
+#if defined(TASKING_INTERNAL)
+    /* the application threads of this device can no longer be used */
+    if (spawn_tasks_function_set)
+      TaskScheduler::setSpawnTasksFunction(nullptr,nullptr);
+#endif
+
     /* terminate tasking system */
     if (g_num_threads_map.size() == 0) {
       TaskScheduler::destroy();
@@ -352,13 +434,24 @@ namespace embree
     /* or configure new number of threads */
     else {
       size_t maxNumThreads = getMaxNumThreads();
-      TaskScheduler::create(maxNumThreads,State::set_affinity,State::start_threads);
+      TaskScheduler::create(maxNumThreads,State::set_affinity,State::start_threads,State::numa_aware,1E-6*double(State::idle_spin_time));
     }
 #if USE_TASK_ARENA
     arena.reset();
 #endif
   }
 
+  void Device::setSpawnTasksFunction(RTCSpawnTasksFunction spawnTasks, void* userPtr)
+  {
+#if defined(TASKING_INTERNAL)
+    Lock<MutexSys> lock(g_mutex);
+    TaskScheduler::setSpawnTasksFunction((TaskScheduler::SpawnTasksFunction)spawnTasks,userPtr);
+    spawn_tasks_function_set = spawnTasks != nullptr;
+#else
+    throw_RTCError(RTC_ERROR_INVALID_OPERATION,"spawn tasks function only supported with internal tasking system");
+#endif
+  }
+
   void Device::setProperty(const RTCDeviceProperty prop, ssize_t val)
   {
     /* hidden internal properties */
@@ -505,6 +598,26 @@ namespace embree
     case RTC_DEVICE_PROPERTY_JOIN_COMMIT_SUPPORTED: return 1;
 #endif
 
+#if defined(TASKING_INTERNAL)
+    case RTC_DEVICE_PROPERTY_SPAWN_TASKS_FUNCTION_SUPPORTED: return 1;
+#else
+    case RTC_DEVICE_PROPERTY_SPAWN_TASKS_FUNCTION_SUPPORTED: return 0;
+#endif
+
+#if defined(TASKING_INTERNAL)
+    case RTC_DEVICE_PROPERTY_TASKING_WORK_TIME: return ssize_t(1E6*TaskScheduler::getThreadStatistics().workTime);
+    case RTC_DEVICE_PROPERTY_TASKING_SPIN_TIME: return ssize_t(1E6*TaskScheduler::getThreadStatistics().spinTime);
+    case RTC_DEVICE_PROPERTY_TASKING_PARK_TIME: return ssize_t(1E6*TaskScheduler::getThreadStatistics().parkTime);
+#else
+    case RTC_DEVICE_PROPERTY_TASKING_WORK_TIME: return 0;
+    case RTC_DEVICE_PROPERTY_TASKING_SPIN_TIME: return 0;
+    case RTC_DEVICE_PROPERTY_TASKING_PARK_TIME: return 0;
+#endif
+
+    case RTC_DEVICE_PROPERTY_TESSELLATION_CACHE_HITS:      return getTessellationCacheHits();
+    case RTC_DEVICE_PROPERTY_TESSELLATION_CACHE_MISSES:    return getTessellationCacheMisses();
+    case RTC_DEVICE_PROPERTY_TESSELLATION_CACHE_EVICTIONS: return getTessellationCacheEvictions();
+
     default: throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "unknown readable property"); break;
     };
   }
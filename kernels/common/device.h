@@ -24,6 +24,7 @@ namespace embree
 {
   class BVH4Factory;
   class BVH8Factory;
+  class BlockPool;
 
   class Device : public State, public MemoryMonitorInterface
   {
@@ -58,6 +59,18 @@ namespace embree
     /*! invokes the memory monitor callback */
     void memoryMonitor(ssize_t bytes, bool post);
 
+    /*! returns true if the application set an allocator */
+    bool hasAllocator() const;
+
+    /*! allocates memory through the application allocator or alignedMalloc */
+    void* allocMemory(size_t bytes, size_t align, RTCAllocationCategory category);
+
+    /*! frees memory allocated with allocMemory */
+    void freeMemory(void* ptr, size_t bytes, RTCAllocationCategory category);
+
+    /*! sets the functions used to allocate and free memory */
+    void setAllocator(RTCAllocFunction alloc, RTCFreeFunction free, void* userPtr);
+
     /*! sets the size of the software cache. */
     void setCacheSize(size_t bytes);
 
@@ -67,6 +80,9 @@ namespace embree
     /*! gets a property */
     ssize_t getProperty(const RTCDeviceProperty prop);
 
+    /*! sets the function used to run worker tasks on threads of the application */
+    void setSpawnTasksFunction(RTCSpawnTasksFunction spawnTasks, void* userPtr);
+
   private:
 
     /*! initializes the tasking system */
@@ -75,6 +91,12 @@ namespace embree
     /*! shuts down the tasking system */
     void exitTaskingSystem();
 
+    /*! true if this device installed a spawn tasks function */
+    bool spawn_tasks_function_set;
+
+    /*! number of live allocations made through allocMemory */
+    std::atomic<size_t> numAllocations;
+
     /*! some variables that can be set via rtcSetParameter1i for debugging purposes */
   public:
     static ssize_t debug_int0;
@@ -91,6 +113,9 @@ namespace embree
 #if USE_TASK_ARENA
     std::unique_ptr<tbb::task_arena> arena;
 #endif
+
+    /* pool of freed allocation blocks shared by all scenes of the device */
+    std::unique_ptr<BlockPool> blockPool;
     
     /* ray streams filter */
     RayStreamFilterFuncs rayStreamFilters;
@@ -107,6 +107,13 @@ namespace embree
 
     state = MODIFIED;
   }
+
+  void Geometry::updateMask()
+  {
+    /* the hierarchy only needs its node masks updated */
+    if (scene)
+      scene->setMasksModified();
+  }
   
   void Geometry::commit() 
   {
@@ -111,6 +111,9 @@ namespace embree
       MTY_QUAD_MESH = 1 << GTY_QUAD_MESH,
       MTY_GRID_MESH = 1 << GTY_GRID_MESH,
       MTY_SUBDIV_MESH = 1 << GTY_SUBDIV_MESH,
+
+      MTY_SURFACES = MTY_TRIANGLE_MESH | MTY_QUAD_MESH | MTY_GRID_MESH | MTY_SUBDIV_MESH,
+
       MTY_USER_GEOMETRY = 1 << GTY_USER_GEOMETRY,
       MTY_INSTANCE = 1 << GTY_INSTANCE,
     };
@@ -223,6 +226,9 @@ namespace embree
 
     /*! Update geometry. */
     void update();
+
+    /*! Update ray mask of geometry. */
+    void updateMask();
     
     /*! commit of geometry */
     virtual void commit();
@@ -231,6 +237,11 @@ namespace embree
     virtual void updateBuffer(RTCBufferType type, unsigned int slot) {
       update(); // update everything for geometries not supporting this call
     }
+
+    /*! Update range of items of a geometry buffer. */
+    virtual void updateBufferRange(RTCBufferType type, unsigned int slot, unsigned int first, unsigned int count) {
+      updateBuffer(type,slot); // update entire buffer for geometries not supporting this call
+    }
     
     /*! Disable geometry. */
     virtual void disable();
@@ -255,6 +266,11 @@ namespace embree
       throw_RTCError(RTC_ERROR_INVALID_OPERATION,"operation not supported for this geometry"); 
     }
 
+    /*! sets camera to calculate view dependent tessellation levels */
+    virtual void setTessellationCamera(const RTCTessellationCamera* camera) {
+      throw_RTCError(RTC_ERROR_INVALID_OPERATION,"operation not supported for this geometry"); 
+    }
+
     /*! Set user data pointer. */
     virtual void setUserData(void* ptr);
       
@@ -338,12 +354,22 @@ namespace embree
     virtual void setInstancedScene(const Ref<Scene>& scene) {
       throw_RTCError(RTC_ERROR_INVALID_OPERATION,"operation not supported for this geometry"); 
     }
+
+    /*! Sets a coarser level of detail of the instanced scene */
+    virtual void setInstancedSceneLevel(unsigned int level, const Ref<Scene>& scene, float distance) {
+      throw_RTCError(RTC_ERROR_INVALID_OPERATION,"operation not supported for this geometry"); 
+    }
     
     /*! Sets transformation of the instance */
     virtual void setTransform(const AffineSpace3fa& transform, unsigned int timeStep) {
       throw_RTCError(RTC_ERROR_INVALID_OPERATION,"operation not supported for this geometry"); 
     }
 
+    /*! Sets transformation of the instance as a quaternion decomposition */
+    virtual void setQuaternionDecomposition(const QuaternionDecomposition& qd, unsigned int timeStep) {
+      throw_RTCError(RTC_ERROR_INVALID_OPERATION,"operation not supported for this geometry"); 
+    }
+
     /*! Returns the transformation of the instance */
     virtual AffineSpace3fa getTransform(float time) {
       throw_RTCError(RTC_ERROR_INVALID_OPERATION,"operation not supported for this geometry"); 
@@ -367,6 +393,11 @@ namespace embree
       throw_RTCError(RTC_ERROR_INVALID_OPERATION,"operation not supported for this geometry"); 
     }
 
+    /*! Set maximal number of primitives passed to a single intersect or occluded function call. */
+    virtual void setBatchSize (unsigned int batchSize) { 
+      throw_RTCError(RTC_ERROR_INVALID_OPERATION,"operation not supported for this geometry"); 
+    }
+
     /*! returns number of time segments */
     __forceinline unsigned numTimeSegments () const {
       return numTimeSteps-1;
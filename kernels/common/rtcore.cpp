@@ -115,6 +115,26 @@ RTC_NAMESPACE_BEGIN;
     RTC_CATCH_END(device);
   }
 
+  RTC_API void rtcSetDeviceSpawnTasksFunction(RTCDevice hdevice, RTCSpawnTasksFunction spawnTasks, void* userPtr)
+  {
+    Device* device = (Device*) hdevice;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcSetDeviceSpawnTasksFunction);
+    RTC_VERIFY_HANDLE(hdevice);
+    device->setSpawnTasksFunction(spawnTasks, userPtr);
+    RTC_CATCH_END(device);
+  }
+
+  RTC_API void rtcSetDeviceAllocator(RTCDevice hdevice, RTCAllocFunction alloc, RTCFreeFunction free, void* userPtr)
+  {
+    Device* device = (Device*) hdevice;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcSetDeviceAllocator);
+    RTC_VERIFY_HANDLE(hdevice);
+    device->setAllocator(alloc, free, userPtr);
+    RTC_CATCH_END(device);
+  }
+
   RTC_API RTCBuffer rtcNewBuffer(RTCDevice hdevice, size_t byteSize)
   {
     RTC_CATCH_BEGIN;
@@ -137,6 +157,20 @@ RTC_NAMESPACE_BEGIN;
     return nullptr;
   }
 
+  RTC_API RTCBuffer rtcNewMappedBuffer(RTCDevice hdevice, const char* fileName, size_t byteOffset, size_t byteSize)
+  {
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcNewMappedBuffer);
+    RTC_VERIFY_HANDLE(hdevice);
+    RTC_VERIFY_HANDLE(fileName);
+    if (byteOffset % 4)
+      throw_RTCError(RTC_ERROR_INVALID_ARGUMENT,"file offset has to be aligned to 4 bytes");
+    Buffer* buffer = new Buffer((Device*)hdevice, fileName, byteOffset, byteSize);
+    return (RTCBuffer)buffer->refInc();
+    RTC_CATCH_END((Device*)hdevice);
+    return nullptr;
+  }
+
   RTC_API void* rtcGetBufferData(RTCBuffer hbuffer)
   {
     Buffer* buffer = (Buffer*)hbuffer;
@@ -190,6 +224,21 @@ RTC_NAMESPACE_BEGIN;
     RTC_CATCH_END2(scene);
   }
 
+  RTC_API void rtcSetSceneLazyBuildFunction(RTCScene hscene, RTCLazyBuildFunction build, void* ptr, const RTCBounds* bounds) 
+  {
+    Scene* scene = (Scene*) hscene;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcSetSceneLazyBuildFunction);
+    RTC_VERIFY_HANDLE(hscene);
+    if (build && !bounds)
+      throw_RTCError(RTC_ERROR_INVALID_ARGUMENT,"invalid bounds specified");
+    BBox3fa b = empty;
+    if (bounds) b = BBox3fa(Vec3fa(bounds->lower_x,bounds->lower_y,bounds->lower_z),
+                            Vec3fa(bounds->upper_x,bounds->upper_y,bounds->upper_z));
+    scene->setLazyBuildFunction(build,ptr,b);
+    RTC_CATCH_END2(scene);
+  }
+
   RTC_API void rtcSetSceneBuildQuality (RTCScene hscene, RTCBuildQuality quality) 
   {
     Scene* scene = (Scene*) hscene;
@@ -245,6 +294,22 @@ RTC_NAMESPACE_BEGIN;
     RTC_CATCH_END2(scene);
   }
 
+  RTC_API void rtcCommitScenes (RTCScene* hscenes, size_t numScenes) 
+  {
+    if (numScenes == 0) return;
+    Scene* scene = hscenes ? (Scene*) hscenes[0] : nullptr;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcCommitScenes);
+    RTC_VERIFY_HANDLE(hscenes);
+    for (size_t i=0; i<numScenes; i++) {
+      RTC_VERIFY_HANDLE(hscenes[i]);
+      if (((Scene*)hscenes[i])->device != scene->device)
+        throw_RTCError(RTC_ERROR_INVALID_ARGUMENT,"scenes belong to different devices");
+    }
+    Scene::commitScenes((Scene**)hscenes,numScenes);
+    RTC_CATCH_END2(scene);
+  }
+
   RTC_API void rtcGetSceneBounds(RTCScene hscene, RTCBounds* bounds_o)
   {
     Scene* scene = (Scene*) hscene;
@@ -823,6 +888,17 @@ RTC_NAMESPACE_BEGIN;
     RTC_CATCH_END2(geometry);
   }
 
+  RTC_API void rtcSetGeometryInstancedSceneLevel(RTCGeometry hgeometry, unsigned int level, RTCScene hscene, float distance)
+  {
+    Geometry* geometry = (Geometry*) hgeometry;
+    Ref<Scene> scene = (Scene*) hscene;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcSetGeometryInstancedSceneLevel);
+    RTC_VERIFY_HANDLE(hgeometry);
+    geometry->setInstancedSceneLevel(level,scene,distance);
+    RTC_CATCH_END2(geometry);
+  }
+
   AffineSpace3fa loadTransform(RTCFormat format, const float* xfm)
   {
     AffineSpace3fa space = one;
@@ -898,6 +974,22 @@ RTC_NAMESPACE_BEGIN;
     RTC_CATCH_END2(geometry);
   }
 
+  RTC_API void rtcSetGeometryTransformQuaternion(RTCGeometry hgeometry, unsigned int timeStep, const RTCQuaternionDecomposition* qd)
+  {
+    Geometry* geometry = (Geometry*) hgeometry;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcSetGeometryTransformQuaternion);
+    RTC_VERIFY_HANDLE(hgeometry);
+    RTC_VERIFY_HANDLE(qd);
+    const QuaternionDecomposition transform(Vec3fa(qd->scale_x,qd->scale_y,qd->scale_z),
+                                            Vec3fa(qd->skew_xy,qd->skew_xz,qd->skew_yz),
+                                            Vec3fa(qd->shift_x,qd->shift_y,qd->shift_z),
+                                            Quaternion3f(qd->quaternion_r,qd->quaternion_i,qd->quaternion_j,qd->quaternion_k),
+                                            Vec3fa(qd->translation_x,qd->translation_y,qd->translation_z));
+    geometry->setQuaternionDecomposition(transform, timeStep);
+    RTC_CATCH_END2(geometry);
+  }
+
   RTC_API void rtcGetGeometryTransform(RTCGeometry hgeometry, float time, RTCFormat format, void* xfm)
   {
     Geometry* geometry = (Geometry*) hgeometry;
@@ -1098,6 +1190,16 @@ RTC_NAMESPACE_BEGIN;
     RTC_CATCH_END2(geometry);
   }
 
+  RTC_API void rtcSetGeometryUserPrimitiveBatchSize(RTCGeometry hgeometry, unsigned int batchSize)
+  {
+    Geometry* geometry = (Geometry*) hgeometry;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcSetGeometryUserPrimitiveBatchSize);
+    RTC_VERIFY_HANDLE(hgeometry);
+    geometry->setBatchSize(batchSize);
+    RTC_CATCH_END2(geometry);
+  }
+
   RTC_API void rtcSetGeometryTimeStepCount(RTCGeometry hgeometry, unsigned int timeStepCount)
   {
     Geometry* geometry = (Geometry*) hgeometry;
@@ -1279,6 +1381,16 @@ RTC_NAMESPACE_BEGIN;
     RTC_CATCH_END2(geometry);
   }
 
+  RTC_API void rtcUpdateGeometryBufferRange (RTCGeometry hgeometry, RTCBufferType type, unsigned int slot, unsigned int first, unsigned int count) 
+  {
+    Geometry* geometry = (Geometry*) hgeometry;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcUpdateGeometryBufferRange);
+    RTC_VERIFY_HANDLE(hgeometry);
+    geometry->updateBufferRange(type, slot, first, count);
+    RTC_CATCH_END2(geometry);
+  }
+
   RTC_API void rtcDisableGeometry (RTCGeometry hgeometry) 
   {
     Geometry* geometry = (Geometry*) hgeometry;
@@ -1299,6 +1411,16 @@ RTC_NAMESPACE_BEGIN;
     RTC_CATCH_END2(geometry);
   }
 
+  RTC_API void rtcSetGeometryTessellationCamera (RTCGeometry hgeometry, const RTCTessellationCamera* camera)
+  {
+    Geometry* geometry = (Geometry*) hgeometry;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcSetGeometryTessellationCamera);
+    RTC_VERIFY_HANDLE(hgeometry);
+    geometry->setTessellationCamera(camera);
+    RTC_CATCH_END2(geometry);
+  }
+
   RTC_API void rtcSetGeometryUserData (RTCGeometry hgeometry, void* ptr) 
   {
     Geometry* geometry = (Geometry*) hgeometry;
@@ -16,6 +16,7 @@
 
 #include "scene.h"
 
+#include "../bvh/bvh.h"
 #include "../bvh/bvh4_factory.h"
 #include "../bvh/bvh8_factory.h"
  
@@ -34,8 +35,10 @@ namespace embree
       flags_modified(true), enabled_geometry_types(0),
       scene_flags(RTC_SCENE_FLAG_NONE),
       quality_flags(RTC_BUILD_QUALITY_MEDIUM),
-      is_build(false), modified(true),
+      is_build(false), modified(true), masks_modified(false),
+      autotune_tri_accel(-1), autotune_tri_prims(0),
       progressInterface(this), progress_monitor_function(nullptr), progress_monitor_ptr(nullptr), progress_monitor_counter(0), 
+      lazy_build_function(nullptr), lazy_build_ptr(nullptr), lazy_build_pending(false),
       numIntersectionFiltersN(0)
   {
     device->refInc();
@@ -120,7 +123,11 @@ namespace embree
   void Scene::createTriangleAccel()
   {
 #if defined(EMBREE_GEOMETRY_TRIANGLE)
-    if (device->tri_accel == "default") 
+    if (device->tri_accel == "default" && isAutotuneAccel() && isStaticAccel() && quality_flags != RTC_BUILD_QUALITY_LOW)
+    {
+      createTriangleAccelAutotune();
+    }
+    else if (device->tri_accel == "default") 
     {
       if (quality_flags != RTC_BUILD_QUALITY_LOW)
       {
@@ -200,31 +207,182 @@ namespace embree
 #endif
   }
 
+  /* returns the number of bytes used by the nodes and leaves of a BVH based acceleration structure */
+  static size_t getAccelUsedBytes(Accel* accel)
+  {
+    AccelData* data = accel->intersectors.ptr;
+    if (data == nullptr) return 0;
+    if (data->type == AccelData::TY_BVH4) return ((BVH4*)data)->alloc.getStatistics(FastAllocator::ANY_TYPE).bytesUsed;
+    if (data->type == AccelData::TY_BVH8) return ((BVH8*)data)->alloc.getStatistics(FastAllocator::ANY_TYPE).bytesUsed;
+    return 0;
+  }
+
+  void Scene::createTriangleAccelAutotune()
+  {
+#if defined(EMBREE_GEOMETRY_TRIANGLE)
+    struct Candidate
+    {
+      const char* name;
+      std::function<Accel*(Scene*)> create;
+    };
+
+    /* collect all acceleration structures that are valid for the scene flags */
+    const BVHFactory::BuildVariant bvariant = quality_flags == RTC_BUILD_QUALITY_HIGH ? BVHFactory::BuildVariant::HIGH_QUALITY : BVHFactory::BuildVariant::STATIC;
+    const BVHFactory::IntersectVariant ivariant = isRobustAccel() ? BVHFactory::IntersectVariant::ROBUST : BVHFactory::IntersectVariant::FAST;
+    std::vector<Candidate> candidates;
+    if (!isCompactAccel() && !isRobustAccel())
+      candidates.push_back({ "bvh4.triangle4" , [&] (Scene* scene) { return device->bvh4_factory->BVH4Triangle4 (scene,bvariant,BVHFactory::IntersectVariant::FAST); } });
+    if (!isCompactAccel() &&  isRobustAccel())
+      candidates.push_back({ "bvh4.triangle4v", [&] (Scene* scene) { return device->bvh4_factory->BVH4Triangle4v(scene,bvariant,BVHFactory::IntersectVariant::ROBUST); } });
+    candidates.push_back({ "bvh4.triangle4i", [&] (Scene* scene) { return device->bvh4_factory->BVH4Triangle4i(scene,bvariant,ivariant); } });
+#if defined (EMBREE_TARGET_SIMD8)
+    if (device->canUseAVX())
+    {
+      if (!isCompactAccel() && !isRobustAccel())
+        candidates.push_back({ "bvh8.triangle4" , [&] (Scene* scene) { return device->bvh8_factory->BVH8Triangle4 (scene,bvariant,BVHFactory::IntersectVariant::FAST); } });
+      if (!isCompactAccel() &&  isRobustAccel())
+        candidates.push_back({ "bvh8.triangle4v", [&] (Scene* scene) { return device->bvh8_factory->BVH8Triangle4v(scene,bvariant,BVHFactory::IntersectVariant::ROBUST); } });
+      candidates.push_back({ "bvh8.triangle4i", [&] (Scene* scene) { return device->bvh8_factory->BVH8Triangle4i(scene,BVHFactory::BuildVariant::STATIC,ivariant); } });
+    }
+#endif
+
+    /* reuse previous selection as long as the number of triangles did not change */
+    const size_t numTriangles = getNumPrimitives<TriangleMesh,false>();
+    if (autotune_tri_accel >= 0 && autotune_tri_accel < (int)candidates.size() && autotune_tri_prims == numTriangles) {
+      accels_add(candidates[autotune_tri_accel].create(this));
+      return;
+    }
+
+    /* create a sample scene that shares the vertex and index buffers of
+     * the triangle meshes, but only contains a contiguous prefix of the
+     * triangles of each mesh */
+    Ref<Scene> sample = new Scene(device);
+    sample->scene_flags = RTCSceneFlags(scene_flags & ~(RTC_SCENE_FLAG_AUTOTUNE | RTC_SCENE_FLAG_REORDER_VERTICES));
+    sample->quality_flags = quality_flags;
+    const float ratio = min(1.0f,float(device->autotune_sample_size)/float(numTriangles));
+    createTriangleMeshTy createTriangleMesh = nullptr;
+    SELECT_SYMBOL_DEFAULT_AVX_AVX2_AVX512KNL_AVX512SKX(device->enabled_cpu_features,createTriangleMesh);
+    Scene::Iterator<TriangleMesh,false> iter(this);
+    for (size_t i=0; i<iter.size(); i++)
+    {
+      TriangleMesh* mesh = iter[i];
+      if (mesh == nullptr) continue;
+      const unsigned int num = (unsigned int) min(mesh->size(),size_t(ceilf(ratio*float(mesh->size()))));
+      if (num == 0) continue;
+
+      const RawBufferView& vertices = mesh->vertices0;
+      const RawBufferView& triangles = mesh->triangles;
+      Ref<TriangleMesh> copy = createTriangleMesh(device);
+      copy->setBuffer(RTC_BUFFER_TYPE_VERTEX,0,RTC_FORMAT_FLOAT3,vertices.buffer,vertices.ptr_ofs-vertices.buffer->ptr,vertices.stride,(unsigned int)vertices.size());
+      copy->setBuffer(RTC_BUFFER_TYPE_INDEX ,0,RTC_FORMAT_UINT3 ,triangles.buffer,triangles.ptr_ofs-triangles.buffer->ptr,triangles.stride,num);
+      copy->commit();
+      const unsigned int geomID = sample->bind(RTC_INVALID_GEOMETRY_ID,copy.ptr);
+      sample->vertices[geomID] = (float*) copy->vertices0.getPtr();
+    }
+
+    /* build each candidate over the sample and trace a fixed set of random rays through it */
+    std::vector<RayHit> rays;
+    std::vector<double> dt(candidates.size());
+    std::vector<size_t> bytes(candidates.size());
+    for (size_t i=0; i<candidates.size(); i++)
+    {
+      std::unique_ptr<Accel> accel(candidates[i].create(sample.ptr));
+      accel->build();
+      bytes[i] = getAccelUsedBytes(accel.get());
+
+      /* generate rays between random points of the sample bounds */
+      if (rays.size() == 0 && !accel->isEmpty())
+      {
+        const BBox3fa bounds = accel->bounds.bounds();
+        unsigned int seed = 0x2545F491;
+        auto rnd = [&] () -> float {
+          seed = 1664525*seed + 1013904223;
+          return float(seed >> 8) * (1.0f/16777216.0f);
+        };
+        auto rndPoint = [&] () -> Vec3fa {
+          return bounds.lower + bounds.size()*Vec3fa(rnd(),rnd(),rnd());
+        };
+        rays.resize(device->autotune_num_rays);
+        for (size_t j=0; j<rays.size(); j++) {
+          const Vec3fa org = rndPoint();
+          rays[j] = RayHit(org,normalize(rndPoint()-org+Vec3fa(1E-3f)));
+        }
+      }
+
+      /* measure best of two runs to filter out noise */
+      RTCIntersectContext user_context;
+      rtcInitIntersectContext(&user_context);
+      IntersectContext context(sample.ptr,&user_context);
+      dt[i] = inf;
+      for (size_t k=0; k<2; k++)
+      {
+        const double t0 = getSeconds();
+        for (size_t j=0; j<rays.size(); j++) {
+          RayHit ray = rays[j];
+          accel->intersectors.intersect((RTCRayHit&)ray,&context);
+        }
+        const double t1 = getSeconds();
+        dt[i] = min(dt[i],t1-t0);
+      }
+    }
+
+    /* select the fastest candidate that stays within the memory limit */
+    size_t minBytes = std::numeric_limits<size_t>::max();
+    for (size_t i=0; i<candidates.size(); i++)
+      minBytes = min(minBytes,bytes[i]);
+
+    int best = 0;
+    for (size_t i=0; i<candidates.size(); i++)
+    {
+      if (double(bytes[i]) > double(device->autotune_max_memory_factor)*double(minBytes)) continue;
+      if (double(bytes[best]) > double(device->autotune_max_memory_factor)*double(minBytes) || dt[i] < dt[best])
+        best = (int) i;
+    }
+
+    if (device->verbosity(1))
+    {
+      std::cout << "autotuning triangle acceleration structure over " << sample->getNumPrimitives<TriangleMesh,false>() << " of " << numTriangles << " triangles" << std::endl;
+      for (size_t i=0; i<candidates.size(); i++)
+      {
+        std::cout << "  " << std::setw(16) << std::left << candidates[i].name << std::right
+                  << std::setw(10) << std::setprecision(3) << 1E-6*double(rays.size())/dt[i] << " Mrays/s, "
+                  << std::setw(10) << std::setprecision(3) << 1E-6*double(bytes[i]) << " MB"
+                  << (int(i) == best ? " (selected)" : "") << std::endl;
+      }
+    }
+
+    autotune_tri_accel = best;
+    autotune_tri_prims = numTriangles;
+    accels_add(candidates[best].create(this));
+#endif
+  }
+
   void Scene::createTriangleMBAccel()
   {
 #if defined(EMBREE_GEOMETRY_TRIANGLE)
     if (device->tri_accel_mb == "default")
     {
       int mode =  2*(int)isCompactAccel() + 1*(int)isRobustAccel(); 
+      BVHFactory::BuildVariant bvariant = isDynamicAccel() ? BVHFactory::BuildVariant::DYNAMIC : BVHFactory::BuildVariant::STATIC;
       
 #if defined (EMBREE_TARGET_SIMD8)
       if (device->canUseAVX2()) // BVH8 reduces performance on AVX only-machines
       {
         switch (mode) {
-        case /*0b00*/ 0: accels_add(device->bvh8_factory->BVH8Triangle4iMB(this,BVHFactory::BuildVariant::STATIC,BVHFactory::IntersectVariant::FAST  )); break;
-        case /*0b01*/ 1: accels_add(device->bvh8_factory->BVH8Triangle4iMB(this,BVHFactory::BuildVariant::STATIC,BVHFactory::IntersectVariant::ROBUST)); break;
-        case /*0b10*/ 2: accels_add(device->bvh4_factory->BVH4Triangle4iMB(this,BVHFactory::BuildVariant::STATIC,BVHFactory::IntersectVariant::FAST  )); break;
-        case /*0b11*/ 3: accels_add(device->bvh4_factory->BVH4Triangle4iMB(this,BVHFactory::BuildVariant::STATIC,BVHFactory::IntersectVariant::ROBUST)); break;
+        case /*0b00*/ 0: accels_add(device->bvh8_factory->BVH8Triangle4iMB(this,bvariant,BVHFactory::IntersectVariant::FAST  )); break;
+        case /*0b01*/ 1: accels_add(device->bvh8_factory->BVH8Triangle4iMB(this,bvariant,BVHFactory::IntersectVariant::ROBUST)); break;
+        case /*0b10*/ 2: accels_add(device->bvh4_factory->BVH4Triangle4iMB(this,bvariant,BVHFactory::IntersectVariant::FAST  )); break;
+        case /*0b11*/ 3: accels_add(device->bvh4_factory->BVH4Triangle4iMB(this,bvariant,BVHFactory::IntersectVariant::ROBUST)); break;
         }
       }
       else
 #endif
       {
         switch (mode) {
-        case /*0b00*/ 0: accels_add(device->bvh4_factory->BVH4Triangle4iMB(this,BVHFactory::BuildVariant::STATIC,BVHFactory::IntersectVariant::FAST  )); break;
-        case /*0b01*/ 1: accels_add(device->bvh4_factory->BVH4Triangle4iMB(this,BVHFactory::BuildVariant::STATIC,BVHFactory::IntersectVariant::ROBUST)); break;
-        case /*0b10*/ 2: accels_add(device->bvh4_factory->BVH4Triangle4iMB(this,BVHFactory::BuildVariant::STATIC,BVHFactory::IntersectVariant::FAST  )); break;
-        case /*0b11*/ 3: accels_add(device->bvh4_factory->BVH4Triangle4iMB(this,BVHFactory::BuildVariant::STATIC,BVHFactory::IntersectVariant::ROBUST)); break;
+        case /*0b00*/ 0: accels_add(device->bvh4_factory->BVH4Triangle4iMB(this,bvariant,BVHFactory::IntersectVariant::FAST  )); break;
+        case /*0b01*/ 1: accels_add(device->bvh4_factory->BVH4Triangle4iMB(this,bvariant,BVHFactory::IntersectVariant::ROBUST)); break;
+        case /*0b10*/ 2: accels_add(device->bvh4_factory->BVH4Triangle4iMB(this,bvariant,BVHFactory::IntersectVariant::FAST  )); break;
+        case /*0b11*/ 3: accels_add(device->bvh4_factory->BVH4Triangle4iMB(this,bvariant,BVHFactory::IntersectVariant::ROBUST)); break;
         }
       }
     }
@@ -325,27 +483,28 @@ namespace embree
     if (device->quad_accel_mb == "default") 
     {
       int mode =  2*(int)isCompactAccel() + 1*(int)isRobustAccel(); 
+      BVHFactory::BuildVariant bvariant = isDynamicAccel() ? BVHFactory::BuildVariant::DYNAMIC : BVHFactory::BuildVariant::STATIC;
       switch (mode) {
       case /*0b00*/ 0:
 #if defined (EMBREE_TARGET_SIMD8)
         if (device->canUseAVX())
-          accels_add(device->bvh8_factory->BVH8Quad4iMB(this,BVHFactory::BuildVariant::STATIC,BVHFactory::IntersectVariant::FAST));
+          accels_add(device->bvh8_factory->BVH8Quad4iMB(this,bvariant,BVHFactory::IntersectVariant::FAST));
         else
 #endif
-          accels_add(device->bvh4_factory->BVH4Quad4iMB(this,BVHFactory::BuildVariant::STATIC,BVHFactory::IntersectVariant::FAST));
+          accels_add(device->bvh4_factory->BVH4Quad4iMB(this,bvariant,BVHFactory::IntersectVariant::FAST));
         break;
 
       case /*0b01*/ 1:
 #if defined (EMBREE_TARGET_SIMD8)
         if (device->canUseAVX())
-          accels_add(device->bvh8_factory->BVH8Quad4iMB(this,BVHFactory::BuildVariant::STATIC,BVHFactory::IntersectVariant::ROBUST));
+          accels_add(device->bvh8_factory->BVH8Quad4iMB(this,bvariant,BVHFactory::IntersectVariant::ROBUST));
         else
 #endif
-          accels_add(device->bvh4_factory->BVH4Quad4iMB(this,BVHFactory::BuildVariant::STATIC,BVHFactory::IntersectVariant::ROBUST));
+          accels_add(device->bvh4_factory->BVH4Quad4iMB(this,bvariant,BVHFactory::IntersectVariant::ROBUST));
         break;
 
-      case /*0b10*/ 2: accels_add(device->bvh4_factory->BVH4Quad4iMB(this,BVHFactory::BuildVariant::STATIC,BVHFactory::IntersectVariant::FAST  )); break;
-      case /*0b11*/ 3: accels_add(device->bvh4_factory->BVH4Quad4iMB(this,BVHFactory::BuildVariant::STATIC,BVHFactory::IntersectVariant::ROBUST)); break;
+      case /*0b10*/ 2: accels_add(device->bvh4_factory->BVH4Quad4iMB(this,bvariant,BVHFactory::IntersectVariant::FAST  )); break;
+      case /*0b11*/ 3: accels_add(device->bvh4_factory->BVH4Quad4iMB(this,bvariant,BVHFactory::IntersectVariant::ROBUST)); break;
       }
     }
     else if (device->quad_accel_mb == "bvh4.quad4imb") accels_add(device->bvh4_factory->BVH4Quad4iMB(this));
@@ -612,6 +771,18 @@ namespace embree
 
   void Scene::commit_task ()
   {
+    /* if only geometry masks changed we just update the masks stored in the hierarchies */
+    if (!modified)
+    {
+      accels_updateMasks();
+      masks_modified = false;
+      return;
+    }
+
+    /* lazy scenes create their geometries before their first build */
+    if (lazy_build_pending)
+      lazy_build_function(lazy_build_ptr,(RTCScene)this);
+
     /* print scene statistics */
     if (device->verbosity(2))
       printStatistics();
@@ -661,6 +832,13 @@ namespace embree
     /* build all hierarchies of this scene */
     accels_build();
 
+    /* store vertices in the order the leaves reference them */
+    if (isReorderVerticesAccel())
+      accels_reorderVertices();
+
+    /* store the geometry masks of all subtrees in the nodes */
+    accels_updateMasks();
+
     /* make static geometry immutable */
     if (!isDynamicAccel()) {
       accels_immutable();
@@ -683,6 +861,8 @@ namespace embree
     }
     
     setModified(false);
+    masks_modified = false;
+    lazy_build_pending = false;
   }
 
   void Scene::setBuildQuality(RTCBuildQuality quality_flags_i)
@@ -690,6 +870,7 @@ namespace embree
     if (quality_flags == quality_flags_i) return;
     quality_flags = quality_flags_i;
     flags_modified = true;
+    autotune_tri_accel = -1;
   }
 
   RTCBuildQuality Scene::getBuildQuality() const {
@@ -701,6 +882,7 @@ namespace embree
     if (scene_flags == scene_flags_i) return;
     scene_flags = scene_flags_i;
     flags_modified = true;
+    autotune_tri_accel = -1;
   }
 
   RTCSceneFlags Scene::getSceneFlags() const {
@@ -751,6 +933,10 @@ namespace embree
       this->scheduler = nullptr;
       throw;
     }
+
+    /* print time statistics of the worker threads */
+    if (device->verbosity(2))
+      TaskScheduler::printThreadStatistics();
   }
 
 #endif
@@ -846,12 +1032,156 @@ namespace embree
   }
 #endif
 
+  void Scene::commitScenes (Scene** scenes_in, size_t numScenes)
+  {
+    /* remove duplicate scenes, sorting also fixes the locking order */
+    std::vector<Scene*> scenes(scenes_in,scenes_in+numScenes);
+    std::sort(scenes.begin(),scenes.end());
+    scenes.erase(std::unique(scenes.begin(),scenes.end()),scenes.end());
+    if (scenes.size() == 0) return;
+    
+    /* instanced scenes of this batch have to get committed before the scenes instancing them */
+    std::map<Accel*,size_t> level;
+    for (Scene* scene : scenes) level[scene] = 0;
+    size_t numLevels = 1;
+    for (size_t pass=0; pass<scenes.size(); pass++)
+    {
+      bool changed = false;
+      for (Scene* scene : scenes)
+      {
+        for (size_t i=0; i<scene->size(); i++)
+        {
+          Geometry* geom = scene->get(i);
+          if (geom == nullptr || geom->getType() != Geometry::GTY_INSTANCE) continue;
+          Instance* instance = (Instance*) geom;
+          for (size_t lod=0; lod<instance->numLevels(); lod++)
+          {
+            auto child = level.find(instance->getLevel(lod));
+            if (child == level.end() || level[scene] > child->second) continue;
+            level[scene] = child->second+1;
+            numLevels = max(numLevels,level[scene]+1);
+            changed = true;
+          }
+        }
+      }
+      if (!changed) break;
+    }
+
+    /* try to obtain the build lock of all scenes */
+    size_t numLocked = 0;
+    while (numLocked < scenes.size() && scenes[numLocked]->buildMutex.try_lock())
+      numLocked++;
+    
+    auto unlock = [&] () {
+      for (size_t i=0; i<numLocked; i++)
+        scenes[i]->buildMutex.unlock();
+    };
+    
+    if (numLocked != scenes.size()) {
+      unlock();
+      throw_RTCError(RTC_ERROR_INVALID_OPERATION,"scene got already committed by another thread");
+    }
+
+    /* for best performance set FTZ and DAZ flags in the MXCSR control and status register */
+    unsigned int mxcsr = _mm_getcsr();
+    _mm_setcsr(mxcsr | /* FTZ */ (1<<15) | /* DAZ */ (1<<6));
+    
+    /* builds all modified scenes of a level in parallel, large scenes additionally build in parallel internally */
+    auto commit_levels = [&] ()
+    {
+      for (size_t l=0; l<numLevels; l++)
+      {
+        std::vector<Scene*> modified;
+        for (Scene* scene : scenes)
+          if (level[scene] == l && scene->isModified())
+            modified.push_back(scene);
+
+        MutexSys errorMutex;
+        std::exception_ptr error = nullptr;
+        parallel_for(modified.size(), [&] ( const size_t i ) {
+            try {
+              modified[i]->commit_task();
+            } catch (...) {
+              modified[i]->accels_clear();
+              modified[i]->updateInterface();
+              Lock<MutexSys> lock(errorMutex);
+              if (error == nullptr) error = std::current_exception();
+            }
+          });
+
+        /* scenes instancing a failed scene are not committed */
+        if (error) std::rethrow_exception(error);
+      }
+    };
+    
+    try {
+#if defined(TASKING_INTERNAL)
+      /* allocates own taskscheduler for the build */
+      Ref<TaskScheduler> scheduler = new TaskScheduler;
+      scheduler->spawn_root(commit_levels);
+
+      /* print time statistics of the worker threads */
+      if (scenes[0]->device->verbosity(2))
+        TaskScheduler::printThreadStatistics();
+      
+#elif defined(TASKING_TBB)
+#if TBB_INTERFACE_VERSION_MAJOR < 8    
+      tbb::task_group_context ctx( tbb::task_group_context::isolated, tbb::task_group_context::default_traits);
+#else
+      tbb::task_group_context ctx( tbb::task_group_context::isolated, tbb::task_group_context::default_traits | tbb::task_group_context::fp_settings );
+#endif
+#if USE_TASK_ARENA
+      scenes[0]->device->arena->execute([&]{
+#endif
+          tbb::parallel_for (size_t(0), size_t(1), size_t(1), [&] (size_t) { commit_levels(); }, ctx);
+#if USE_TASK_ARENA
+        });
+#endif
+#else
+      concurrency::parallel_for(size_t(0), size_t(1), size_t(1), [&](size_t) { commit_levels(); });
+#endif
+    }
+    catch (...) {
+      _mm_setcsr(mxcsr);
+      unlock();
+      throw;
+    }
+    
+    /* reset MXCSR register again */
+    _mm_setcsr(mxcsr);
+    unlock();
+  }
+
   void Scene::setProgressMonitorFunction(RTCProgressMonitorFunction func, void* ptr) 
   {
     progress_monitor_function = func;
     progress_monitor_ptr      = ptr;
   }
 
+  void Scene::setLazyBuildFunction(RTCLazyBuildFunction func, void* ptr, const BBox3fa& b) 
+  {
+    lazy_build_function = func;
+    lazy_build_ptr      = ptr;
+    lazy_build_pending  = func != nullptr;
+
+    /* instances use the specified bounds until the scene got built */
+    if (func) {
+      bounds = LBBox3fa(b);
+      setModified();
+    }
+  }
+
+  void Scene::commitLazy()
+  {
+    /* all threads entering the scene during its build join that build */
+#if defined(TASKING_PPL) || defined(TASKING_TBB) && (TBB_INTERFACE_VERSION_MAJOR < 8)
+    Lock<MutexSys> lock(lazyMutex);
+    if (lazy_build_pending) commit(false);
+#else
+    commit(true);
+#endif
+  }
+
   void Scene::progressMonitor(double dn)
   {
     if (progress_monitor_function) {
@@ -158,6 +158,7 @@ namespace embree
 
   public:
     void createTriangleAccel();
+    void createTriangleAccelAutotune();
     void createTriangleMBAccel();
     void createQuadAccel();
     void createQuadMBAccel();
@@ -189,6 +190,9 @@ namespace embree
     
     void commit (bool join);
     void commit_task ();
+
+    /*! commits multiple scenes, instanced scenes get committed before the scenes instancing them */
+    static void commitScenes (Scene** scenes, size_t numScenes);
     void build () {}
 
     void updateInterface();
@@ -200,13 +204,18 @@ namespace embree
     unsigned int bind (unsigned geomID, Ref<Geometry> geometry);
     
     /* determines if scene is modified */
-    __forceinline bool isModified() const { return modified; }
+    __forceinline bool isModified() const { return modified || masks_modified; }
 
     /* sets modified flag */
     __forceinline void setModified(bool f = true) { 
       modified = f; 
     }
 
+    /* marks the geometry masks as modified */
+    __forceinline void setMasksModified() {
+      masks_modified = true;
+    }
+
     /* get mesh by ID */
     __forceinline       Geometry* get(size_t i)       { assert(i < geometries.size()); return geometries[i].ptr; }
     __forceinline const Geometry* get(size_t i) const { assert(i < geometries.size()); return geometries[i].ptr; }
@@ -244,6 +253,8 @@ namespace embree
     __forceinline bool isRobustAccel()  const { return scene_flags & RTC_SCENE_FLAG_ROBUST; }
     __forceinline bool isStaticAccel()  const { return !(scene_flags & RTC_SCENE_FLAG_DYNAMIC); }
     __forceinline bool isDynamicAccel() const { return scene_flags & RTC_SCENE_FLAG_DYNAMIC; }
+    __forceinline bool isAutotuneAccel() const { return scene_flags & RTC_SCENE_FLAG_AUTOTUNE; }
+    __forceinline bool isReorderVerticesAccel() const { return scene_flags & RTC_SCENE_FLAG_REORDER_VERTICES; }
     
     __forceinline bool hasContextFilterFunction() const {
       return scene_flags & RTC_SCENE_FLAG_CONTEXT_FILTER_FUNCTION;
@@ -276,6 +287,11 @@ namespace embree
     SpinLock geometriesMutex;
     bool is_build;
     bool modified;                   //!< true if scene got modified
+    bool masks_modified;             //!< true if geometry masks got modified
+
+    /* acceleration structure selected by the autotuner */
+    int autotune_tri_accel;          //!< index of selected triangle candidate, -1 if not tuned yet
+    size_t autotune_tri_prims;       //!< number of triangles the selection was made for
     
     /*! global lock step task scheduler */
 #if defined(TASKING_INTERNAL) 
@@ -304,6 +320,19 @@ namespace embree
     void progressMonitor(double nprims);
     void setProgressMonitorFunction(RTCProgressMonitorFunction func, void* ptr);
 
+  public:
+    RTCLazyBuildFunction lazy_build_function;
+    void* lazy_build_ptr;
+    std::atomic<bool> lazy_build_pending; //!< true until the first build of a lazy scene finished
+    MutexSys lazyMutex;
+    void setLazyBuildFunction(RTCLazyBuildFunction func, void* ptr, const BBox3fa& bounds);
+    void commitLazy();
+
+    /* builds a lazy scene when the first ray enters it */
+    __forceinline void buildLazy() {
+      if (unlikely(lazy_build_pending)) commitLazy();
+    }
+
   public:
     struct GeometryCounts 
     {
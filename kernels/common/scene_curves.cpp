@@ -47,7 +47,7 @@ namespace embree
   void CurveGeometry::setMask (unsigned mask) 
   {
     this->mask = mask; 
-    Geometry::update();
+    Geometry::updateMask();
   }
 
   void CurveGeometry::setNumTimeSteps (unsigned int numTimeSteps)
@@ -42,7 +42,7 @@ namespace embree
   void GridMesh::setMask (unsigned mask) 
   {
     this->mask = mask; 
-    Geometry::update();
+    Geometry::updateMask();
   }
 
   void GridMesh::setNumTimeSteps (unsigned int numTimeSteps)
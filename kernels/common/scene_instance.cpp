@@ -22,7 +22,7 @@ namespace embree
 #if defined(EMBREE_LOWEST_ISA)
 
   Instance::Instance (Device* device, Accel* object, unsigned int numTimeSteps) 
-    : Geometry(device,Geometry::GTY_INSTANCE,1,numTimeSteps), object(object), local2world(nullptr)
+    : Geometry(device,Geometry::GTY_INSTANCE,1,numTimeSteps), object(object), local2world(nullptr), quaternionDecomposition(nullptr)
   {
     if (object) object->refInc();
     world2local0 = one;
@@ -34,7 +34,10 @@ namespace embree
   Instance::~Instance()
   {
     alignedFree(local2world);
+    alignedFree(quaternionDecomposition);
     if (object) object->refDec();
+    for (auto& level : levels)
+      level.object->refDec();
   }
 
   void Instance::enabling () {
@@ -62,6 +65,20 @@ namespace embree
         
     alignedFree(local2world);
     local2world = local2world2;
+
+    if (quaternionDecomposition)
+    {
+      QuaternionDecomposition* quaternionDecomposition2 = (QuaternionDecomposition*) alignedMalloc(numTimeSteps_in*sizeof(QuaternionDecomposition),16);
+      
+      for (size_t i = 0; i < min(numTimeSteps, numTimeSteps_in); i++)
+        quaternionDecomposition2[i] = quaternionDecomposition[i];
+      
+      for (size_t i = numTimeSteps; i < numTimeSteps_in; i++)
+        quaternionDecomposition2[i] = one;
+      
+      alignedFree(quaternionDecomposition);
+      quaternionDecomposition = quaternionDecomposition2;
+    }
     
     Geometry::setNumTimeSteps(numTimeSteps_in);
   }
@@ -73,17 +90,166 @@ namespace embree
     if (object) object->refInc();
     Geometry::update();
   }
+
+  void Instance::setInstancedSceneLevel(unsigned int level, const Ref<Scene>& scene, float distance)
+  {
+    if (level == 0 || level > levels.size()+1)
+      throw_RTCError(RTC_ERROR_INVALID_ARGUMENT,"invalid level of detail");
+
+    /* setting no scene removes this and all coarser levels */
+    if (!scene)
+    {
+      for (size_t l=level-1; l<levels.size(); l++)
+        levels[l].object->refDec();
+      levels.resize(level-1);
+      Geometry::update();
+      return;
+    }
+
+    /* levels have to be ordered by strictly increasing distances */
+    if (!(distance > 0.0f) || !(distance < float(pos_inf)))
+      throw_RTCError(RTC_ERROR_INVALID_ARGUMENT,"invalid level of detail distance");
+    if (level > 1 && !(distance > levels[level-2].distance))
+      throw_RTCError(RTC_ERROR_INVALID_ARGUMENT,"invalid level of detail distance");
+    if (level < levels.size() && !(distance < levels[level].distance))
+      throw_RTCError(RTC_ERROR_INVALID_ARGUMENT,"invalid level of detail distance");
+
+    Accel* lod = scene.ptr;
+    lod->refInc();
+    if (level == levels.size()+1) levels.push_back(Level());
+    else levels[level-1].object->refDec();
+    levels[level-1].object = lod;
+    levels[level-1].distance = distance;
+    Geometry::update();
+  }
   
   void Instance::setTransform(const AffineSpace3fa& xfm, unsigned int timeStep)
   {
     if (timeStep >= numTimeSteps)
       throw_RTCError(RTC_ERROR_INVALID_OPERATION,"invalid timestep");
 
+    /* the representation of time step 0 determines how the instance gets interpolated */
+    if (timeStep == 0) {
+      alignedFree(quaternionDecomposition);
+      quaternionDecomposition = nullptr;
+    }
+    else if (quaternionDecomposition)
+      throw_RTCError(RTC_ERROR_INVALID_OPERATION,"cannot mix matrix and quaternion transformations");
+
     local2world[timeStep] = xfm;
     if (timeStep == 0)
       world2local0 = rcp(xfm);
   }
 
+  void Instance::setQuaternionDecomposition(const QuaternionDecomposition& qd_in, unsigned int timeStep)
+  {
+    if (timeStep >= numTimeSteps)
+      throw_RTCError(RTC_ERROR_INVALID_OPERATION,"invalid timestep");
+
+    /* the representation of time step 0 determines how the instance gets interpolated */
+    if (timeStep == 0 && !quaternionDecomposition) {
+      quaternionDecomposition = (QuaternionDecomposition*) alignedMalloc(numTimeSteps*sizeof(QuaternionDecomposition),16);
+      for (size_t i = 0; i < numTimeSteps; i++)
+        quaternionDecomposition[i] = one;
+    }
+    else if (!quaternionDecomposition)
+      throw_RTCError(RTC_ERROR_INVALID_OPERATION,"cannot mix matrix and quaternion transformations");
+
+    QuaternionDecomposition qd = qd_in;
+    const float len = abs(qd.quaternion);
+    if (!(len > 0.0f))
+      throw_RTCError(RTC_ERROR_INVALID_ARGUMENT,"invalid quaternion");
+    qd.quaternion = qd.quaternion*rcp(len);
+
+    quaternionDecomposition[timeStep] = qd;
+    local2world[timeStep] = qd.affineSpace();
+    if (timeStep == 0)
+      world2local0 = rcp(local2world[0]);
+  }
+
+  BBox3fa Instance::nonlinearBounds(float t) const
+  {
+    t = clamp(t,0.0f,1.0f);
+    const float ftimef = t*fnumTimeSegments;
+    const int itime = min((int)floor(ftimef),(int)numTimeSegments()-1);
+    const QuaternionDecomposition qd = lerp(quaternionDecomposition[itime+0],quaternionDecomposition[itime+1],ftimef-float(itime));
+    return xfmBounds(qd.affineSpace(),objectBounds(t));
+  }
+
+  LBBox3fa Instance::nonlinearBounds(const BBox1f& dt) const
+  {
+    assert(quaternionDecomposition);
+    const float rcp_dt_size = rcp(dt.size());
+    BBox3fa b0 = nonlinearBounds(dt.lower);
+    BBox3fa b1 = nonlinearBounds(dt.upper);
+
+    /* grows the linear bounds to contain box b at relative time f */
+    auto include = [&] (float f, const BBox3fa& b)
+    {
+      const BBox3fa bt = lerp(b0,b1,f);
+      const Vec3fa dlower = min(b.lower-bt.lower,Vec3fa(zero));
+      const Vec3fa dupper = max(b.upper-bt.upper,Vec3fa(zero));
+      b0.lower += dlower; b1.lower += dlower;
+      b0.upper += dupper; b1.upper += dupper;
+    };
+
+    /* outside the geometry time range the instance does not move */
+    const float lower = max(dt.lower,0.0f);
+    const float upper = min(dt.upper,1.0f);
+    const int ilower = max((int)floor(lower*fnumTimeSegments),0);
+    const int iupper = min((int)ceil(upper*fnumTimeSegments),(int)numTimeSegments());
+
+    for (int itime = ilower; itime < iupper; itime++)
+    {
+      const float t0 = max(lower,float(itime+0)/fnumTimeSegments);
+      const float t1 = min(upper,float(itime+1)/fnumTimeSegments);
+      if (t1 <= t0) continue;
+
+      /* the motion p(t) = T(t) + R(t)*S(t)*x(t) of each point inside the
+       * segment is bounded in its second derivative, which bounds the distance
+       * of the sweep from the chord between two samples by |p''|*h^2/8 */
+      const QuaternionDecomposition& qd0 = quaternionDecomposition[itime+0];
+      const QuaternionDecomposition& qd1 = quaternionDecomposition[itime+1];
+      const AffineSpace3fa S0 = qd0.scaleSkewShift();
+      const AffineSpace3fa S1 = qd1.scaleSkewShift();
+      const BBox3fa ob0 = objectBounds(float(itime+0)/fnumTimeSegments);
+      const BBox3fa ob1 = objectBounds(float(itime+1)/fnumTimeSegments);
+      const BBox3fa ob = merge(ob0,ob1);
+
+      float ymax = 0.0f, dymax = 0.0f;
+      for (size_t c=0; c<8; c++)
+      {
+        const Vec3fa p((c & 1) ? ob.upper.x : ob.lower.x,
+                       (c & 2) ? ob.upper.y : ob.lower.y,
+                       (c & 4) ? ob.upper.z : ob.lower.z);
+        const Vec3fa y0 = xfmPoint(S0,p);
+        const Vec3fa y1 = xfmPoint(S1,p);
+        ymax  = max(ymax,length(y0),length(y1));
+        dymax = max(dymax,length(y1-y0));
+      }
+      auto norm = [] (const LinearSpace3fa& l) { return sqrt(dot(l.vx,l.vx)+dot(l.vy,l.vy)+dot(l.vz,l.vz)); };
+      const float dx = length(max(abs(ob1.lower-ob0.lower),abs(ob1.upper-ob0.upper)));
+      dymax += max(norm(S0.l),norm(S1.l))*dx;
+      const float ddy = 2.0f*norm(S1.l-S0.l)*dx;
+      const float theta = rotationAngle(qd0.quaternion,qd1.quaternion);
+      const float ddp = theta*theta*ymax + 2.0f*theta*dymax + ddy;
+
+      /* take more samples the more the segment rotates */
+      const float h_segment = (t1-t0)*fnumTimeSegments;
+      const int   N = clamp((int)ceil(theta*h_segment*(16.0f/float(pi))),1,32);
+      const float h = h_segment/float(N);
+      const float eps = 1.01f*ddp*h*h*0.125f + 1E-5f*ymax;
+
+      include((t0-dt.lower)*rcp_dt_size,enlarge(nonlinearBounds(t0),Vec3fa(eps)));
+      for (int k=1; k<=N; k++)
+      {
+        const float t = k == N ? t1 : lerp(t0,t1,float(k)/float(N));
+        include((t-dt.lower)*rcp_dt_size,enlarge(nonlinearBounds(t),Vec3fa(eps)));
+      }
+    }
+    return LBBox3fa(b0,b1);
+  }
+
   AffineSpace3fa Instance::getTransform(float time)
   {
     if (likely(numTimeSteps <= 1))
@@ -95,7 +261,7 @@ namespace embree
   void Instance::setMask (unsigned mask) 
   {
     this->mask = mask; 
-    Geometry::update();
+    Geometry::updateMask();
   }
   
 #endif
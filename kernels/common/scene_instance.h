@@ -40,37 +40,88 @@ namespace embree
     virtual void disabling();
     virtual void setNumTimeSteps (unsigned int numTimeSteps);
     virtual void setInstancedScene(const Ref<Scene>& scene);
+    virtual void setInstancedSceneLevel(unsigned int level, const Ref<Scene>& scene, float distance);
     virtual void setTransform(const AffineSpace3fa& local2world, unsigned int timeStep);
+    virtual void setQuaternionDecomposition(const QuaternionDecomposition& qd, unsigned int timeStep);
     virtual AffineSpace3fa getTransform(float time);
     virtual void setMask (unsigned mask);
     virtual void build() {}
 
   public:
 
+    /*! returns the number of levels of detail of the instanced scene */
+    __forceinline size_t numLevels() const {
+      return levels.size()+1;
+    }
+
+    /*! returns the instanced scene of the l'th level of detail */
+    __forceinline Accel* getLevel(size_t l) const {
+      return l == 0 ? object : levels[l-1].object;
+    }
+
+    /*! selects the level of detail for a ray starting at the specified world space origin */
+    __forceinline Accel* getLevel(const Vec3fa& org, float lodScale) const
+    {
+      if (likely(levels.size() == 0)) return object;
+      const float distance = length(org-local2world[0].p)*lodScale;
+      for (size_t l=levels.size(); l>0; l--)
+        if (distance >= levels[l-1].distance) return levels[l-1].object;
+      return object;
+    }
+
+    /*! calculates the bounds of all levels of detail of the instanced scene */
+    __forceinline BBox3fa objectBounds() const
+    {
+      BBox3fa b = object->bounds.bounds();
+      for (size_t l=0; l<levels.size(); l++)
+        b.extend(levels[l].object->bounds.bounds());
+      return b;
+    }
+
+    /*! calculates the bounds of all levels of detail of the instanced scene at time t */
+    __forceinline BBox3fa objectBounds(float t) const
+    {
+      BBox3fa b = object->getBounds(t);
+      for (size_t l=0; l<levels.size(); l++)
+        b.extend(levels[l].object->getBounds(t));
+      return b;
+    }
+
      /*! calculates the bounds of instance */
     __forceinline BBox3fa bounds(size_t i) const {
       assert(i == 0);
-      return xfmBounds(local2world[0],object->bounds.bounds());
+      return xfmBounds(local2world[0],objectBounds());
     }
 
      /*! calculates the bounds of instance */
     __forceinline BBox3fa bounds(size_t i, size_t itime) const {
       assert(i == 0);
-      return xfmBounds(local2world[itime],object->getBounds(float(itime)/fnumTimeSegments));
+      return xfmBounds(local2world[itime],objectBounds(float(itime)/fnumTimeSegments));
     }
 
      /*! calculates the linear bounds at the itimeGlobal'th time segment */
     __forceinline LBBox3fa linearBounds(size_t i, size_t itime) const {
       assert(i == 0);
+      if (unlikely(quaternionDecomposition))
+        return nonlinearBounds(BBox1f(float(itime+0)/fnumTimeSegments,float(itime+1)/fnumTimeSegments));
       return LBBox3fa(bounds(i,itime+0),bounds(i,itime+1));
     }
 
     /*! calculates the linear bounds of the i'th primitive for the specified time range */
     __forceinline LBBox3fa linearBounds(size_t i, const BBox1f& dt) const {
       assert(i == 0);
+      if (unlikely(quaternionDecomposition))
+        return nonlinearBounds(BBox1f((dt.lower-time_range.lower)/time_range.size(),(dt.upper-time_range.lower)/time_range.size()));
       return LBBox3fa([&] (size_t itime) { return bounds(i, itime); }, dt, time_range, fnumTimeSegments);
     }
 
+    /*! calculates conservative linear bounds of the rotational sweep of a
+     *  quaternion decomposed instance for a local time range */
+    LBBox3fa nonlinearBounds(const BBox1f& dt) const;
+
+    /*! calculates the bounds of a quaternion decomposed instance at local time t */
+    BBox3fa nonlinearBounds(float t) const;
+
     /*! check if the i'th primitive is valid between the specified time range */
     __forceinline bool valid(size_t i, const range<size_t>& itime_range) const
     {
@@ -88,6 +139,8 @@ namespace embree
     __forceinline AffineSpace3fa getLocal2World(float t) const
     {
       float ftime; const unsigned int itime = timeSegment(t, ftime);
+      if (unlikely(quaternionDecomposition))
+        return lerp(quaternionDecomposition[itime+0],quaternionDecomposition[itime+1],ftime).affineSpace();
       return lerp(local2world[itime+0],local2world[itime+1],ftime);
     }
 
@@ -105,6 +158,21 @@ namespace embree
       vfloat<K> ftime;
       const vint<K> itime_k = timeSegment(t, ftime);
       assert(any(valid));
+      if (unlikely(quaternionDecomposition))
+      {
+        /* rotations get interpolated per ray */
+        AffineSpace3vf<K> world2local;
+        size_t bits = movemask(valid);
+        while (bits) {
+          const size_t k = bscf(bits);
+          const AffineSpace3fa xfm = getWorld2Local(t[k]);
+          world2local.l.vx.x[k] = xfm.l.vx.x; world2local.l.vx.y[k] = xfm.l.vx.y; world2local.l.vx.z[k] = xfm.l.vx.z;
+          world2local.l.vy.x[k] = xfm.l.vy.x; world2local.l.vy.y[k] = xfm.l.vy.y; world2local.l.vy.z[k] = xfm.l.vy.z;
+          world2local.l.vz.x[k] = xfm.l.vz.x; world2local.l.vz.y[k] = xfm.l.vz.y; world2local.l.vz.z[k] = xfm.l.vz.z;
+          world2local.p.x[k]    = xfm.p.x;    world2local.p.y[k]    = xfm.p.y;    world2local.p.z[k]    = xfm.p.z;
+        }
+        return world2local;
+      }
       const size_t index = bsf(movemask(valid));
       const int itime = itime_k[index];
       const vfloat<K> t0 = vfloat<K>(1.0f)-ftime, t1 = ftime;
@@ -125,8 +193,16 @@ namespace embree
     
   public:
     Accel* object;                 //!< pointer to instanced acceleration structure
+
+    struct Level
+    {
+      Accel* object;               //!< instanced acceleration structure of this level of detail
+      float distance;              //!< minimal ray origin distance at which this level gets used
+    };
+    vector<Level> levels;          //!< coarser levels of detail with increasing distances
     AffineSpace3fa* local2world;   //!< transformation from local space to world space for each timestep
     AffineSpace3fa world2local0;   //!< transformation from world space to local space for timestep 0
+    QuaternionDecomposition* quaternionDecomposition; //!< decomposed transformation for each timestep if specified through quaternions, nullptr otherwise
   };
 
   namespace isa
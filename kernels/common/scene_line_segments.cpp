@@ -42,7 +42,7 @@ namespace embree
   void LineSegments::setMask (unsigned mask)
   {
     this->mask = mask;
-    Geometry::update();
+    Geometry::updateMask();
   }
 
   void LineSegments::setNumTimeSteps (unsigned int numTimeSteps)
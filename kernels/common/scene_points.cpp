@@ -47,7 +47,7 @@ namespace embree
   void Points::setMask(unsigned mask)
   {
     this->mask = mask;
-    Geometry::update();
+    Geometry::updateMask();
   }
 
   void Points::setNumTimeSteps(unsigned int numTimeSteps)
@@ -22,7 +22,7 @@ namespace embree
 #if defined(EMBREE_LOWEST_ISA)
 
   QuadMesh::QuadMesh (Device* device)
-    : Geometry(device,GTY_QUAD_MESH,0,1)
+    : Geometry(device,GTY_QUAD_MESH,0,1), useLeafOrderVertices(false)
   {
     vertices.resize(numTimeSteps);
   }
@@ -42,12 +42,13 @@ namespace embree
   void QuadMesh::setMask (unsigned mask) 
   {
     this->mask = mask; 
-    Geometry::update();
+    Geometry::updateMask();
   }
 
   void QuadMesh::setNumTimeSteps (unsigned int numTimeSteps)
   {
     vertices.resize(numTimeSteps);
+    modifiedVertices.setAll();
     Geometry::setNumTimeSteps(numTimeSteps);
   }
 
@@ -78,6 +79,7 @@ namespace embree
       vertices[slot].set(buffer, offset, stride, num, format);
       vertices[slot].checkPadding16();
       vertices0 = vertices[0];
+      modifiedVertices.setAll();
     } 
     else if (type >= RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE)
     {
@@ -144,6 +146,7 @@ namespace embree
       if (slot >= vertices.size())
         throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "invalid buffer slot");
       vertices[slot].setModified(true);
+      modifiedVertices.setAll();
     }
     else if (type == RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE)
     {
@@ -159,6 +162,23 @@ namespace embree
     Geometry::update();
   }
 
+  void QuadMesh::updateBufferRange(RTCBufferType type, unsigned int slot, unsigned int first, unsigned int count)
+  {
+    if (type != RTC_BUFFER_TYPE_VERTEX) {
+      updateBuffer(type,slot);
+      return;
+    }
+
+    if (slot >= vertices.size())
+      throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "invalid buffer slot");
+    if (size_t(first)+size_t(count) > vertices[slot].size())
+      throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "invalid buffer range");
+
+    vertices[slot].setModified(true);
+    modifiedVertices.add(first,count);
+    Geometry::update();
+  }
+
   void QuadMesh::preCommit() 
   {
     /* verify that stride of all time steps are identical */
@@ -166,18 +186,39 @@ namespace embree
       if (vertices[t].getStride() != vertices[0].getStride())
         throw_RTCError(RTC_ERROR_INVALID_OPERATION,"stride of vertex buffers have to be identical for each time step");
 
+    /* the BVH may store leaf order vertices again during the scene build */
+    useLeafOrderVertices = false;
+
+    /* primitive references of modified meshes get created by streaming over mapped buffers */
+    if (isModified()) {
+      quads.advise(OS_ACCESS_SEQUENTIAL);
+      for (auto& buf : vertices)
+        buf.advise(OS_ACCESS_SEQUENTIAL);
+    }
+
     Geometry::preCommit();
   }
 
   void QuadMesh::postCommit() 
   {
-    scene->vertices[geomID] = (float*) vertices0.getPtr();
+    if (useLeafOrderVertices)
+      scene->vertices[geomID] = (float*) leafOrderVertices->data();
+    else {
+      scene->vertices[geomID] = (float*) vertices0.getPtr();
+      leafOrderVertices = nullptr;
+    }
+
+    /* indexed leaves page in mapped buffers on demand during traversal */
+    quads.advise(OS_ACCESS_RANDOM);
+    for (auto& buf : vertices)
+      buf.advise(OS_ACCESS_RANDOM);
 
     quads.setModified(false);
     for (auto& buf : vertices)
       buf.setModified(false);
     for (auto& attrib : vertexAttribs)
       attrib.setModified(false);
+    modifiedVertices.reset();
 
     Geometry::postCommit();
   }
@@ -35,8 +35,14 @@ namespace embree
       faceStartEdge(device,0),
       halfEdgeFace(device,0),
       invalid_face(device,0),
+      cameraLevels(device,0),
+      committed_vertices(device,0),
+      modified_face(device,0),
+      partial_update(false),
       commitCounter(0)
   {
+    tessellationCamera.enabled = false;
+    tessellationCamera.modified = false;
     
     vertices.resize(numTimeSteps);
     vertex_buffer_tags.resize(numTimeSteps);
@@ -61,7 +67,7 @@ namespace embree
   void SubdivMesh::setMask (unsigned mask) 
   {
     this->mask = mask; 
-    Geometry::update();
+    Geometry::updateMask();
   }
 
   void SubdivMesh::setSubdivisionMode (unsigned topologyID, RTCSubdivisionMode mode)
@@ -295,7 +301,8 @@ namespace embree
 
   void SubdivMesh::updateBuffer(RTCBufferType type, unsigned int slot)
   {
-    if (type != RTC_BUFFER_TYPE_LEVEL)
+    /* cached interpolation data of modified vertex buffers is invalidated during commit */
+    if (type != RTC_BUFFER_TYPE_LEVEL && type != RTC_BUFFER_TYPE_VERTEX)
       commitCounter++;
 
     if (type == RTC_BUFFER_TYPE_VERTEX)
@@ -369,6 +376,7 @@ namespace embree
   void SubdivMesh::setDisplacementFunction (RTCDisplacementFunctionN func) 
   {
     this->displFunc = func;
+    levels.setModified(true); // all patches have to be tessellated again
   }
 
   void SubdivMesh::setTessellationRate(float N)
@@ -377,6 +385,25 @@ namespace embree
     levels.setModified(true);
   }
 
+  void SubdivMesh::setTessellationCamera(const RTCTessellationCamera* camera)
+  {
+    if (camera == nullptr) {
+      tessellationCamera.enabled = false;
+      cameraLevels.clear();
+      levels.setModified(true);
+      return;
+    }
+
+    if (!(camera->fov > 0.0f) || !(camera->fov < float(pi)) || !(camera->edgeLength > 0.0f))
+      throw_RTCError(RTC_ERROR_INVALID_ARGUMENT,"invalid tessellation camera");
+
+    const float resolution = float(max(camera->width,camera->height));
+    tessellationCamera.enabled = true;
+    tessellationCamera.modified = true;
+    tessellationCamera.pos = Vec3fa(camera->pos_x,camera->pos_y,camera->pos_z);
+    tessellationCamera.scale = 0.5f*resolution/(tanf(0.5f*camera->fov)*camera->edgeLength);
+  }
+
   __forceinline uint64_t pair64(unsigned int x, unsigned int y) 
   {
     if (x<y) std::swap(x,y);
@@ -709,6 +736,31 @@ namespace embree
           halfEdgeFace[h++] = (unsigned int) f;
     }
     
+    /* calculate view dependent edge levels */
+    if (tessellationCamera.enabled && !levels && topology[0].vertexIndices)
+    {
+      if (tessellationCamera.modified || vertices[0].isModified() || topology[0].vertexIndices.isModified() || faceVertices.isModified())
+      {
+        cameraLevels.resize(numHalfEdges);
+        parallel_for( size_t(0), numFaces(), size_t(4096), [&](const range<size_t>& r) 
+        {
+          for (size_t f=r.begin(); f<r.end(); f++) 
+          {
+            const unsigned N = faceVertices[f];
+            const unsigned e = faceStartEdge[f];
+            for (unsigned de=0; de<N; de++)
+            {
+              const Vec3fa v0 = vertices[0][topology[0].vertexIndices[e+de]];
+              const Vec3fa v1 = vertices[0][topology[0].vertexIndices[e+(de+1)%N]];
+              cameraLevels[e+de] = getCameraEdgeLevel(v0,v1);
+            }
+          }
+        });
+        levels.setModified(true);
+      }
+      tessellationCamera.modified = false;
+    }
+
     /* create set with all vertex creases */
     if (vertex_creases.isModified() || vertex_crease_weights.isModified())
       vertexCreaseMap.init(vertex_creases,vertex_crease_weights);
@@ -721,6 +773,14 @@ namespace embree
     if (holes.isModified())
       holeSet.init(holes);
 
+    /* check if only vertices moved, as then only some faces have to be updated in dynamic scenes */
+    bool onlyVerticesModified = partial_update && scene && !scene->isStaticAccel() && numTimeSteps == 1;
+    onlyVerticesModified &= committed_vertices.size() == numVertices() && modified_face.size() == numFaces();
+    onlyVerticesModified &= !faceVertices.isModified() && !holes.isModified() && !levels.isModified();
+    onlyVerticesModified &= !edge_creases.isModified() && !edge_crease_weights.isModified();
+    onlyVerticesModified &= !vertex_creases.isModified() && !vertex_crease_weights.isModified();
+    for (auto& t: topology) onlyVerticesModified &= !t.vertexIndices.isModified();
+
     /* create topology */
     for (auto& t: topology)
       t.initializeHalfEdgeStructures();
@@ -731,6 +791,33 @@ namespace embree
     for (size_t i=0; i<vertexAttribs.size(); i++)
       if (vertexAttribs[i]) vertex_attrib_buffer_tags[i].resize(numFaces()*numInterpolationSlots4(vertexAttribs[i].getStride()));
 
+    /* detect faces affected by moved vertices */
+    partial_update = onlyVerticesModified;
+    if (partial_update) calculateModifiedFaces();
+
+    /* remember vertices for next commit of dynamic scenes */
+    if (scene && !scene->isStaticAccel() && numTimeSteps == 1) {
+      if (vertices[0].isModified() || committed_vertices.size() != numVertices())
+        copyCommittedVertices();
+    }
+    else
+      committed_vertices.clear();
+
+    /* invalidate cached interpolation data of modified vertex buffers */
+    bool verticesModified = false;
+    for (auto& buffer : vertices) verticesModified |= buffer.isModified();
+    if (partial_update) 
+    {
+      const size_t slots = numInterpolationSlots4(vertices[0].getStride());
+      for (size_t f=0; f<numFaces(); f++) {
+        if (!modified_face[f]) continue;
+        for (size_t i=0; i<slots; i++)
+          vertex_buffer_tags[0][interpolationSlot(f,i,vertices[0].getStride())].tag.reset();
+      }
+    }
+    else if (verticesModified)
+      commitCounter++;
+
     /* cleanup some state for static scenes */
     if (scene == nullptr || scene->isStaticAccel()) 
     {
@@ -757,6 +844,73 @@ namespace embree
     }
   }
 
+  void SubdivMesh::calculateModifiedFaces()
+  {
+    if (!vertices[0].isModified())
+      return;
+
+    enum { MOVED = 1, NEIGHBOR = 2 };
+    mvector<char> vertex_state(device,numVertices());
+    const BufferView<unsigned int>& indices = topology[0].vertexIndices;
+
+    /* detect moved vertices */
+    parallel_for( size_t(0), numVertices(), size_t(4096), [&](const range<size_t>& r) {
+      for (size_t i=r.begin(); i<r.end(); i++)
+        vertex_state[i] = vertices[0][i] != committed_vertices[i] ? MOVED : 0;
+    });
+
+    /* detect faces with moved vertices */
+    parallel_for( size_t(0), numFaces(), size_t(4096), [&](const range<size_t>& r) {
+      for (size_t f=r.begin(); f<r.end(); f++) {
+        char moved = 0;
+        for (size_t i=0; i<faceVertices[f]; i++)
+          moved |= vertex_state[indices[faceStartEdge[f]+i]];
+        if (moved) modified_face[f] |= 2;
+      }
+    });
+
+    /* all vertices of these faces have a moved vertex in their one ring */
+    for (size_t f=0; f<numFaces(); f++) {
+      if (!(modified_face[f] & 2)) continue;
+      for (size_t i=0; i<faceVertices[f]; i++)
+        vertex_state[indices[faceStartEdge[f]+i]] |= NEIGHBOR;
+    }
+
+    /* the patch of a face depends on the one rings of its vertices, 
+     * faces stay modified until the scene got committed */
+    parallel_for( size_t(0), numFaces(), size_t(4096), [&](const range<size_t>& r) {
+      for (size_t f=r.begin(); f<r.end(); f++) {
+        char modified = modified_face[f] & 1;
+        for (size_t i=0; i<faceVertices[f]; i++)
+          modified |= vertex_state[indices[faceStartEdge[f]+i]] & NEIGHBOR;
+        modified_face[f] = modified != 0;
+      }
+    });
+  }
+
+  void SubdivMesh::copyCommittedVertices()
+  {
+    committed_vertices.resize(numVertices());
+    parallel_for( size_t(0), numVertices(), size_t(4096), [&](const range<size_t>& r) {
+      for (size_t i=r.begin(); i<r.end(); i++) committed_vertices[i] = vertices[0][i];
+    });
+  }
+
+  void SubdivMesh::postCommit () 
+  {
+    /* the acceleration structure is up to date now, thus later commits
+     * of dynamic scenes only have to update the faces modified from now on */
+    if (scene && !scene->isStaticAccel() && numTimeSteps == 1) 
+    {
+      if (committed_vertices.size() != numVertices())
+        copyCommittedVertices();
+      modified_face.resize(numFaces());
+      memset(modified_face.data(),0,modified_face.size());
+      partial_update = true;
+    }
+    Geometry::postCommit();
+  }
+
   bool SubdivMesh::verify () 
   {
     /*! verify consistent size of vertex arrays */
@@ -76,8 +76,10 @@ namespace embree
     void* getBuffer(RTCBufferType type, unsigned int slot);
     void updateBuffer(RTCBufferType type, unsigned int slot);
     void setTessellationRate(float N);
+    void setTessellationCamera(const RTCTessellationCamera* camera);
     bool verify();
     void commit();
+    void postCommit();
     void setDisplacementFunction (RTCDisplacementFunctionN func);
     unsigned int getFirstHalfEdge(unsigned int faceID);
     unsigned int getFace(unsigned int edgeID);
@@ -117,6 +119,16 @@ namespace embree
       return topology[0].valid(i) && !invalidFace(i,j);
     }
 
+    /*! returns true if only the faces marked as modified changed with the last commit */
+    __forceinline bool partiallyModified() const {
+      return partial_update;
+    }
+
+    /*! check if the i'th face changed with the last commit */
+    __forceinline bool faceModified(size_t i) const {
+      return modified_face[i];
+    }
+
     /*! prints some statistics */
     void printStatistics();
 
@@ -134,9 +146,17 @@ namespace embree
     __forceinline float getEdgeLevel(const size_t i) const
     {
       if (levels) return clamp(levels[i],1.0f,4096.0f); // FIXME: do we want to limit edge level?
+      else if (cameraLevels.size()) return clamp(cameraLevels[i],1.0f,4096.0f);
       else return clamp(tessellationRate,1.0f,4096.0f); // FIXME: do we want to limit edge level?
     }
 
+    /*! calculates the view dependent level of the edge from v0 to v1 */
+    __forceinline float getCameraEdgeLevel(const Vec3fa& v0, const Vec3fa& v1) const
+    {
+      const float dist = length(0.5f*(v0+v1)-tessellationCamera.pos);
+      return tessellationCamera.scale*length(v1-v0)*rcp(max(dist,1E-6f));
+    }
+
   public:
     RTCDisplacementFunctionN displFunc;    //!< displacement function
 
@@ -270,6 +290,15 @@ namespace embree
     BufferView<float> levels;
     float tessellationRate;  // constant rate that is used when levels is not set
 
+    /*! camera used to calculate view dependent edge levels when levels is not set */
+    struct TessellationCamera
+    {
+      bool enabled;
+      bool modified;
+      Vec3fa pos;
+      float scale;           //!< projected edge level of an edge of unit length at unit distance
+    } tessellationCamera;
+
     /*! buffer that marks specific faces as holes */
     BufferView<unsigned> holes;
 
@@ -295,6 +324,24 @@ namespace embree
     __forceinline       char& invalidFace(size_t i, size_t j = 0)       { return invalid_face[i*numTimeSteps+j]; }
     __forceinline const char& invalidFace(size_t i, size_t j = 0) const { return invalid_face[i*numTimeSteps+j]; }
 
+    /*! view dependent level for each half edge */
+    mvector<float> cameraLevels;
+
+    /*! copy of the vertices of the last commit, used to detect moved vertices in dynamic scenes */
+    mvector<Vec3fa> committed_vertices;
+
+    /*! marks faces whose patches depend on moved vertices */
+    mvector<char> modified_face;
+
+    /*! true if only faces marked in modified_face changed with the last commit */
+    bool partial_update;
+
+    /*! copies the current vertices to committed_vertices */
+    void copyCommittedVertices();
+
+    /*! marks all faces that have a moved vertex in their one ring */
+    void calculateModifiedFaces();
+
     /*! interpolation cache */
   public:
     static __forceinline size_t numInterpolationSlots4(size_t stride) { return (stride+15)/16; }
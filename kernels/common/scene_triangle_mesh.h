@@ -53,6 +53,7 @@ namespace embree
     void setBuffer(RTCBufferType type, unsigned int slot, RTCFormat format, const Ref<Buffer>& buffer, size_t offset, size_t stride, unsigned int num);
     void* getBuffer(RTCBufferType type, unsigned int slot);
     void updateBuffer(RTCBufferType type, unsigned int slot);
+    void updateBufferRange(RTCBufferType type, unsigned int slot, unsigned int first, unsigned int count);
     void preCommit();
     void postCommit();
     bool verify();
@@ -208,11 +209,28 @@ namespace embree
       return triangles.isModified() || numPrimitivesChanged;
     }
 
+    /* returns true if only the vertices of the modified vertex ranges changed */
+    bool partiallyModified() const {
+      return modifiedVertices.isPartial() && modifiedVertices.get().size();
+    }
+
+    /* returns storage for the first time step vertices in BVH leaf order */
+    Vec3fa* allocLeafOrderVertices(size_t num)
+    {
+      if (!leafOrderVertices || leafOrderVertices->bytes() < num*sizeof(Vec3fa))
+        leafOrderVertices = new Buffer(device,num*sizeof(Vec3fa));
+      useLeafOrderVertices = true;
+      return (Vec3fa*) leafOrderVertices->data();
+    }
+
   public:
     BufferView<Triangle> triangles;      //!< array of triangles
     BufferView<Vec3fa> vertices0;        //!< fast access to first vertex buffer
     vector<BufferView<Vec3fa>> vertices; //!< vertex array for each timestep
     vector<RawBufferView> vertexAttribs; //!< vertex attributes
+    ModifiedRanges modifiedVertices;     //!< vertex ranges modified since last commit
+    Ref<Buffer> leafOrderVertices;       //!< vertices in the order the BVH leaves reference them
+    bool useLeafOrderVertices;           //!< true if the BVH leaves index the leaf order vertices
   };
 
   namespace isa
@@ -37,7 +37,7 @@ namespace embree
   void UserGeometry::setMask (unsigned mask) 
   {
     this->mask = mask; 
-    Geometry::update();
+    Geometry::updateMask();
   }
 
   void UserGeometry::setBoundsFunction (RTCBoundsFunction bounds, void* userPtr) {
@@ -51,6 +51,15 @@ namespace embree
   void UserGeometry::setOccludedFunctionN (RTCOccludedFunctionN occluded) {
     intersectorN.occluded = occluded;
   }
+
+  void UserGeometry::setBatchSize (unsigned int batchSize) 
+  {
+    if (batchSize == 0)
+      throw_RTCError(RTC_ERROR_INVALID_ARGUMENT,"invalid batch size");
+
+    this->batchSize = min(batchSize,(unsigned int)maxBatchSize);
+    Geometry::update();
+  }
   
 #endif
 
@@ -34,6 +34,7 @@ namespace embree
     virtual void setBoundsFunction (RTCBoundsFunction bounds, void* userPtr);
     virtual void setIntersectFunctionN (RTCIntersectFunctionN intersect);
     virtual void setOccludedFunctionN (RTCOccludedFunctionN occluded);
+    virtual void setBatchSize (unsigned int batchSize);
     virtual void build() {}
   };
 
@@ -99,6 +99,10 @@ namespace embree
 
     tessellation_cache_size = 128*1024*1024;
 
+    autotune_sample_size = 64*1024;
+    autotune_num_rays = 16*1024;
+    autotune_max_memory_factor = 1.5f;
+
     subdiv_accel = "default";
     subdiv_accel_mb = "default";
 
@@ -130,6 +134,8 @@ namespace embree
     if (hasISA(AVX512KNL)) set_affinity = true;
 
     start_threads = false;
+    numa_aware = false;
+    idle_spin_time = -1;
     enable_selockmemoryprivilege = false;
 #if defined(__LINUX__)
     hugepages = true;
@@ -142,12 +148,18 @@ namespace embree
     alloc_num_main_slots = 0;
     alloc_thread_block_size = 0;
     alloc_single_thread_alloc = -1;
+    block_pool_size = 0;
+    block_pool_huge_pages = false;
 
     error_function = nullptr;
     error_function_userptr = nullptr;
 
     memory_monitor_function = nullptr;
     memory_monitor_userptr = nullptr;
+
+    alloc_function = nullptr;
+    free_function = nullptr;
+    alloc_userptr = nullptr;
   }
 
   State::~State() {
@@ -256,6 +268,12 @@ namespace embree
       
       else if (tok == Token::Id("start_threads")&& cin->trySymbol("=")) 
         start_threads = cin->get().Int();
+
+      else if (tok == Token::Id("numa_aware")&& cin->trySymbol("=")) 
+        numa_aware = cin->get().Int();
+
+      else if (tok == Token::Id("idle_spin_time")&& cin->trySymbol("=")) 
+        idle_spin_time = cin->get().Int();
       
       else if (tok == Token::Id("isa") && cin->trySymbol("=")) {
         std::string isa = toLowerCase(cin->get().Identifier());
@@ -429,6 +447,13 @@ namespace embree
       else if (tok == Token::Id("cache_size") && cin->trySymbol("="))
         tessellation_cache_size = size_t(cin->get().Float()*1024.0f*1024.0f);
 
+      else if (tok == Token::Id("autotune_sample_size") && cin->trySymbol("="))
+        autotune_sample_size = cin->get().Int();
+      else if (tok == Token::Id("autotune_num_rays") && cin->trySymbol("="))
+        autotune_num_rays = cin->get().Int();
+      else if (tok == Token::Id("autotune_max_memory_factor") && cin->trySymbol("="))
+        autotune_max_memory_factor = cin->get().Float();
+
       else if (tok == Token::Id("alloc_main_block_size") && cin->trySymbol("="))
         alloc_main_block_size = cin->get().Int();
        else if (tok == Token::Id("alloc_num_main_slots") && cin->trySymbol("="))
@@ -438,6 +463,11 @@ namespace embree
        else if (tok == Token::Id("alloc_single_thread_alloc") && cin->trySymbol("="))
          alloc_single_thread_alloc = cin->get().Int();
 
+      else if (tok == Token::Id("block_pool_size") && cin->trySymbol("="))
+        block_pool_size = size_t(cin->get().Float()*1024.0f*1024.0f);
+      else if (tok == Token::Id("block_pool_huge_pages") && cin->trySymbol("="))
+        block_pool_huge_pages = cin->get().Int();
+
       cin->trySymbol(","); // optional , separator
     }
   }
@@ -452,6 +482,8 @@ namespace embree
     std::cout << "  build threads = " << numThreads   << std::endl;
     std::cout << "  start_threads = " << start_threads << std::endl;
     std::cout << "  affinity      = " << set_affinity << std::endl;
+    std::cout << "  numa_aware    = " << numa_aware << std::endl;
+    std::cout << "  idle_spin_time = " << idle_spin_time << std::endl;
     std::cout << "  frequency_level = ";
     switch (frequency_level) {
     case FREQUENCY_SIMD128: std::cout << "simd128" << std::endl; break;
@@ -467,7 +499,12 @@ namespace embree
 
     std::cout << "  verbosity     = " << verbose << std::endl;
     std::cout << "  cache_size    = " << float(tessellation_cache_size)*1E-6 << " MB" << std::endl;
+    std::cout << "  block_pool_size = " << float(block_pool_size)*1E-6 << " MB" << std::endl;
+    std::cout << "  block_pool_huge_pages = " << block_pool_huge_pages << std::endl;
     std::cout << "  max_spatial_split_replications = " << max_spatial_split_replications << std::endl;
+    std::cout << "  autotune_sample_size = " << autotune_sample_size << std::endl;
+    std::cout << "  autotune_num_rays = " << autotune_num_rays << std::endl;
+    std::cout << "  autotune_max_memory_factor = " << autotune_max_memory_factor << std::endl;
     
     std::cout << "triangles:" << std::endl;
     std::cout << "  accel         = " << tri_accel << std::endl;
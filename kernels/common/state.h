@@ -120,6 +120,11 @@ namespace embree
     bool useSpatialPreSplits;              //!< use spatial pre-splits instead of the full spatial split builder
     size_t tessellation_cache_size;        //!< size of the shared tessellation cache 
 
+  public:
+    size_t autotune_sample_size;           //!< number of primitives the autotuner builds candidate acceleration structures over
+    size_t autotune_num_rays;              //!< number of rays the autotuner traces through each candidate
+    float  autotune_max_memory_factor;     //!< candidates may use at most that factor more memory than the smallest candidate
+
   public:
     size_t instancing_open_min;            //!< instancing opens tree to minimally that number of subtrees
     size_t instancing_block_size;          //!< instancing opens tree up to average block size of primitives
@@ -139,6 +144,8 @@ namespace embree
     size_t numThreads;                     //!< number of threads to use in builders
     bool set_affinity;                     //!< sets affinity for worker threads
     bool start_threads;                    //!< true when threads should be started at device creation time
+    bool numa_aware;                       //!< worker threads first steal tasks from threads of the same NUMA node
+    ssize_t idle_spin_time;                //!< microseconds idle worker threads spin before they get parked, negative values disable parking
     int enabled_cpu_features;              //!< CPU ISA features to use
     int enabled_builder_cpu_features;      //!< CPU ISA features to use for builders only
     enum FREQUENCY_LEVEL {
@@ -155,6 +162,8 @@ namespace embree
     int alloc_num_main_slots;              //!< number of such shared blocks to be used to allocate
     size_t alloc_thread_block_size;        //!< size of thread local allocator block size
     int alloc_single_thread_alloc;         //!< in single mode nodes and leaves use same thread local allocator
+    size_t block_pool_size;                //!< maximal number of bytes of freed allocation blocks the device retains for reuse
+    bool block_pool_huge_pages;            //!< allocates pooled allocation blocks with huge pages
 
   public:
 
@@ -202,5 +211,10 @@ namespace embree
       
     RTCMemoryMonitorFunction memory_monitor_function;
     void* memory_monitor_userptr;
+
+  public:
+    RTCAllocFunction alloc_function;
+    RTCFreeFunction free_function;
+    void* alloc_userptr;
   };
 }
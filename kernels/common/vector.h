@@ -18,9 +18,12 @@
 
 namespace embree
 {
-  /*! invokes the memory monitor callback */
+  /*! invokes the memory monitor callback and the application allocator */
   struct MemoryMonitorInterface {
     virtual void memoryMonitor(ssize_t bytes, bool post) = 0;
+    virtual bool hasAllocator() const = 0;
+    virtual void* allocMemory(size_t bytes, size_t align, RTCAllocationCategory category) = 0;
+    virtual void freeMemory(void* ptr, size_t bytes, RTCAllocationCategory category) = 0;
   };
 
   /*! allocator that performs aligned monitored allocations */
@@ -36,31 +39,23 @@ namespace embree
       typedef std::ptrdiff_t difference_type;
       
       __forceinline aligned_monitored_allocator(MemoryMonitorInterface* device) 
-        : device(device), hugepages(false) {}
+        : device(device) {}
 
       __forceinline pointer allocate( size_type n ) 
       {
-        if (n) {
-          assert(device);
-          device->memoryMonitor(n*sizeof(T),false);
-        }
-        if (n*sizeof(value_type) >= 14 * PAGE_SIZE_2M)
-        {
-          pointer p =  (pointer) os_malloc(n*sizeof(value_type),hugepages);
-          assert(p);
-          return p;
-        }
-        return (pointer) alignedMalloc(n*sizeof(value_type),alignment);
+        if (n == 0)
+          return nullptr;
+        
+        assert(device);
+        device->memoryMonitor(n*sizeof(T),false);
+        return (pointer) device->allocMemory(n*sizeof(value_type),alignment,RTC_ALLOCATION_CATEGORY_PRIMREFS);
       }
 
       __forceinline void deallocate( pointer p, size_type n ) 
       {
-        if (p)
-        {
-          if (n*sizeof(value_type) >= 14 * PAGE_SIZE_2M)
-            os_free(p,n*sizeof(value_type),hugepages); 
-          else
-            alignedFree(p);
+        if (p) {
+          assert(device);
+          device->freeMemory(p,n*sizeof(value_type),RTC_ALLOCATION_CATEGORY_PRIMREFS);
         }
         else assert(n == 0);
 
@@ -80,7 +75,6 @@ namespace embree
 
     private:
       MemoryMonitorInterface* device;
-      bool hugepages;
     };
 
   /*! monitored vector */
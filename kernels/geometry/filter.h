@@ -65,6 +65,7 @@ namespace embree
     {
 #if defined(EMBREE_FILTER_FUNCTION)
       IntersectContext* MAYBE_UNUSED context = args->internal_context;
+      if (context->isOpaque()) return;
       const Geometry* const geometry = args->geometry;
       if (geometry->intersectionFilterN) {
         assert(context->scene->hasGeometryFilterFunction());
@@ -119,6 +120,7 @@ namespace embree
     {
 #if defined(EMBREE_FILTER_FUNCTION)
       IntersectContext* MAYBE_UNUSED context = args->internal_context;
+      if (context->isOpaque()) return;
       const Geometry* const geometry = args->geometry;
       if (geometry->occlusionFilterN) {
         assert(context->scene->hasGeometryFilterFunction());
@@ -62,6 +62,18 @@ namespace embree
         return new (data) GridSOA(patches,time_steps,x0,x1,y0,y1,patches->grid_u_res,patches->grid_v_res,scene->get<SubdivMesh>(patches->geomID()),bvhBytes,gridBytes,bounds_o);
       }
 
+      /*! Subgrid recreation inside the memory of a subgrid of same size */
+      static GridSOA* update(GridSOA* grid, const SubdivPatch1Base* patches, const unsigned time_steps,
+                             unsigned x0, unsigned x1, unsigned y0, unsigned y1, 
+                             const Scene* scene, BBox3fa* bounds_o = nullptr)
+      {
+        assert(grid->time_steps == time_steps);
+        assert(grid->width == x1-x0+1 && grid->height == y1-y0+1);
+        const size_t bvhBytes = grid->gridOffset;
+        const size_t gridBytes = grid->gridBytes;
+        return new (grid) GridSOA(patches,time_steps,x0,x1,y0,y1,patches->grid_u_res,patches->grid_v_res,scene->get<SubdivMesh>(patches->geomID()),bvhBytes,gridBytes,bounds_o);
+      }
+
       /*! Grid creation */
       template<typename Allocator>
         static GridSOA* create(const SubdivPatch1Base* const patches, const unsigned time_steps,
@@ -21,6 +21,27 @@ namespace embree
 {
   namespace isa
   {
+    /* invokes the function once for each level of detail selected by some valid ray */
+    template<int K, typename Func>
+    static __forceinline void foreachLevel(const vbool<K>& valid, const Instance* instance, const Vec3vf<K>& org, float lodScale, const Func& func)
+    {
+      if (likely(instance->levels.size() == 0)) {
+        func(valid,instance->object);
+        return;
+      }
+
+      const Vec3fa p = instance->local2world[0].p;
+      const vfloat<K> distance = length(org-Vec3vf<K>(p.x,p.y,p.z))*lodScale;
+      vbool<K> todo = valid;
+      for (size_t l=instance->levels.size(); l>0 && any(todo); l--)
+      {
+        const vbool<K> vl = todo & (distance >= instance->levels[l-1].distance);
+        if (any(vl)) func(vl,instance->levels[l-1].object);
+        todo &= !vl;
+      }
+      if (any(todo)) func(todo,instance->object);
+    }
+
     void InstanceIntersector1::intersect(const Precalculations& pre, RayHit& ray, IntersectContext* context, const InstancePrimitive& prim)
     {
       const Instance* instance = prim.instance;
@@ -38,8 +59,10 @@ namespace embree
       ray.org = Vec3fa(xfmPoint (world2local,ray_org),ray.tnear());
       ray.dir = Vec3fa(xfmVector(world2local,ray_dir),ray.time());      
       user_context->instID[0] = instance->geomID;
-      IntersectContext newcontext((Scene*)instance->object,user_context);
-      instance->object->intersectors.intersect((RTCRayHit&)ray,&newcontext);
+      Accel* object = instance->getLevel(ray_org,user_context->lodScale);
+      ((Scene*)object)->buildLazy();
+      IntersectContext newcontext((Scene*)object,user_context);
+      object->intersectors.intersect((RTCRayHit&)ray,&newcontext);
       user_context->instID[0] = -1;
       ray.org = ray_org;
       ray.dir = ray_dir;
@@ -62,8 +85,10 @@ namespace embree
       ray.org = Vec3fa(xfmPoint (world2local,ray_org),ray.tnear());
       ray.dir = Vec3fa(xfmVector(world2local,ray_dir),ray.time());
       user_context->instID[0] = instance->geomID;
-      IntersectContext newcontext((Scene*)instance->object,user_context);
-      instance->object->intersectors.occluded((RTCRay&)ray,&newcontext);
+      Accel* object = instance->getLevel(ray_org,user_context->lodScale);
+      ((Scene*)object)->buildLazy();
+      IntersectContext newcontext((Scene*)object,user_context);
+      object->intersectors.occluded((RTCRay&)ray,&newcontext);
       user_context->instID[0] = -1;
       ray.org = ray_org;
       ray.dir = ray_dir;
@@ -87,8 +112,10 @@ namespace embree
       ray.org = Vec3fa(xfmPoint (world2local,ray_org),ray.tnear());
       ray.dir = Vec3fa(xfmVector(world2local,ray_dir),ray.time());      
       user_context->instID[0] = instance->geomID;
-      IntersectContext newcontext((Scene*)instance->object,user_context);
-      instance->object->intersectors.intersect((RTCRayHit&)ray,&newcontext);
+      Accel* object = instance->getLevel(ray_org,user_context->lodScale);
+      ((Scene*)object)->buildLazy();
+      IntersectContext newcontext((Scene*)object,user_context);
+      object->intersectors.intersect((RTCRayHit&)ray,&newcontext);
       user_context->instID[0] = -1;
       ray.org = ray_org;
       ray.dir = ray_dir;
@@ -111,8 +138,10 @@ namespace embree
       ray.org = Vec3fa(xfmPoint (world2local,ray_org),ray.tnear());
       ray.dir = Vec3fa(xfmVector(world2local,ray_dir),ray.time());
       user_context->instID[0] = instance->geomID;
-      IntersectContext newcontext((Scene*)instance->object,user_context);
-      instance->object->intersectors.occluded((RTCRay&)ray,&newcontext);
+      Accel* object = instance->getLevel(ray_org,user_context->lodScale);
+      ((Scene*)object)->buildLazy();
+      IntersectContext newcontext((Scene*)object,user_context);
+      object->intersectors.occluded((RTCRay&)ray,&newcontext);
       user_context->instID[0] = -1;
       ray.org = ray_org;
       ray.dir = ray_dir;
@@ -138,8 +167,11 @@ namespace embree
       ray.org = xfmPoint (world2local,ray_org);
       ray.dir = xfmVector(world2local,ray_dir);
       user_context->instID[0] = instance->geomID;
-      IntersectContext newcontext((Scene*)instance->object,user_context);
-      instance->object->intersectors.intersect(valid,ray,&newcontext);
+      foreachLevel<K>(valid,instance,ray_org,user_context->lodScale,[&] (const vbool<K>& valid, Accel* object) {
+          ((Scene*)object)->buildLazy();
+          IntersectContext newcontext((Scene*)object,user_context);
+          object->intersectors.intersect(valid,ray,&newcontext);
+        });
       user_context->instID[0] = -1;
       ray.org = ray_org;
       ray.dir = ray_dir;
@@ -164,8 +196,11 @@ namespace embree
       ray.org = xfmPoint (world2local,ray_org);
       ray.dir = xfmVector(world2local,ray_dir);
       user_context->instID[0] = instance->geomID;
-      IntersectContext newcontext((Scene*)instance->object,user_context);
-      instance->object->intersectors.occluded(valid,ray,&newcontext);
+      foreachLevel<K>(valid,instance,ray_org,user_context->lodScale,[&] (const vbool<K>& valid, Accel* object) {
+          ((Scene*)object)->buildLazy();
+          IntersectContext newcontext((Scene*)object,user_context);
+          object->intersectors.occluded(valid,ray,&newcontext);
+        });
       user_context->instID[0] = -1;
       ray.org = ray_org;
       ray.dir = ray_dir;
@@ -191,8 +226,11 @@ namespace embree
       ray.org = xfmPoint (world2local,ray_org);
       ray.dir = xfmVector(world2local,ray_dir);
       user_context->instID[0] = instance->geomID;
-      IntersectContext newcontext((Scene*)instance->object,user_context);
-      instance->object->intersectors.intersect(valid,ray,&newcontext);
+      foreachLevel<K>(valid,instance,ray_org,user_context->lodScale,[&] (const vbool<K>& valid, Accel* object) {
+          ((Scene*)object)->buildLazy();
+          IntersectContext newcontext((Scene*)object,user_context);
+          object->intersectors.intersect(valid,ray,&newcontext);
+        });
       user_context->instID[0] = -1;
       ray.org = ray_org;
       ray.dir = ray_dir;
@@ -217,8 +255,11 @@ namespace embree
       ray.org = xfmPoint (world2local,ray_org);
       ray.dir = xfmVector(world2local,ray_dir);
       user_context->instID[0] = instance->geomID;
-      IntersectContext newcontext((Scene*)instance->object,user_context);
-      instance->object->intersectors.occluded(valid,ray,&newcontext);
+      foreachLevel<K>(valid,instance,ray_org,user_context->lodScale,[&] (const vbool<K>& valid, Accel* object) {
+          ((Scene*)object)->buildLazy();
+          IntersectContext newcontext((Scene*)object,user_context);
+          object->intersectors.occluded(valid,ray,&newcontext);
+        });
       user_context->instID[0] = -1;
       ray.org = ray_org;
       ray.dir = ray_dir;
@@ -29,6 +29,33 @@ namespace embree
       __forceinline void operator() (vfloat<M>& u, vfloat<M>& v) const {}
     };
 
+    /* tests if the face culling flags of the context reject a surface hit */
+    __forceinline bool isCulledFace(const IntersectContext* context, const Geometry* geometry, const Vec3fa& Ng, const Vec3fa& dir)
+    {
+      if (!(geometry->getTypeMask() & Geometry::MTY_SURFACES)) return false;
+      const float den = dot(Ng,dir);
+      return (context->cullBackFaces() && den > 0.0f) || (context->cullFrontFaces() && den < 0.0f);
+    }
+
+    template<int K>
+    __forceinline vbool<K> isCulledFace(const IntersectContext* context, const Geometry* geometry, const Vec3vf<K>& Ng, const Vec3vf<K>& dir)
+    {
+      vbool<K> culled(False);
+      if (!(geometry->getTypeMask() & Geometry::MTY_SURFACES)) return culled;
+      const vfloat<K> den = dot(Ng,dir);
+      if (context->cullBackFaces())  culled |= den > vfloat<K>(zero);
+      if (context->cullFrontFaces()) culled |= den < vfloat<K>(zero);
+      return culled;
+    }
+
+    /* removes all hits from the valid mask that get rejected by face culling */
+    template<typename vboolx, typename Hit>
+    __forceinline void cullFaces(const IntersectContext* context, const Geometry* geometry, const Vec3fa& dir, vboolx& valid, Hit& hit)
+    {
+      for (size_t m=movemask(valid), i=bsf(m); m!=0; m=btc(m,i), i=bsf(m))
+        if (isCulledFace(context,geometry,hit.Ng(i),dir)) clear(valid,i);
+    }
+
     template<bool filter>
     struct Intersect1Epilog1
     {
@@ -52,12 +79,16 @@ namespace embree
 #if defined(EMBREE_RAY_MASK)
         if ((geometry->mask & ray.mask) == 0) return false;
 #endif
+
+        /* skip the primitive the context asks to ignore */
+        if (unlikely(context->isIgnored(geomID,primID))) return false;
+
         hit.finalize();
 
         /* intersection filter test */
 #if defined(EMBREE_FILTER_FUNCTION)
         if (filter) {
-          if (unlikely(context->hasContextFilter() || geometry->hasIntersectionFilter())) {
+          if (unlikely((context->hasContextFilter() || geometry->hasIntersectionFilter()) && !context->isOpaque())) {
             HitK<1> h(context->instID,geomID,primID,hit.u,hit.v,hit.Ng);
             const float old_t = ray.tfar;
             ray.tfar = hit.t;
@@ -105,12 +136,16 @@ namespace embree
 #if defined(EMBREE_RAY_MASK)
         if ((geometry->mask & ray.mask) == 0) return false;
 #endif
+
+        /* skip the primitive the context asks to ignore */
+        if (unlikely(context->isIgnored(geomID,primID))) return false;
+
         hit.finalize();
 
         /* intersection filter test */
 #if defined(EMBREE_FILTER_FUNCTION)
         if (filter) {
-          if (unlikely(context->hasContextFilter() || geometry->hasOcclusionFilter())) {
+          if (unlikely((context->hasContextFilter() || geometry->hasOcclusionFilter()) && !context->isOpaque())) {
             HitK<1> h(context->instID,geomID,primID,hit.u,hit.v,hit.Ng);
             const float old_t = ray.tfar;
             ray.tfar = hit.t;
@@ -149,12 +184,16 @@ namespace embree
         if ((geometry->mask & ray.mask[k]) == 0)
           return false;
 #endif
+
+        /* skip the primitive the context asks to ignore */
+        if (unlikely(context->isIgnored(geomID,primID))) return false;
+
         hit.finalize();
 
         /* intersection filter test */
 #if defined(EMBREE_FILTER_FUNCTION)
         if (filter) {
-          if (unlikely(context->hasContextFilter() || geometry->hasIntersectionFilter())) {
+          if (unlikely((context->hasContextFilter() || geometry->hasIntersectionFilter()) && !context->isOpaque())) {
             HitK<K> h(context->instID,geomID,primID,hit.u,hit.v,hit.Ng);
             const float old_t = ray.tfar[k];
             ray.tfar[k] = hit.t;
@@ -205,10 +244,13 @@ namespace embree
           return false;
 #endif
 
+        /* skip the primitive the context asks to ignore */
+        if (unlikely(context->isIgnored(geomID,primID))) return false;
+
         /* intersection filter test */
 #if defined(EMBREE_FILTER_FUNCTION)
         if (filter) {
-          if (unlikely(context->hasContextFilter() || geometry->hasOcclusionFilter())) {
+          if (unlikely((context->hasContextFilter() || geometry->hasOcclusionFilter()) && !context->isOpaque())) {
             hit.finalize();
             HitK<K> h(context->instID,geomID,primID,hit.u,hit.v,hit.Ng);
             const float old_t = ray.tfar[k];
@@ -248,7 +290,6 @@ namespace embree
         unsigned int geomID = geomIDs[i];
 
         /* intersection filter test */
-#if defined(EMBREE_FILTER_FUNCTION) || defined(EMBREE_RAY_MASK)
         bool foundhit = false;
         goto entry;
         while (true)
@@ -268,10 +309,22 @@ namespace embree
           }
 #endif
 
+          /* goto next hit if the context asks to ignore this primitive */
+          if (unlikely(context->isIgnored(geomID,primIDs[i]))) {
+            clear(valid,i);
+            continue;
+          }
+
+          /* goto next hit if face culling rejects it */
+          if (unlikely(context->hasFaceCulling()) && isCulledFace(context,geometry,hit.Ng(i),ray.dir)) {
+            clear(valid,i);
+            continue;
+          }
+
 #if defined(EMBREE_FILTER_FUNCTION) 
           /* call intersection filter function */
           if (filter) {
-            if (unlikely(context->hasContextFilter() || geometry->hasIntersectionFilter())) {
+            if (unlikely((context->hasContextFilter() || geometry->hasIntersectionFilter()) && !context->isOpaque())) {
               const Vec2f uv = hit.uv(i);
               HitK<1> h(context->instID,geomID,primIDs[i],uv.x,uv.y,hit.Ng(i));
               const float old_t = ray.tfar;
@@ -287,7 +340,6 @@ namespace embree
 #endif
           break;
         }
-#endif
 
         /* update hit information */
         const Vec2f uv = hit.uv(i);
@@ -355,7 +407,7 @@ namespace embree
 #if defined(EMBREE_FILTER_FUNCTION) 
           /* call intersection filter function */
           if (filter) {
-            if (unlikely(context->hasContextFilter() || geometry->hasIntersectionFilter())) {
+            if (unlikely((context->hasContextFilter() || geometry->hasIntersectionFilter()) && !context->isOpaque())) {
               const Vec2f uv = hit.uv(i);
               HitK<1> h(context->instID,geomID,primIDs[i],uv.x,uv.y,hit.Ng(i));
               const float old_t = ray.tfar;
@@ -400,9 +452,7 @@ namespace embree
       __forceinline bool operator() (const vbool<Mx>& valid_i, Hit& hit) const
       {
         Scene* scene = context->scene;
-        /* intersection filter test */
-#if defined(EMBREE_FILTER_FUNCTION) || defined(EMBREE_RAY_MASK)
-        if (unlikely(filter))
+        if (unlikely(filter || context->hasFaceCulling()))
           hit.finalize(); /* called only once */
 
         vbool<Mx> valid = valid_i;
@@ -426,10 +476,22 @@ namespace embree
           }
 #endif
 
+          /* goto next hit if the context asks to ignore this primitive */
+          if (unlikely(context->isIgnored(geomID,primIDs[i]))) {
+            m=btc(m,i);
+            continue;
+          }
+
+          /* goto next hit if face culling rejects it */
+          if (unlikely(context->hasFaceCulling()) && isCulledFace(context,geometry,hit.Ng(i),ray.dir)) {
+            m=btc(m,i);
+            continue;
+          }
+
 #if defined(EMBREE_FILTER_FUNCTION)
           /* if we have no filter then the test passed */
           if (filter) {
-            if (unlikely(context->hasContextFilter() || geometry->hasOcclusionFilter()))
+            if (unlikely((context->hasContextFilter() || geometry->hasOcclusionFilter()) && !context->isOpaque()))
             {
               const Vec2f uv = hit.uv(i);
               HitK<1> h(context->instID,geomID,primIDs[i],uv.x,uv.y,hit.Ng(i));
@@ -444,7 +506,6 @@ namespace embree
 #endif
           break;
         }
-#endif
 
         return true;
       }
@@ -475,14 +536,23 @@ namespace embree
         if ((geometry->mask & ray.mask) == 0) return false;
 #endif
 
+        /* skip the primitive the context asks to ignore */
+        if (unlikely(context->isIgnored(geomID,primID))) return false;
+
         vbool<M> valid = valid_i;
         hit.finalize();
 
+        /* face culling test */
+        if (unlikely(context->hasFaceCulling())) {
+          cullFaces(context,geometry,ray.dir,valid,hit);
+          if (unlikely(none(valid))) return false;
+        }
+
         size_t i = select_min(valid,hit.vt);
 
         /* intersection filter test */
 #if defined(EMBREE_FILTER_FUNCTION)
-        if (unlikely(context->hasContextFilter() || geometry->hasIntersectionFilter()))
+        if (unlikely((context->hasContextFilter() || geometry->hasIntersectionFilter()) && !context->isOpaque()))
         {
           bool foundhit = false;
           while (true)
@@ -535,7 +605,7 @@ namespace embree
         : ray(ray), context(context), geomID(geomID), primID(primID) {}
 
       template<typename Hit>
-      __forceinline bool operator() (const vbool<M>& valid, Hit& hit) const
+      __forceinline bool operator() (const vbool<M>& valid_i, Hit& hit) const
       {
         /* ray mask test */
         Scene* scene = context->scene;
@@ -544,9 +614,20 @@ namespace embree
         if ((geometry->mask & ray.mask) == 0) return false;
 #endif
 
+        /* skip the primitive the context asks to ignore */
+        if (unlikely(context->isIgnored(geomID,primID))) return false;
+
+        /* face culling test */
+        vbool<M> valid = valid_i;
+        if (unlikely(context->hasFaceCulling())) {
+          hit.finalize();
+          cullFaces(context,geometry,ray.dir,valid,hit);
+          if (unlikely(none(valid))) return false;
+        }
+
         /* intersection filter test */
 #if defined(EMBREE_FILTER_FUNCTION)
-        if (unlikely(context->hasContextFilter() || geometry->hasOcclusionFilter()))
+        if (unlikely((context->hasContextFilter() || geometry->hasOcclusionFilter()) && !context->isOpaque()))
         {
           hit.finalize();
           for (size_t m=movemask(valid), i=bsf(m); m!=0; m=btc(m,i), i=bsf(m))
@@ -602,10 +683,19 @@ namespace embree
         if (unlikely(none(valid))) return false;
 #endif
 
+        /* skip the primitive the context asks to ignore */
+        if (unlikely(context->isIgnored(geomID,primID))) return false;
+
+        /* face culling test */
+        if (unlikely(context->hasFaceCulling())) {
+          valid &= !isCulledFace(context,geometry,Ng,ray.dir);
+          if (unlikely(none(valid))) return false;
+        }
+
         /* occlusion filter test */
 #if defined(EMBREE_FILTER_FUNCTION)
         if (filter) {
-          if (unlikely(context->hasContextFilter() || geometry->hasIntersectionFilter())) {
+          if (unlikely((context->hasContextFilter() || geometry->hasIntersectionFilter()) && !context->isOpaque())) {
             HitK<K> h(context->instID,geomID,primID,u,v,Ng);
             const vfloat<K> old_t = ray.tfar;
             ray.tfar = select(valid,t,ray.tfar);
@@ -663,10 +753,22 @@ namespace embree
         if (unlikely(none(valid))) return valid;
 #endif
 
+        /* skip the primitive the context asks to ignore */
+        if (unlikely(context->isIgnored(geomID,primID))) return false;
+
+        /* face culling test */
+        if (unlikely(context->hasFaceCulling())) {
+          vfloat<K> u, v, t;
+          Vec3vf<K> Ng;
+          std::tie(u,v,t,Ng) = hit();
+          valid &= !isCulledFace(context,geometry,Ng,ray.dir);
+          if (unlikely(none(valid))) return valid;
+        }
+
         /* intersection filter test */
 #if defined(EMBREE_FILTER_FUNCTION)
         if (filter) {
-          if (unlikely(context->hasContextFilter() || geometry->hasOcclusionFilter()))
+          if (unlikely((context->hasContextFilter() || geometry->hasOcclusionFilter()) && !context->isOpaque()))
           {
             vfloat<K> u, v, t;
             Vec3vf<K> Ng;
@@ -717,10 +819,19 @@ namespace embree
         if (unlikely(none(valid))) return false;
 #endif
 
+        /* skip the primitive the context asks to ignore */
+        if (unlikely(context->isIgnored(geomID,primID))) return false;
+
+        /* face culling test */
+        if (unlikely(context->hasFaceCulling())) {
+          valid &= !isCulledFace(context,geometry,Ng,ray.dir);
+          if (unlikely(none(valid))) return false;
+        }
+
         /* intersection filter test */
 #if defined(EMBREE_FILTER_FUNCTION)
         if (filter) {
-          if (unlikely(context->hasContextFilter() || geometry->hasIntersectionFilter())) {
+          if (unlikely((context->hasContextFilter() || geometry->hasIntersectionFilter()) && !context->isOpaque())) {
             HitK<K> h(context->instID,geomID,primID,u,v,Ng);
             const vfloat<K> old_t = ray.tfar;
             ray.tfar = select(valid,t,ray.tfar);
@@ -773,10 +884,22 @@ namespace embree
         if (unlikely(none(valid))) return false;
 #endif
 
+        /* skip the primitive the context asks to ignore */
+        if (unlikely(context->isIgnored(geomID,primID))) return false;
+
+        /* face culling test */
+        if (unlikely(context->hasFaceCulling())) {
+          vfloat<K> u, v, t;
+          Vec3vf<K> Ng;
+          std::tie(u,v,t,Ng) = hit();
+          valid &= !isCulledFace(context,geometry,Ng,ray.dir);
+          if (unlikely(none(valid))) return false;
+        }
+
         /* occlusion filter test */
 #if defined(EMBREE_FILTER_FUNCTION)
         if (filter) {
-          if (unlikely(context->hasContextFilter() || geometry->hasOcclusionFilter()))
+          if (unlikely((context->hasContextFilter() || geometry->hasOcclusionFilter()) && !context->isOpaque()))
           {
             vfloat<K> u, v, t;
             Vec3vf<K> Ng;
@@ -823,7 +946,6 @@ namespace embree
         unsigned int geomID = geomIDs[i];
 
         /* intersection filter test */
-#if defined(EMBREE_FILTER_FUNCTION) || defined(EMBREE_RAY_MASK)
         bool foundhit = false;
         goto entry;
         while (true)
@@ -843,10 +965,22 @@ namespace embree
           }
 #endif
 
+          /* goto next hit if the context asks to ignore this primitive */
+          if (unlikely(context->isIgnored(geomID,primIDs[i]))) {
+            clear(valid,i);
+            continue;
+          }
+
+          /* goto next hit if face culling rejects it */
+          if (unlikely(context->hasFaceCulling()) && isCulledFace(context,geometry,hit.Ng(i),Vec3fa(ray.dir.x[k],ray.dir.y[k],ray.dir.z[k]))) {
+            clear(valid,i);
+            continue;
+          }
+
 #if defined(EMBREE_FILTER_FUNCTION) 
           /* call intersection filter function */
           if (filter) {
-            if (unlikely(context->hasContextFilter() || geometry->hasIntersectionFilter())) {
+            if (unlikely((context->hasContextFilter() || geometry->hasIntersectionFilter()) && !context->isOpaque())) {
               assert(i<M);
               const Vec2f uv = hit.uv(i);
               HitK<K> h(context->instID,geomID,primIDs[i],uv.x,uv.y,hit.Ng(i));
@@ -863,7 +997,6 @@ namespace embree
 #endif
           break;
         }
-#endif
         assert(i<M);
         /* update hit information */
 #if 0 && defined(__AVX512F__) // do not enable, this reduced frequency for BVH4
@@ -905,9 +1038,7 @@ namespace embree
       {
         Scene* scene = context->scene;
 
-        /* intersection filter test */
-#if defined(EMBREE_FILTER_FUNCTION) || defined(EMBREE_RAY_MASK)
-        if (unlikely(filter))
+        if (unlikely(filter || context->hasFaceCulling()))
           hit.finalize(); /* called only once */
 
         vbool<Mx> valid = valid_i;
@@ -931,10 +1062,22 @@ namespace embree
           }
 #endif
 
+          /* goto next hit if the context asks to ignore this primitive */
+          if (unlikely(context->isIgnored(geomID,primIDs[i]))) {
+            m=btc(m,i);
+            continue;
+          }
+
+          /* goto next hit if face culling rejects it */
+          if (unlikely(context->hasFaceCulling()) && isCulledFace(context,geometry,hit.Ng(i),Vec3fa(ray.dir.x[k],ray.dir.y[k],ray.dir.z[k]))) {
+            m=btc(m,i);
+            continue;
+          }
+
 #if defined(EMBREE_FILTER_FUNCTION)
           /* execute occlusion filer */
           if (filter) {
-            if (unlikely(context->hasContextFilter() || geometry->hasOcclusionFilter()))
+            if (unlikely((context->hasContextFilter() || geometry->hasOcclusionFilter()) && !context->isOpaque()))
             {
               const Vec2f uv = hit.uv(i);
               const float old_t = ray.tfar[k];
@@ -949,7 +1092,6 @@ namespace embree
 #endif
           break;
         }
-#endif
         return true;
       }
     };
@@ -980,15 +1122,25 @@ namespace embree
           return false;
 #endif
 
+        /* skip the primitive the context asks to ignore */
+        if (unlikely(context->isIgnored(geomID,primID))) return false;
+
         /* finalize hit calculation */
         vbool<M> valid = valid_i;
         hit.finalize();
+
+        /* face culling test */
+        if (unlikely(context->hasFaceCulling())) {
+          cullFaces(context,geometry,Vec3fa(ray.dir.x[k],ray.dir.y[k],ray.dir.z[k]),valid,hit);
+          if (unlikely(none(valid))) return false;
+        }
+
         size_t i = select_min(valid,hit.vt);
 
         /* intersection filter test */
 #if defined(EMBREE_FILTER_FUNCTION)
         if (filter) {
-          if (unlikely(context->hasContextFilter() || geometry->hasIntersectionFilter()))
+          if (unlikely((context->hasContextFilter() || geometry->hasIntersectionFilter()) && !context->isOpaque()))
           {
             bool foundhit = false;
             while (true)
@@ -1058,13 +1210,24 @@ namespace embree
           return false;
 #endif
 
+        /* skip the primitive the context asks to ignore */
+        if (unlikely(context->isIgnored(geomID,primID))) return false;
+
+        /* face culling test */
+        vbool<M> valid = valid_i;
+        if (unlikely(context->hasFaceCulling())) {
+          hit.finalize();
+          cullFaces(context,geometry,Vec3fa(ray.dir.x[k],ray.dir.y[k],ray.dir.z[k]),valid,hit);
+          if (unlikely(none(valid))) return false;
+        }
+
         /* intersection filter test */
 #if defined(EMBREE_FILTER_FUNCTION)
         if (filter) {
-          if (unlikely(context->hasContextFilter() || geometry->hasOcclusionFilter()))
+          if (unlikely((context->hasContextFilter() || geometry->hasOcclusionFilter()) && !context->isOpaque()))
           {
             hit.finalize();
-            for (size_t m=movemask(valid_i), i=bsf(m); m!=0; m=btc(m,i), i=bsf(m))
+            for (size_t m=movemask(valid), i=bsf(m); m!=0; m=btc(m,i), i=bsf(m))
             {
               const Vec2f uv = hit.uv(i);
               const float old_t = ray.tfar[k];
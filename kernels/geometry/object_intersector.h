@@ -17,6 +17,7 @@
 #pragma once
 
 #include "object.h"
+#include "intersector_iterators.h"
 #include "../common/ray.h"
 
 namespace embree
@@ -121,6 +122,170 @@ namespace embree
       }
     };
 
+    /*! gathers the primIDs of consecutive objects of the same geometry into a batch */
+    __forceinline size_t gatherObjectBatch(const AccelSet* accel, const Object* prim, size_t i, size_t num, unsigned int* primIDs)
+    {
+      const unsigned int geomID = prim[i].geomID();
+      const size_t end = min(num,i+accel->batchSize);
+      size_t n = 0;
+      for (; i+n<end && prim[i+n].geomID() == geomID; n++)
+        primIDs[n] = prim[i+n].primID();
+      return n;
+    }
+
+    /*! Intersects the objects of a leaf, passing batches of objects of the same geometry to a single callback invocation */
+    template<bool mblur>
+    struct ObjectArrayIntersector1
+    {
+      typedef Object Primitive;
+      typedef typename ObjectIntersector1<mblur>::Precalculations Precalculations;
+
+      template<int N, int Nx, bool robust>
+      static __forceinline void intersect(const Accel::Intersectors* This, Precalculations& pre, RayHit& ray, IntersectContext* context, const Primitive* prim, size_t num, const TravRay<N,Nx,robust> &tray, size_t& lazy_node)
+      {
+        unsigned int primIDs[AccelSet::maxBatchSize];
+        for (size_t i=0; i<num; )
+        {
+          AccelSet* accel = (AccelSet*) context->scene->get(prim[i].geomID());
+          const size_t n = gatherObjectBatch(accel,prim,i,num,primIDs);
+          i += n;
+
+          /* perform ray mask test */
+#if defined(EMBREE_RAY_MASK)
+          if ((ray.mask & accel->mask) == 0) 
+            continue;
+#endif
+          accel->intersect(ray,primIDs,n,context,reportIntersection1);
+        }
+      }
+
+      template<int N, int Nx, bool robust>
+      static __forceinline bool occluded(const Accel::Intersectors* This, Precalculations& pre, Ray& ray, IntersectContext* context, const Primitive* prim, size_t num, const TravRay<N,Nx,robust> &tray, size_t& lazy_node)
+      {
+        unsigned int primIDs[AccelSet::maxBatchSize];
+        for (size_t i=0; i<num; )
+        {
+          AccelSet* accel = (AccelSet*) context->scene->get(prim[i].geomID());
+          const size_t n = gatherObjectBatch(accel,prim,i,num,primIDs);
+          i += n;
+
+          /* perform ray mask test */
+#if defined(EMBREE_RAY_MASK)
+          if ((ray.mask & accel->mask) == 0) 
+            continue;
+#endif
+          accel->occluded(ray,primIDs,n,context,&reportOcclusion1);
+          if (ray.tfar < 0.0f)
+            return true;
+        }
+        return false;
+      }
+
+      template<int K>
+      static __forceinline void intersectK(const vbool<K>& valid, /* PrecalculationsK& pre, */ RayHitK<K>& ray, IntersectContext* context, const Primitive* prim, size_t num, size_t& lazy_node)
+      {
+      }
+
+      template<int K>
+      static __forceinline vbool<K> occludedK(const vbool<K>& valid, /* PrecalculationsK& pre, */ RayK<K>& ray, IntersectContext* context, const Primitive* prim, size_t num, size_t& lazy_node)
+      {
+        return valid;
+      }
+    };
+
+    /*! Intersects the objects of a leaf with a ray packet, passing batches of objects of the same geometry to a single callback invocation */
+    template<int K, bool mblur>
+    struct ObjectArrayIntersectorK_1
+    {
+      typedef Object Primitive;
+      typedef typename ObjectIntersectorK<K,mblur>::Precalculations Precalculations;
+
+      template<bool robust>
+      static __forceinline void intersect(const vbool<K>& valid_i, const Accel::Intersectors* This, Precalculations& pre, RayHitK<K>& ray, IntersectContext* context, const Primitive* prim, size_t num, const TravRayK<K, robust> &tray, size_t& lazy_node)
+      {
+        unsigned int primIDs[AccelSet::maxBatchSize];
+        for (size_t i=0; i<num; )
+        {
+          AccelSet* accel = (AccelSet*) context->scene->get(prim[i].geomID());
+          const size_t n = gatherObjectBatch(accel,prim,i,num,primIDs);
+          i += n;
+
+          /* perform ray mask test */
+          vbool<K> valid = valid_i;
+#if defined(EMBREE_RAY_MASK)
+          valid &= (ray.mask & accel->mask) != 0;
+          if (none(valid)) continue;
+#endif
+          accel->intersect(valid,ray,primIDs,n,context,&reportIntersection1);
+        }
+      }
+
+      template<bool robust>
+      static __forceinline vbool<K> occluded(const vbool<K>& valid_i, const Accel::Intersectors* This, Precalculations& pre, RayK<K>& ray, IntersectContext* context, const Primitive* prim, size_t num, const TravRayK<K, robust> &tray, size_t& lazy_node)
+      {
+        unsigned int primIDs[AccelSet::maxBatchSize];
+        vbool<K> valid0 = valid_i;
+        for (size_t i=0; i<num; )
+        {
+          AccelSet* accel = (AccelSet*) context->scene->get(prim[i].geomID());
+          const size_t n = gatherObjectBatch(accel,prim,i,num,primIDs);
+          i += n;
+
+          /* perform ray mask test */
+          vbool<K> valid = valid0;
+#if defined(EMBREE_RAY_MASK)
+          valid &= (ray.mask & accel->mask) != 0;
+          if (none(valid)) continue;
+#endif
+          accel->occluded(valid,ray,primIDs,n,context,&reportOcclusion1);
+          valid0 &= ray.tfar >= 0.0f;
+          if (none(valid0)) break;
+        }
+        return !valid0;
+      }
+
+      template<int N, int Nx, bool robust>
+      static __forceinline void intersect(const Accel::Intersectors* This, Precalculations& pre, RayHitK<K>& ray, size_t k, IntersectContext* context, const Primitive* prim, size_t num, const TravRay<N,Nx,robust> &tray, size_t& lazy_node)
+      {
+        unsigned int primIDs[AccelSet::maxBatchSize];
+        for (size_t i=0; i<num; )
+        {
+          AccelSet* accel = (AccelSet*) context->scene->get(prim[i].geomID());
+          const size_t n = gatherObjectBatch(accel,prim,i,num,primIDs);
+          i += n;
+
+          /* perform ray mask test */
+#if defined(EMBREE_RAY_MASK)
+          if ((ray.mask[k] & accel->mask) == 0) 
+            continue;
+#endif
+          accel->intersect(vbool<K>(1<<int(k)),ray,primIDs,n,context,&reportIntersection1);
+        }
+      }
+
+      template<int N, int Nx, bool robust>
+      static __forceinline bool occluded(const Accel::Intersectors* This, Precalculations& pre, RayK<K>& ray, size_t k, IntersectContext* context, const Primitive* prim, size_t num, const TravRay<N,Nx,robust> &tray, size_t& lazy_node)
+      {
+        unsigned int primIDs[AccelSet::maxBatchSize];
+        for (size_t i=0; i<num; )
+        {
+          AccelSet* accel = (AccelSet*) context->scene->get(prim[i].geomID());
+          const size_t n = gatherObjectBatch(accel,prim,i,num,primIDs);
+          i += n;
+
+          /* perform ray mask test */
+#if defined(EMBREE_RAY_MASK)
+          if ((ray.mask[k] & accel->mask) == 0) 
+            continue;
+#endif
+          accel->occluded(vbool<K>(1<<int(k)),ray,primIDs,n,context,&reportOcclusion1);
+          if (ray.tfar[k] < 0.0f)
+            return true;
+        }
+        return false;
+      }
+    };
+
     typedef ObjectIntersectorK<4,false>  ObjectIntersector4;
     typedef ObjectIntersectorK<8,false>  ObjectIntersector8;
     typedef ObjectIntersectorK<16,false> ObjectIntersector16;
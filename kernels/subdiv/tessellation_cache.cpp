@@ -23,12 +23,14 @@ namespace embree
   __thread ThreadWorkState* SharedLazyTessellationCache::init_t_state = nullptr;
   ThreadWorkState* SharedLazyTessellationCache::current_t_state = nullptr;
 
-  void resizeTessellationCache(size_t new_size)
+  void resizeTessellationCache(size_t new_size, RTCAllocFunction alloc, RTCFreeFunction free, void* userPtr)
   {    
     if (new_size >= SharedLazyTessellationCache::MAX_TESSELLATION_CACHE_SIZE)
       new_size = SharedLazyTessellationCache::MAX_TESSELLATION_CACHE_SIZE;
-    if (SharedLazyTessellationCache::sharedLazyTessellationCache.getSize() != new_size) 
-      SharedLazyTessellationCache::sharedLazyTessellationCache.realloc(new_size);    
+    if (new_size == 0) { alloc = nullptr; free = nullptr; userPtr = nullptr; }
+    if (SharedLazyTessellationCache::sharedLazyTessellationCache.getSize() != new_size ||
+        !SharedLazyTessellationCache::sharedLazyTessellationCache.usesAllocator(free,userPtr)) 
+      SharedLazyTessellationCache::sharedLazyTessellationCache.realloc(new_size,alloc,free,userPtr);    
   }
 
   void resetTessellationCache()
@@ -36,16 +38,31 @@ namespace embree
     //SharedLazyTessellationCache::sharedLazyTessellationCache.addCurrentIndex(SharedLazyTessellationCache::NUM_CACHE_SEGMENTS);
     SharedLazyTessellationCache::sharedLazyTessellationCache.reset();
   }
+
+  size_t getTessellationCacheHits() {
+    return SharedLazyTessellationCache::sharedLazyTessellationCache.getNumHits();
+  }
+
+  size_t getTessellationCacheMisses() {
+    return SharedLazyTessellationCache::sharedLazyTessellationCache.getNumMisses();
+  }
+
+  size_t getTessellationCacheEvictions() {
+    return SharedLazyTessellationCache::sharedLazyTessellationCache.getNumEvictions();
+  }
   
   SharedLazyTessellationCache::SharedLazyTessellationCache()
   {
     size = 0;
     data = nullptr;
     hugepages = false;
+    freeFunction = nullptr;
+    allocUserPtr = nullptr;
     maxBlocks              = size/BLOCK_SIZE;
     localTime              = NUM_CACHE_SEGMENTS;
     next_block             = 0;
     numRenderThreads       = 0;
+    numEvictions           = 0;
 #if FORCE_SIMPLE_FLUSH == 1
     switch_block_threshold = maxBlocks;
 #else
@@ -94,6 +111,38 @@ namespace embree
      }
    }
 
+  void SharedLazyTessellationCache::waitForUsersBefore(ThreadWorkState *const t_state,
+                                                       const size_t time)
+  {
+    while (t_state->counter.load() != 0 && t_state->epoch.load() < time)
+    {
+      _mm_pause();
+      _mm_pause();
+      _mm_pause();
+      _mm_pause();
+    }
+  }
+
+  size_t SharedLazyTessellationCache::getNumHits()
+  {
+    size_t hits = 0;
+    linkedlist_mtx.lock();
+    for (ThreadWorkState *t=current_t_state;t!=nullptr;t=t->next)
+      hits += t->hits.load(std::memory_order_relaxed);
+    linkedlist_mtx.unlock();
+    return hits;
+  }
+
+  size_t SharedLazyTessellationCache::getNumMisses()
+  {
+    size_t misses = 0;
+    linkedlist_mtx.lock();
+    for (ThreadWorkState *t=current_t_state;t!=nullptr;t=t->next)
+      misses += t->misses.load(std::memory_order_relaxed);
+    linkedlist_mtx.unlock();
+    return misses;
+  }
+
   void SharedLazyTessellationCache::allocNextSegment() 
   {
     if (reset_state.try_lock())
@@ -104,14 +153,16 @@ namespace embree
         
         linkedlist_mtx.lock();
         
-        /* block all threads */
-        for (ThreadWorkState *t=current_t_state;t!=nullptr;t=t->next)
-          if (lockThread(t,THREAD_BLOCK_ATOMIC_ADD) != 0)
-            waitForUsersLessEqual(t,THREAD_BLOCK_ATOMIC_ADD);
-        
-        /* switch to the next segment */
+        /* switch to the next segment, threads entering from now on no longer
+         * accept entries of the segment that gets recycled */
         addCurrentIndex();
+        const size_t time = localTime.load();
         CACHE_STATS(PRINT("RESET TESS CACHE"));
+
+        /* only wait for threads that entered the cache before the switch, 
+         * all other threads continue to use the cache without blocking */
+        for (ThreadWorkState *t=current_t_state;t!=nullptr;t=t->next)
+          waitForUsersBefore(t,time);
         
 #if FORCE_SIMPLE_FLUSH == 1
         next_block = 0;
@@ -124,17 +175,11 @@ namespace embree
 #endif
         
         CACHE_STATS(SharedTessellationCacheStats::cache_flushes++);
-        
-        /* release all blocked threads */
-        
-        for (ThreadWorkState *t=current_t_state;t!=nullptr;t=t->next)
-          unlockThread(t,-THREAD_BLOCK_ATOMIC_ADD);
+        numEvictions++;
         
         /* unlock the linked list of thread states */
         
         linkedlist_mtx.unlock();
-	
-        
       }
       reset_state.unlock();
     }
@@ -164,8 +209,10 @@ namespace embree
     switch_block_threshold = maxBlocks/NUM_CACHE_SEGMENTS;
 #endif
 
-    /* reset local time */
+    /* reset local time, as time runs backwards also reset the entry time of all threads */
     localTime = NUM_CACHE_SEGMENTS;
+    for (ThreadWorkState *t=current_t_state;t!=nullptr;t=t->next)
+      t->epoch = 0;
 
     /* release all blocked threads */
     for (ThreadWorkState *t=current_t_state;t!=nullptr;t=t->next)
@@ -178,7 +225,7 @@ namespace embree
     reset_state.unlock();
   }
 
-  void SharedLazyTessellationCache::realloc(const size_t new_size)
+  void SharedLazyTessellationCache::realloc(const size_t new_size, RTCAllocFunction new_alloc_function, RTCFreeFunction new_free_function, void* new_alloc_userptr)
   {
     /* lock the reset_state */
     reset_state.lock();
@@ -192,10 +239,24 @@ namespace embree
         waitForUsersLessEqual(t,THREAD_BLOCK_ATOMIC_ADD);
 
     /* reallocate data */
-    if (data) os_free(data,size,hugepages);
-    size      = new_size;
-    data      = nullptr;
-    if (size) data = (float*)os_malloc(size,hugepages);
+    if (data) {
+      if (freeFunction) freeFunction(allocUserPtr,data,size,RTC_ALLOCATION_CATEGORY_TESSELLATION_CACHE);
+      else              os_free(data,size,hugepages);
+    }
+    size         = new_size;
+    data         = nullptr;
+    freeFunction = nullptr;
+    allocUserPtr = nullptr;
+    if (size && new_alloc_function) {
+      data = (float*)new_alloc_function(new_alloc_userptr,size,64,RTC_ALLOCATION_CATEGORY_TESSELLATION_CACHE);
+      freeFunction = new_free_function;
+      allocUserPtr = new_alloc_userptr;
+    }
+    if (size && !data) {
+      freeFunction = nullptr;
+      allocUserPtr = nullptr;
+      data = (float*)os_malloc(size,hugepages);
+    }
     maxBlocks = size/BLOCK_SIZE;    
 
     /* invalidate entire cache */
@@ -47,8 +47,11 @@ namespace embree
     static void clearStats();
   };
   
-  void resizeTessellationCache(size_t new_size);
+  void resizeTessellationCache(size_t new_size, RTCAllocFunction alloc, RTCFreeFunction free, void* userPtr);
   void resetTessellationCache();
+  size_t getTessellationCacheHits();
+  size_t getTessellationCacheMisses();
+  size_t getTessellationCacheEvictions();
   
  ////////////////////////////////////////////////////////////////////////////////
  ////////////////////////////////////////////////////////////////////////////////
@@ -59,14 +62,21 @@ namespace embree
    ALIGNED_STRUCT_(64);
 
    std::atomic<size_t> counter;
+   std::atomic<size_t> epoch;  //!< cache time at which the thread acquired its lock
+   std::atomic<size_t> hits;   //!< number of cache hits of this thread
+   std::atomic<size_t> misses; //!< number of cache misses of this thread
    ThreadWorkState* next;
    bool allocated;
 
    __forceinline ThreadWorkState(bool allocated = false) 
-     : counter(0), next(nullptr), allocated(allocated) 
+     : counter(0), epoch(0), hits(0), misses(0), next(nullptr), allocated(allocated) 
    {
      assert( ((size_t)this % 64) == 0 ); 
    }   
+
+   /* counters are only written by the owning thread, thus no atomic add required */
+   __forceinline void countHit () { hits.store(hits.load(std::memory_order_relaxed)+1,std::memory_order_relaxed); }
+   __forceinline void countMiss() { misses.store(misses.load(std::memory_order_relaxed)+1,std::memory_order_relaxed); }
  };
 
  class __aligned(64) SharedLazyTessellationCache 
@@ -143,6 +153,8 @@ namespace embree
    float *data;
    bool hugepages;
    size_t size;
+   RTCFreeFunction freeFunction;        //!< application function to free the data, or nullptr
+   void* allocUserPtr;                  //!< user pointer of the application allocator
    size_t maxBlocks;
    ThreadWorkState *threadWorkState;
       
@@ -152,7 +164,7 @@ namespace embree
    __aligned(64) SpinLock   linkedlist_mtx;
    __aligned(64) std::atomic<size_t> switch_block_threshold;
    __aligned(64) std::atomic<size_t> numRenderThreads;
-
+   __aligned(64) std::atomic<size_t> numEvictions;
 
  public:
 
@@ -174,7 +186,13 @@ namespace embree
    }
 
 
-   __forceinline size_t lockThread  (ThreadWorkState *const t_state, const ssize_t plus=1) { return t_state->counter.fetch_add(plus);  }
+   __forceinline size_t lockThread  (ThreadWorkState *const t_state, const ssize_t plus=1) 
+   { 
+     const size_t prev = t_state->counter.fetch_add(plus);
+     /* record the time the thread entered the cache, segment switches only wait for threads that entered earlier */
+     if (plus == 1 && prev == 0) t_state->epoch.store(localTime.load());
+     return prev;
+   }
    __forceinline size_t unlockThread(ThreadWorkState *const t_state, const ssize_t plus=-1) { assert(isLocked(t_state)); return t_state->counter.fetch_add(plus); }
 
    __forceinline bool isLocked(ThreadWorkState *const t_state) { return t_state->counter.load() != 0; }
@@ -206,7 +224,7 @@ namespace embree
      }
    }
 
-   static __forceinline void* lookup(CacheEntry& entry, size_t globalTime)
+   static __forceinline void* lookup(ThreadWorkState *const t_state, CacheEntry& entry, size_t globalTime)
    {   
      const int64_t subdiv_patch_root_ref = entry.tag.get(); 
      CACHE_STATS(SharedTessellationCacheStats::cache_accesses++);
@@ -219,6 +237,7 @@ namespace embree
        if (likely( sharedLazyTessellationCache.validCacheIndex(subdiv_patch_cache_index,globalTime) ))
        {
          CACHE_STATS(SharedTessellationCacheStats::cache_hits++);
+         t_state->countHit();
          return (void*) subdiv_patch_root;
        }
      }
@@ -234,13 +253,14 @@ namespace embree
      while (true)
      {
        sharedLazyTessellationCache.lockThreadLoop(t_state);
-       void* patch = SharedLazyTessellationCache::lookup(entry,globalTime);
+       void* patch = SharedLazyTessellationCache::lookup(t_state,entry,globalTime);
        if (patch) return (decltype(constructor())) patch;
        
        if (entry.mutex.try_lock())
        {
          if (!validTag(entry.tag,globalTime)) 
          {
+           t_state->countMiss();
            auto timeBefore = sharedLazyTessellationCache.getTime(globalTime);
            auto ret = constructor(); // thread is locked here!
            assert(ret);
@@ -284,6 +304,9 @@ namespace embree
 
    void waitForUsersLessEqual(ThreadWorkState *const t_state,
 			      const unsigned int users);
+
+   void waitForUsersBefore(ThreadWorkState *const t_state,
+                           const size_t time);
     
    __forceinline size_t alloc(const size_t blocks)
    {
@@ -327,9 +350,14 @@ namespace embree
    __forceinline size_t getNumUsedBytes() { return next_block * BLOCK_SIZE; }
    __forceinline size_t getMaxBlocks()    { return maxBlocks; }
    __forceinline size_t getSize()         { return size; }
+   __forceinline bool   usesAllocator(RTCFreeFunction free, void* userPtr) { return freeFunction == free && allocUserPtr == userPtr; }
+
+   size_t getNumHits();
+   size_t getNumMisses();
+   __forceinline size_t getNumEvictions() { return numEvictions.load(); }
 
    void allocNextSegment();
-   void realloc(const size_t newSize);
+   void realloc(const size_t newSize, RTCAllocFunction allocFunction, RTCFreeFunction freeFunction, void* allocUserPtr);
 
    void reset();
 
@@ -998,6 +998,104 @@ namespace embree
     }
   };
 
+  struct MappedBufferTest : public VerifyApplication::Test
+  {
+    static const unsigned int N = 16;
+
+    RTCGeometryType gtype;
+
+    MappedBufferTest (std::string name, int isa, RTCGeometryType gtype)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), gtype(gtype) {}
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+
+      /* writes a file with some header followed by the index and vertex data of a grid */
+      const unsigned int numIndices = gtype == RTC_GEOMETRY_TYPE_TRIANGLE ? 6*N*N : 4*N*N;
+      std::vector<unsigned int> indices; indices.reserve(numIndices);
+      for (unsigned int y=0; y<N; y++) {
+        for (unsigned int x=0; x<N; x++) {
+          const unsigned int v00 = (y+0)*(N+1)+(x+0), v01 = (y+0)*(N+1)+(x+1);
+          const unsigned int v10 = (y+1)*(N+1)+(x+0), v11 = (y+1)*(N+1)+(x+1);
+          if (gtype == RTC_GEOMETRY_TYPE_TRIANGLE) {
+            indices.push_back(v00); indices.push_back(v01); indices.push_back(v11);
+            indices.push_back(v00); indices.push_back(v11); indices.push_back(v10);
+          } else {
+            indices.push_back(v00); indices.push_back(v01); indices.push_back(v11); indices.push_back(v10);
+          }
+        }
+      }
+      std::vector<float> vertices;
+      for (unsigned int y=0; y<=N; y++) {
+        for (unsigned int x=0; x<=N; x++) {
+          vertices.push_back(float(x)); vertices.push_back(float(y)); vertices.push_back(0.0f);
+        }
+      }
+      const size_t headerBytes = 12;
+      const size_t indexBytes = indices.size()*sizeof(unsigned int);
+      const size_t vertexBytes = vertices.size()*sizeof(float);
+      const std::string fileName = (FileName::executableFolder()+FileName("mapped_buffer_"+name+"_"+stringOfISA(isa)+".bin")).str();
+      {
+        std::ofstream file(fileName,std::ios::binary);
+        const char header[headerBytes] = {};
+        file.write(header,headerBytes);
+        file.write((const char*)indices.data(),indexBytes);
+        file.write((const char*)vertices.data(),vertexBytes);
+      }
+
+      /* invalid files and file regions are reported */
+      if (rtcNewMappedBuffer(device,(fileName+".missing").c_str(),0,4) != nullptr) return VerifyApplication::FAILED;
+      AssertError(device,RTC_ERROR_INVALID_ARGUMENT);
+      if (rtcNewMappedBuffer(device,fileName.c_str(),headerBytes+indexBytes,vertexBytes+4) != nullptr) return VerifyApplication::FAILED;
+      AssertError(device,RTC_ERROR_INVALID_ARGUMENT);
+      if (rtcNewMappedBuffer(device,fileName.c_str(),2,indexBytes) != nullptr) return VerifyApplication::FAILED;
+      AssertError(device,RTC_ERROR_INVALID_ARGUMENT);
+
+      RTCBuffer indexBuffer = rtcNewMappedBuffer(device,fileName.c_str(),headerBytes,indexBytes);
+      RTCBuffer vertexBuffer = rtcNewMappedBuffer(device,fileName.c_str(),headerBytes+indexBytes,vertexBytes);
+      AssertNoError(device);
+      if (memcmp(rtcGetBufferData(vertexBuffer),vertices.data(),vertexBytes) != 0) return VerifyApplication::FAILED;
+
+      {
+        RTCSceneRef scene = rtcNewScene(device);
+        RTCGeometry geom = rtcNewGeometry(device,gtype);
+        if (gtype == RTC_GEOMETRY_TYPE_TRIANGLE)
+          rtcSetGeometryBuffer(geom,RTC_BUFFER_TYPE_INDEX,0,RTC_FORMAT_UINT3,indexBuffer,0,3*sizeof(unsigned int),2*N*N);
+        else
+          rtcSetGeometryBuffer(geom,RTC_BUFFER_TYPE_INDEX,0,RTC_FORMAT_UINT4,indexBuffer,0,4*sizeof(unsigned int),N*N);
+        rtcSetGeometryBuffer(geom,RTC_BUFFER_TYPE_VERTEX,0,RTC_FORMAT_FLOAT3,vertexBuffer,0,3*sizeof(float),(N+1)*(N+1));
+        rtcReleaseBuffer(indexBuffer);
+        rtcReleaseBuffer(vertexBuffer);
+        rtcCommitGeometry(geom);
+        rtcAttachGeometry(scene,geom);
+        rtcReleaseGeometry(geom);
+        rtcCommitScene(scene);
+        AssertNoError(device);
+
+        /* every cell is hit through its lower right triangle */
+        RTCIntersectContext context;
+        rtcInitIntersectContext(&context);
+        for (unsigned int y=0; y<N; y++)
+        {
+          for (unsigned int x=0; x<N; x++)
+          {
+            RTCRayHit ray = makeRay(Vec3fa(float(x)+0.7f,float(y)+0.2f,10.0f),Vec3fa(0.0f,0.0f,-1.0f));
+            rtcIntersect1(scene,&context,&ray);
+            const unsigned int primID = gtype == RTC_GEOMETRY_TYPE_TRIANGLE ? 2*(y*N+x) : y*N+x;
+            if (ray.hit.geomID != 0 || ray.hit.primID != primID) return VerifyApplication::FAILED;
+            if (abs(ray.ray.tfar-10.0f) > 1E-4f) return VerifyApplication::FAILED;
+          }
+        }
+      }
+      AssertNoError(device);
+      std::remove(fileName.c_str());
+      return VerifyApplication::PASSED;
+    }
+  };
+
   /////////////////////////////////////////////////////////////////////////////////
   /////////////////////////////////////////////////////////////////////////////////
   /////////////////////////////////////////////////////////////////////////////////
@@ -1158,6 +1256,66 @@ namespace embree
     }
   };
 
+  struct CommitScenesTest : public VerifyApplication::Test
+  {
+    SceneFlags sflags;
+
+    CommitScenesTest (std::string name, int isa, SceneFlags sflags)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+    
+    VerifyApplication::TestReturnValue run (VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+
+      /* one small and one large object scene per instance */
+      const unsigned int numObjects = 16;
+      std::vector<Ref<VerifyScene>> objects;
+      for (unsigned int i=0; i<numObjects; i++) {
+        objects.push_back(new VerifyScene(device,sflags));
+        objects.back()->addSphere(sampler,RTC_BUILD_QUALITY_MEDIUM,Vec3fa(3.0f*i,0.0f,0.0f),1.0f,i%2 ? 100 : 10);
+      }
+
+      VerifyScene scene(device,sflags);
+      for (unsigned int i=0; i<numObjects; i++) {
+        RTCGeometry instance = rtcNewGeometry(device,RTC_GEOMETRY_TYPE_INSTANCE);
+        rtcSetGeometryInstancedScene(instance,*objects[i]);
+        const float xfm[12] = { 1,0,0, 0,1,0, 0,0,1, 0,0,0 };
+        rtcSetGeometryTransform(instance,0,RTC_FORMAT_FLOAT3X4_COLUMN_MAJOR,xfm);
+        rtcCommitGeometry(instance);
+        rtcAttachGeometryByID(scene,instance,i);
+        rtcReleaseGeometry(instance);
+      }
+      AssertNoError(device);
+
+      /* instancing scene first to test the commit order, duplicates get committed once */
+      std::vector<RTCScene> scenes;
+      scenes.push_back(scene);
+      for (auto& object : objects) scenes.push_back(*object);
+      scenes.push_back(*objects[0]);
+      rtcCommitScenes(scenes.data(),scenes.size());
+      AssertNoError(device);
+
+      /* committing unmodified scenes again does nothing */
+      rtcCommitScenes(scenes.data(),scenes.size());
+      AssertNoError(device);
+
+      for (unsigned int i=0; i<numObjects; i++)
+      {
+        RTCIntersectContext context;
+        rtcInitIntersectContext(&context);
+        RTCRayHit ray = makeRay(Vec3fa(3.0f*i,0.0f,-10.0f),Vec3fa(0.0f,0.0f,1.0f));
+        rtcIntersect1(scene,&context,&ray);
+        if (ray.hit.instID[0] != i) return VerifyApplication::FAILED;
+        if (abs(ray.ray.tfar-9.0f) > 0.1f) return VerifyApplication::FAILED;
+      }
+      AssertNoError(device);
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
   struct OverlappingGeometryTest : public VerifyApplication::Test
   {
     SceneFlags sflags;
@@ -1724,50 +1882,88 @@ namespace embree
     }
   };
 
-  struct GarbageGeometryTest : public VerifyApplication::Test
+  struct UpdateMotionBlurTest : public VerifyApplication::IntersectTest
   {
-    GarbageGeometryTest (std::string name, int isa)
-      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS) {}
-    
+    SceneFlags sflags;
+
+    UpdateMotionBlurTest (std::string name, int isa, SceneFlags sflags, IntersectMode imode, IntersectVariant ivariant)
+      : VerifyApplication::IntersectTest(name,isa,imode,ivariant,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+
+    static void move_mesh(RTCGeometry mesh, size_t numVertices, unsigned int itime, const Vec3fa& pos)
+    {
+      Vec3fa* vertices = (Vec3fa*) rtcGetGeometryBufferData(mesh,RTC_BUFFER_TYPE_VERTEX,itime);
+      for (size_t i=0; i<numVertices; i++)
+        vertices[i] += Vec3fa(pos);
+      rtcUpdateGeometryBuffer(mesh,RTC_BUFFER_TYPE_VERTEX,itime);
+    }
+
     VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
     {
-      std::string cfg = state->rtcore + "isa="+stringOfISA(isa);
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
       RTCDeviceRef device = rtcNewDevice(cfg.c_str());
       errorHandler(nullptr,rtcGetDeviceError(device));
+      if (!supportsIntersectMode(device,imode))
+        return VerifyApplication::SKIPPED;
 
-      for (size_t i=0; i<size_t(1000*state->intensity); i++)
-      {
-        RandomSampler_init(sampler,int(i*23565));
-        if (i%20 == 0) std::cout << "." << std::flush;
+      VerifyScene scene(device,sflags);
+      AssertNoError(device);
+      const unsigned int numTimeSteps = 3;
+      avector<Vec3fa> motion_vector;
+      motion_vector.push_back(Vec3fa(0.0f));
+      motion_vector.push_back(Vec3fa(0.5f,0.0f,0.0f));
+      motion_vector.push_back(Vec3fa(1.0f,0.0f,0.0f));
+      size_t numPhi = 10;
+      size_t numVertices = 2*numPhi*(numPhi+1);
+      Vec3fa pos[2][numTimeSteps];
+      for (unsigned int t=0; t<numTimeSteps; t++) {
+        pos[0][t] = Vec3fa(-10,0,0) + motion_vector[t];
+        pos[1][t] = Vec3fa(+10,0,0) + motion_vector[t];
+      }
+      RTCGeometry hgeom[2];
+      hgeom[0] = rtcGetGeometry(scene,scene.addSphere    (sampler,RTC_BUILD_QUALITY_MEDIUM,pos[0][0],1.0f,numPhi,-1,motion_vector).first);
+      hgeom[1] = rtcGetGeometry(scene,scene.addQuadSphere(sampler,RTC_BUILD_QUALITY_MEDIUM,pos[1][0],1.0f,numPhi,-1,motion_vector).first);
+      AssertNoError(device);
 
-        SceneFlags sflags = getSceneFlags(i); 
-        VerifyScene scene(device,sflags);
-        AssertNoError(device);
-        
-        for (size_t j=0; j<20; j++) 
+      for (size_t i=0; i<8; i++)
+      {
+        /* deform the meshes by moving each time step by a different amount */
+        for (size_t g=0; g<2; g++)
         {
-          size_t numPrimitives = random_int()%256;
-          switch (random_int()%10) {
-          case 0: scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createGarbageTriangleMesh(random_int(),numPrimitives,false)); break;
-          case 1: scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createGarbageTriangleMesh(random_int(),numPrimitives,true )); break;
-          case 2: scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createGarbageQuadMesh(random_int(),numPrimitives,false)); break;
-          case 3: scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createGarbageQuadMesh(random_int(),numPrimitives,true )); break;
-          case 4: scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createGarbageGridMesh(random_int(),numPrimitives,false)); break;
-          case 5: scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createGarbageGridMesh(random_int(),numPrimitives,true )); break;
-          case 6: scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createGarbageHair(random_int(),numPrimitives,false)); break;
-          case 7: scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createGarbageHair(random_int(),numPrimitives,true )); break;
-          case 8: scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createGarbageLineSegments(random_int(),numPrimitives,false)); break;
-          case 9: scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createGarbageLineSegments(random_int(),numPrimitives,true )); break;
-          case 10: scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createGarbagePointSet(random_int(),numPrimitives,false)); break;
-          case 11: scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createGarbagePointSet(random_int(),numPrimitives,true )); break;
-            //case 12: scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createGarbageSubdivMesh(random_int(),numPrimitives,false)); break; // FIXME: not working yet
-            //case 13: scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createGarbageSubdivMesh(random_int(),numPrimitives,true )); break;
+          if (i & (size_t(1) << g)) continue;
+          for (unsigned int t=0; t<numTimeSteps; t++) {
+            const Vec3fa ds = Vec3fa(0.5f,0.1f,0.5f)*float(t+1);
+            move_mesh(hgeom[g],numVertices,t,ds);
+            pos[g][t] += ds;
           }
-          AssertNoError(device);
+          rtcCommitGeometry(hgeom[g]);
         }
-        
-        rtcCommitScene(scene);
+        rtcCommitScene (scene);
         AssertNoError(device);
+
+        RTCRayHit testRays[2*numTimeSteps];
+        for (size_t g=0; g<2; g++) {
+          for (unsigned int t=0; t<numTimeSteps; t++) {
+            RTCRayHit ray = makeRay(pos[g][t]+Vec3fa(0,10,0),Vec3fa(0,-1,0));
+            ray.ray.time = float(t)/float(numTimeSteps-1);
+            testRays[g*numTimeSteps+t] = ray;
+          }
+        }
+
+        const unsigned int maxRays = 100;
+        RTCRayHit rays[maxRays];
+        for (unsigned int numRays=1; numRays<maxRays; numRays++) {
+          for (size_t i=0; i<numRays; i++) rays[i] = testRays[i%(2*numTimeSteps)];
+          IntersectWithMode(imode,ivariant,scene,rays,numRays);
+          for (size_t i=0; i<numRays; i++)
+            if (ivariant & VARIANT_INTERSECT) {
+              if (rays[i].hit.geomID == RTC_INVALID_GEOMETRY_ID)
+                return VerifyApplication::FAILED;
+            }
+            else {
+              if (rays[i].ray.tfar != float(neg_inf))
+                return VerifyApplication::FAILED;
+            }
+        }
       }
       AssertNoError(device);
 
@@ -1775,96 +1971,613 @@ namespace embree
     }
   };
 
-  /////////////////////////////////////////////////////////////////////////////////
-  /////////////////////////////////////////////////////////////////////////////////
-  /////////////////////////////////////////////////////////////////////////////////
-  /////////////////////////////////////////////////////////////////////////////////
+  struct TessellationCameraTest : public VerifyApplication::Test
+  {
+    TessellationCameraTest (std::string name, int isa)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS) {}
 
-  const size_t num_interpolation_vertices = 16;
-  const size_t num_interpolation_quad_faces = 9;
-  const size_t num_interpolation_triangle_faces = 18;
+    static bool memoryMonitor(void* userPtr, const ssize_t bytes, const bool /*post*/)
+    {
+      *(std::atomic<ssize_t>*)userPtr += bytes;
+      return true;
+    }
 
-  __aligned(16) float interpolation_vertices[num_interpolation_vertices*3] = {
-    -1.0f, -1.0f, 0.0f,
-    0.0f, -1.0f, 0.0f, 
-    +1.0f, -1.0f, 0.0f,
-    +2.0f, -1.0f, 0.0f,
-    
-    -1.0f,  0.0f, 0.0f,
-    0.0f,  0.0f, 0.0f,
-    +1.0f,  0.0f, 0.0f,
-    +2.0f,  0.0f, 0.0f,
+    /* builds a distant subdivision sphere and returns the memory required for it */
+    ssize_t build(RTCDeviceRef& device, const RTCTessellationCamera* camera, bool& hit)
+    {
+      std::atomic<ssize_t> bytes(0);
+      ssize_t bytesUsed = 0;
+      rtcSetDeviceMemoryMonitorFunction(device,memoryMonitor,&bytes);
+      {
+        VerifyScene scene(device,SceneFlags(RTC_SCENE_FLAG_NONE,RTC_BUILD_QUALITY_MEDIUM));
+        const Vec3fa center(0.0f,0.0f,100.0f);
+        RTCGeometry geom = rtcGetGeometry(scene,scene.addSubdivSphere(sampler,RTC_BUILD_QUALITY_MEDIUM,center,1.0f,8,32.0f).first);
+        if (camera) {
+          rtcSetGeometryTessellationCamera(geom,camera);
+          rtcCommitGeometry(geom);
+        }
+        rtcCommitScene (scene);
+        bytesUsed = bytes;
 
-    -1.0f, +1.0f, 0.0f,
-    0.0f, +1.0f, 0.0f,
-    +1.0f, +1.0f, 0.0f,
-    +2.0f, +1.0f, 0.0f,
+        RTCIntersectContext context;
+        rtcInitIntersectContext(&context);
+        RTCRayHit ray = makeRay(zero,Vec3fa(0.0f,0.0f,1.0f));
+        rtcIntersect1(scene,&context,&ray);
+        hit = ray.hit.geomID != RTC_INVALID_GEOMETRY_ID && abs(ray.ray.tfar-99.0f) < 0.25f;
+      }
+      rtcSetDeviceMemoryMonitorFunction(device,nullptr,nullptr);
+      return bytesUsed;
+    }
 
-    -1.0f, +2.0f, 0.0f,
-    0.0f, +2.0f, 0.0f,
-    +1.0f, +2.0f, 0.0f,
-    +2.0f, +2.0f, 0.0f,
-  };
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
 
-  __aligned(16) int interpolation_quad_indices[num_interpolation_quad_faces*4] = {
-    0, 1, 5, 4,
-    1, 2, 6, 5,
-    2, 3, 7, 6,
-    4, 5, 9, 8, 
-    5, 6, 10, 9,
-    6, 7, 11, 10,
-    8, 9, 13, 12,
-    9, 10, 14, 13,
-    10, 11, 15, 14
-  };
+      RTCTessellationCamera camera;
+      camera.pos_x = camera.pos_y = camera.pos_z = 0.0f;
+      camera.fov = 0.5f*float(pi);
+      camera.width = 1024;
+      camera.height = 768;
+      camera.edgeLength = 4.0f;
 
-  __aligned(16) int interpolation_triangle_indices[num_interpolation_triangle_faces*3] = {
-    0, 1, 5,  0, 5, 4,
-    1, 2, 6,  1, 6, 5,
-    2, 3, 7,  2, 7, 6,
-    4, 5, 9,  4, 9, 8, 
-    5, 6, 10,  5, 10, 9,
-    6, 7, 11,  6, 11, 10,
-    8, 9, 13,   8, 13, 12,
-    9, 10, 14,   9, 14, 13,
-    10, 11, 15,  10, 15, 14
-  };
+      bool hit0 = false, hit1 = false;
+      const ssize_t bytes0 = build(device,nullptr,hit0);
+      const ssize_t bytes1 = build(device,&camera,hit1);
+      AssertNoError(device);
+      if (!hit0 || !hit1)
+        return VerifyApplication::FAILED;
 
-  __aligned(16) int interpolation_quad_faces[num_interpolation_quad_faces] = {
-    4, 4, 4, 4, 4, 4, 4, 4, 4
-  };
+      /* the distant sphere should require much less tessellation */
+      if (!silent) std::cout << " " << 1E-6*double(bytes0) << " MB -> " << 1E-6*double(bytes1) << " MB " << std::flush;
+      if (bytes1 > bytes0/2)
+        return VerifyApplication::FAILED;
 
-  __aligned(16) float interpolation_vertex_crease_weights[2] = {
-    inf, inf
+      return VerifyApplication::PASSED;
+    }
   };
 
-  __aligned(16) unsigned int interpolation_vertex_crease_indices[2] = {
-    12, 15
-  };
+  struct TessellationCacheStatsTest : public VerifyApplication::Test
+  {
+    TessellationCacheStatsTest (std::string name, int isa)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS) {}
 
-  __aligned(16) float interpolation_edge_crease_weights[3] = {
-    inf, inf, inf
-  };
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
 
-  __aligned(16) unsigned int interpolation_edge_crease_indices[6] = 
-  {
-    8,9, 9,10, 10,11
+      VerifyScene scene(device,SceneFlags(RTC_SCENE_FLAG_NONE,RTC_BUILD_QUALITY_MEDIUM));
+      auto sphere = scene.addSubdivSphere(sampler,RTC_BUILD_QUALITY_MEDIUM,zero,1.0f,16,4.0f);
+      RTCGeometry geom = rtcGetGeometry(scene,sphere.first);
+      const unsigned int numFaces = (unsigned int) sphere.second.dynamicCast<SceneGraph::SubdivMeshNode>()->verticesPerFace.size();
+      rtcCommitScene (scene);
+      AssertNoError(device);
+
+      const ssize_t hits0      = rtcGetDeviceProperty(device,RTC_DEVICE_PROPERTY_TESSELLATION_CACHE_HITS);
+      const ssize_t misses0    = rtcGetDeviceProperty(device,RTC_DEVICE_PROPERTY_TESSELLATION_CACHE_MISSES);
+      const ssize_t evictions0 = rtcGetDeviceProperty(device,RTC_DEVICE_PROPERTY_TESSELLATION_CACHE_EVICTIONS);
+
+      /* interpolating twice at the same face hits the cache the second time */
+      float P[3];
+      rtcInterpolate0(geom,0,0.5f,0.5f,RTC_BUFFER_TYPE_VERTEX,0,P,3);
+      rtcInterpolate0(geom,0,0.5f,0.5f,RTC_BUFFER_TYPE_VERTEX,0,P,3);
+
+      /* interpolating all other faces misses the cache */
+      for (unsigned int i=1; i<numFaces; i++)
+        rtcInterpolate0(geom,i,0.5f,0.5f,RTC_BUFFER_TYPE_VERTEX,0,P,3);
+      AssertNoError(device);
+
+      const ssize_t hits      = rtcGetDeviceProperty(device,RTC_DEVICE_PROPERTY_TESSELLATION_CACHE_HITS) - hits0;
+      const ssize_t misses    = rtcGetDeviceProperty(device,RTC_DEVICE_PROPERTY_TESSELLATION_CACHE_MISSES) - misses0;
+      const ssize_t evictions = rtcGetDeviceProperty(device,RTC_DEVICE_PROPERTY_TESSELLATION_CACHE_EVICTIONS) - evictions0;
+      AssertNoError(device);
+
+      if (!silent) std::cout << " " << hits << " hits, " << misses << " misses, " << evictions << " evictions " << std::flush;
+      if (hits < 1 || misses < ssize_t(numFaces))
+        return VerifyApplication::FAILED;
+
+      return VerifyApplication::PASSED;
+    }
   };
 
-  struct InterpolateSubdivTest : public VerifyApplication::Test
+  struct SubdivPartialUpdateTest : public VerifyApplication::Test
   {
-    unsigned int N;
+    static const unsigned int N = 16;
     
-    InterpolateSubdivTest (std::string name, int isa, unsigned int N)
-      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), N(N) {}
+    SubdivPartialUpdateTest (std::string name, int isa)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS) {}
 
-    bool checkInterpolation2D(RTCGeometry geom, int primID, float u, float v, int v0, RTCBufferType bufferType, unsigned int bufferSlot, float* data, unsigned int N, unsigned int N_total)
+    /* creates a subdivision surface over a grid of N x N quads */
+    static RTCGeometry createGrid(RTCDevice device, RTCScene scene, const Vec3fa* vertices)
     {
-      assert(N < 256);
-      bool passed = true;
-      float P[256], dPdu[256], dPdv[256];
-      rtcInterpolate1(geom,primID,u,v,bufferType,bufferSlot,P,dPdu,dPdv,N);
-      
+      RTCGeometry geom = rtcNewGeometry(device,RTC_GEOMETRY_TYPE_SUBDIVISION);
+      unsigned int* faces = (unsigned int*) rtcSetNewGeometryBuffer(geom,RTC_BUFFER_TYPE_FACE,0,RTC_FORMAT_UINT,sizeof(unsigned int),N*N);
+      unsigned int* indices = (unsigned int*) rtcSetNewGeometryBuffer(geom,RTC_BUFFER_TYPE_INDEX,0,RTC_FORMAT_UINT,sizeof(unsigned int),4*N*N);
+      Vec3fa* positions = (Vec3fa*) rtcSetNewGeometryBuffer(geom,RTC_BUFFER_TYPE_VERTEX,0,RTC_FORMAT_FLOAT3,sizeof(Vec3fa),(N+1)*(N+1));
+      for (unsigned int y=0; y<N; y++) {
+        for (unsigned int x=0; x<N; x++) {
+          faces[y*N+x] = 4;
+          indices[4*(y*N+x)+0] = (y+0)*(N+1)+(x+0);
+          indices[4*(y*N+x)+1] = (y+0)*(N+1)+(x+1);
+          indices[4*(y*N+x)+2] = (y+1)*(N+1)+(x+1);
+          indices[4*(y*N+x)+3] = (y+1)*(N+1)+(x+0);
+        }
+      }
+      for (unsigned int i=0; i<(N+1)*(N+1); i++) positions[i] = vertices[i];
+      rtcSetGeometryTessellationRate(geom,16.0f);
+      rtcCommitGeometry(geom);
+      rtcAttachGeometry(scene,geom);
+      rtcReleaseGeometry(geom);
+      return geom;
+    }
+
+    /* compares hits and interpolated positions of incrementally updated and rebuilt surface */
+    static bool compare(RTCScene scene0, RTCGeometry geom0, RTCScene scene1, RTCGeometry geom1)
+    {
+      RTCIntersectContext context;
+      rtcInitIntersectContext(&context);
+      for (unsigned int y=0; y<4*N; y++)
+      {
+        for (unsigned int x=0; x<4*N; x++)
+        {
+          const Vec3fa org((float(x)+0.37f)/4.0f,(float(y)+0.71f)/4.0f,10.0f);
+          RTCRayHit ray0 = makeRay(org,Vec3fa(0.0f,0.0f,-1.0f));
+          RTCRayHit ray1 = makeRay(org,Vec3fa(0.0f,0.0f,-1.0f));
+          rtcIntersect1(scene0,&context,&ray0);
+          rtcIntersect1(scene1,&context,&ray1);
+          if (ray0.hit.geomID != ray1.hit.geomID || ray0.hit.primID != ray1.hit.primID) return false;
+          if (ray0.hit.geomID == RTC_INVALID_GEOMETRY_ID) continue;
+          if (abs(ray0.ray.tfar-ray1.ray.tfar) > 1E-4f) return false;
+        }
+      }
+      for (unsigned int f=0; f<N*N; f++)
+      {
+        Vec3fa P0, P1;
+        rtcInterpolate0(geom0,f,0.3f,0.6f,RTC_BUFFER_TYPE_VERTEX,0,&P0.x,3);
+        rtcInterpolate0(geom1,f,0.3f,0.6f,RTC_BUFFER_TYPE_VERTEX,0,&P1.x,3);
+        if (length(P0-P1) > 1E-4f) return false;
+      }
+      return true;
+    }
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+
+      std::vector<Vec3fa> vertices((N+1)*(N+1));
+      for (unsigned int y=0; y<=N; y++)
+        for (unsigned int x=0; x<=N; x++)
+          vertices[y*(N+1)+x] = Vec3fa(float(x),float(y),0.0f);
+
+      RTCSceneRef scene = rtcNewScene(device);
+      rtcSetSceneFlags(scene,RTC_SCENE_FLAG_DYNAMIC);
+      RTCGeometry geom = createGrid(device,scene,vertices.data());
+      rtcCommitScene(scene);
+      AssertNoError(device);
+
+      for (size_t i=0; i<16; i++)
+      {
+        /* move some vertices, sometimes committing the geometry multiple times */
+        const size_t numCommits = 1+(i%2);
+        for (size_t j=0; j<numCommits; j++) 
+        {
+          Vec3fa* positions = (Vec3fa*) rtcGetGeometryBufferData(geom,RTC_BUFFER_TYPE_VERTEX,0);
+          const unsigned int v = RandomSampler_getUInt(sampler) % ((N+1)*(N+1));
+          vertices[v].z += 2.0f*RandomSampler_get1D(sampler)-1.0f;
+          positions[v] = vertices[v];
+          rtcUpdateGeometryBuffer(geom,RTC_BUFFER_TYPE_VERTEX,0);
+          rtcCommitGeometry(geom);
+        }
+        rtcCommitScene(scene);
+        AssertNoError(device);
+
+        /* compare against surface built from scratch */
+        RTCSceneRef reference = rtcNewScene(device);
+        RTCGeometry reference_geom = createGrid(device,reference,vertices.data());
+        rtcCommitScene(reference);
+        AssertNoError(device);
+
+        if (!compare(scene,geom,reference,reference_geom))
+          return VerifyApplication::FAILED;
+      }
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct MeshPartialRefitTest : public VerifyApplication::Test
+  {
+    static const unsigned int N = 64;
+
+    RTCGeometryType gtype;
+
+    MeshPartialRefitTest (std::string name, int isa, RTCGeometryType gtype)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), gtype(gtype) {}
+
+    /* creates a triangle or quad mesh over a grid of N x N cells */
+    static RTCGeometry createGrid(RTCDevice device, RTCScene scene, RTCGeometryType gtype, const Vec3fa* vertices)
+    {
+      RTCGeometry geom = rtcNewGeometry(device,gtype);
+      rtcSetGeometryBuildQuality(geom,RTC_BUILD_QUALITY_REFIT);
+      if (gtype == RTC_GEOMETRY_TYPE_TRIANGLE)
+      {
+        unsigned int* indices = (unsigned int*) rtcSetNewGeometryBuffer(geom,RTC_BUFFER_TYPE_INDEX,0,RTC_FORMAT_UINT3,3*sizeof(unsigned int),2*N*N);
+        for (unsigned int y=0; y<N; y++) {
+          for (unsigned int x=0; x<N; x++) {
+            unsigned int* tris = &indices[6*(y*N+x)];
+            tris[0] = (y+0)*(N+1)+(x+0); tris[1] = (y+0)*(N+1)+(x+1); tris[2] = (y+1)*(N+1)+(x+1);
+            tris[3] = (y+0)*(N+1)+(x+0); tris[4] = (y+1)*(N+1)+(x+1); tris[5] = (y+1)*(N+1)+(x+0);
+          }
+        }
+      }
+      else
+      {
+        unsigned int* indices = (unsigned int*) rtcSetNewGeometryBuffer(geom,RTC_BUFFER_TYPE_INDEX,0,RTC_FORMAT_UINT4,4*sizeof(unsigned int),N*N);
+        for (unsigned int y=0; y<N; y++) {
+          for (unsigned int x=0; x<N; x++) {
+            indices[4*(y*N+x)+0] = (y+0)*(N+1)+(x+0);
+            indices[4*(y*N+x)+1] = (y+0)*(N+1)+(x+1);
+            indices[4*(y*N+x)+2] = (y+1)*(N+1)+(x+1);
+            indices[4*(y*N+x)+3] = (y+1)*(N+1)+(x+0);
+          }
+        }
+      }
+      Vec3fa* positions = (Vec3fa*) rtcSetNewGeometryBuffer(geom,RTC_BUFFER_TYPE_VERTEX,0,RTC_FORMAT_FLOAT3,sizeof(Vec3fa),(N+1)*(N+1));
+      for (unsigned int i=0; i<(N+1)*(N+1); i++) positions[i] = vertices[i];
+      rtcCommitGeometry(geom);
+      rtcAttachGeometry(scene,geom);
+      rtcReleaseGeometry(geom);
+      return geom;
+    }
+
+    /* compares hits of the refitted and rebuilt mesh */
+    static bool compare(RTCScene scene0, RTCScene scene1)
+    {
+      RTCIntersectContext context;
+      rtcInitIntersectContext(&context);
+      for (unsigned int y=0; y<2*N; y++)
+      {
+        for (unsigned int x=0; x<2*N; x++)
+        {
+          const Vec3fa org((float(x)+0.37f)/2.0f,(float(y)+0.71f)/2.0f,10.0f);
+          RTCRayHit ray0 = makeRay(org,Vec3fa(0.0f,0.0f,-1.0f));
+          RTCRayHit ray1 = makeRay(org,Vec3fa(0.0f,0.0f,-1.0f));
+          rtcIntersect1(scene0,&context,&ray0);
+          rtcIntersect1(scene1,&context,&ray1);
+          if (ray0.hit.geomID != ray1.hit.geomID || ray0.hit.primID != ray1.hit.primID) return false;
+          if (ray0.hit.geomID == RTC_INVALID_GEOMETRY_ID) continue;
+          if (abs(ray0.ray.tfar-ray1.ray.tfar) > 1E-4f) return false;
+        }
+      }
+      return true;
+    }
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+
+      const unsigned int numVertices = (N+1)*(N+1);
+      std::vector<Vec3fa> vertices(numVertices);
+      for (unsigned int y=0; y<=N; y++)
+        for (unsigned int x=0; x<=N; x++)
+          vertices[y*(N+1)+x] = Vec3fa(float(x),float(y),0.0f);
+
+      /* per geometry BVHs get refitted only in dynamic scenes of low build quality */
+      RTCSceneRef scene = rtcNewScene(device);
+      rtcSetSceneFlags(scene,RTC_SCENE_FLAG_DYNAMIC);
+      rtcSetSceneBuildQuality(scene,RTC_BUILD_QUALITY_LOW);
+      RTCGeometry geom = createGrid(device,scene,gtype,vertices.data());
+      rtcCommitScene(scene);
+      AssertNoError(device);
+
+      /* ranges outside the vertex buffer are invalid */
+      rtcUpdateGeometryBufferRange(geom,RTC_BUFFER_TYPE_VERTEX,0,numVertices-1,2);
+      AssertError(device,RTC_ERROR_INVALID_ARGUMENT);
+
+      for (size_t i=0; i<16; i++)
+      {
+        /* move a few vertices, every 4th iteration the entire buffer gets updated */
+        Vec3fa* positions = (Vec3fa*) rtcGetGeometryBufferData(geom,RTC_BUFFER_TYPE_VERTEX,0);
+        const unsigned int numMoved = 1+(i%3);
+        for (size_t j=0; j<numMoved; j++)
+        {
+          const unsigned int v = RandomSampler_getUInt(sampler) % numVertices;
+          vertices[v].z += 2.0f*RandomSampler_get1D(sampler)-1.0f;
+          positions[v] = vertices[v];
+          rtcUpdateGeometryBufferRange(geom,RTC_BUFFER_TYPE_VERTEX,0,v,1);
+        }
+        if (i%4 == 3)
+          rtcUpdateGeometryBuffer(geom,RTC_BUFFER_TYPE_VERTEX,0);
+        rtcCommitGeometry(geom);
+        rtcCommitScene(scene);
+        AssertNoError(device);
+
+        /* compare against mesh built from scratch */
+        RTCSceneRef reference = rtcNewScene(device);
+        createGrid(device,reference,gtype,vertices.data());
+        rtcCommitScene(reference);
+        AssertNoError(device);
+
+        if (!compare(scene,reference))
+          return VerifyApplication::FAILED;
+      }
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct ReorderVerticesTest : public VerifyApplication::Test
+  {
+    static const unsigned int N = 32;
+
+    RTCGeometryType gtype;
+    RTCSceneFlags sflags;
+    RTCBuildQuality quality;
+
+    ReorderVerticesTest (std::string name, int isa, RTCGeometryType gtype, RTCSceneFlags sflags, RTCBuildQuality quality)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), gtype(gtype), sflags(sflags), quality(quality) {}
+
+    /* creates a triangle or quad mesh over a grid of N x N cells with randomly permuted vertices */
+    static RTCGeometry createGrid(RTCDevice device, RTCScene scene, RTCGeometryType gtype, const std::vector<unsigned int>& perm, const Vec3fa* vertices)
+    {
+      RTCGeometry geom = rtcNewGeometry(device,gtype);
+      if (gtype == RTC_GEOMETRY_TYPE_TRIANGLE)
+      {
+        unsigned int* indices = (unsigned int*) rtcSetNewGeometryBuffer(geom,RTC_BUFFER_TYPE_INDEX,0,RTC_FORMAT_UINT3,3*sizeof(unsigned int),2*N*N);
+        for (unsigned int y=0; y<N; y++) {
+          for (unsigned int x=0; x<N; x++) {
+            unsigned int* tris = &indices[6*(y*N+x)];
+            tris[0] = perm[(y+0)*(N+1)+(x+0)]; tris[1] = perm[(y+0)*(N+1)+(x+1)]; tris[2] = perm[(y+1)*(N+1)+(x+1)];
+            tris[3] = perm[(y+0)*(N+1)+(x+0)]; tris[4] = perm[(y+1)*(N+1)+(x+1)]; tris[5] = perm[(y+1)*(N+1)+(x+0)];
+          }
+        }
+      }
+      else
+      {
+        unsigned int* indices = (unsigned int*) rtcSetNewGeometryBuffer(geom,RTC_BUFFER_TYPE_INDEX,0,RTC_FORMAT_UINT4,4*sizeof(unsigned int),N*N);
+        for (unsigned int y=0; y<N; y++) {
+          for (unsigned int x=0; x<N; x++) {
+            indices[4*(y*N+x)+0] = perm[(y+0)*(N+1)+(x+0)];
+            indices[4*(y*N+x)+1] = perm[(y+0)*(N+1)+(x+1)];
+            indices[4*(y*N+x)+2] = perm[(y+1)*(N+1)+(x+1)];
+            indices[4*(y*N+x)+3] = perm[(y+1)*(N+1)+(x+0)];
+          }
+        }
+      }
+      Vec3fa* positions = (Vec3fa*) rtcSetNewGeometryBuffer(geom,RTC_BUFFER_TYPE_VERTEX,0,RTC_FORMAT_FLOAT3,sizeof(Vec3fa),(N+1)*(N+1));
+      for (unsigned int i=0; i<(N+1)*(N+1); i++) positions[i] = vertices[i];
+      rtcCommitGeometry(geom);
+      rtcAttachGeometry(scene,geom);
+      rtcReleaseGeometry(geom);
+      return geom;
+    }
+
+    /* compares hits with the scene without reordered vertices and checks interpolation at the hit */
+    static bool compare(RTCScene scene0, RTCGeometry geom0, RTCScene scene1)
+    {
+      RTCIntersectContext context;
+      rtcInitIntersectContext(&context);
+      for (unsigned int y=0; y<2*N; y++)
+      {
+        for (unsigned int x=0; x<2*N; x++)
+        {
+          const Vec3fa org((float(x)+0.37f)/2.0f,(float(y)+0.71f)/2.0f,10.0f);
+          const Vec3fa dir(0.0f,0.0f,-1.0f);
+          RTCRayHit ray0 = makeRay(org,dir);
+          RTCRayHit ray1 = makeRay(org,dir);
+          rtcIntersect1(scene0,&context,&ray0);
+          rtcIntersect1(scene1,&context,&ray1);
+          if (ray0.hit.geomID != ray1.hit.geomID || ray0.hit.primID != ray1.hit.primID) return false;
+          if (ray0.hit.geomID == RTC_INVALID_GEOMETRY_ID) continue;
+          if (abs(ray0.ray.tfar-ray1.ray.tfar) > 1E-4f) return false;
+
+          Vec3fa P;
+          rtcInterpolate0(geom0,ray0.hit.primID,ray0.hit.u,ray0.hit.v,RTC_BUFFER_TYPE_VERTEX,0,&P.x,3);
+          if (length(Vec3fa(P-(org+ray0.ray.tfar*dir))) > 1E-3f) return false;
+        }
+      }
+      return true;
+    }
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+
+      /* randomly permute the vertices of the grid */
+      const unsigned int numVertices = (N+1)*(N+1);
+      std::vector<unsigned int> perm(numVertices);
+      for (unsigned int i=0; i<numVertices; i++) perm[i] = i;
+      for (unsigned int i=numVertices-1; i>0; i--)
+        std::swap(perm[i],perm[RandomSampler_getUInt(sampler) % (i+1)]);
+
+      std::vector<Vec3fa> vertices(numVertices);
+      for (unsigned int y=0; y<=N; y++)
+        for (unsigned int x=0; x<=N; x++)
+          vertices[perm[y*(N+1)+x]] = Vec3fa(float(x),float(y),0.0f);
+
+      RTCSceneRef scene = rtcNewScene(device);
+      rtcSetSceneFlags(scene,RTCSceneFlags(sflags | RTC_SCENE_FLAG_REORDER_VERTICES));
+      rtcSetSceneBuildQuality(scene,quality);
+      RTCGeometry geom = createGrid(device,scene,gtype,perm,vertices.data());
+
+      RTCSceneRef reference = rtcNewScene(device);
+      rtcSetSceneFlags(reference,sflags);
+      rtcSetSceneBuildQuality(reference,quality);
+      RTCGeometry geomRef = createGrid(device,reference,gtype,perm,vertices.data());
+
+      for (size_t i=0; i<4; i++)
+      {
+        rtcCommitScene(scene);
+        rtcCommitScene(reference);
+        AssertNoError(device);
+
+        if (!compare(scene,geom,reference))
+          return VerifyApplication::FAILED;
+
+        /* displace the vertices, the reordered copy has to follow */
+        Vec3fa* positions = (Vec3fa*) rtcGetGeometryBufferData(geom,RTC_BUFFER_TYPE_VERTEX,0);
+        Vec3fa* positionsRef = (Vec3fa*) rtcGetGeometryBufferData(geomRef,RTC_BUFFER_TYPE_VERTEX,0);
+        for (unsigned int v=0; v<numVertices; v++) {
+          vertices[v].z = 2.0f*RandomSampler_get1D(sampler)-1.0f;
+          positions[v] = positionsRef[v] = vertices[v];
+        }
+        rtcUpdateGeometryBuffer(geom,RTC_BUFFER_TYPE_VERTEX,0);
+        rtcUpdateGeometryBuffer(geomRef,RTC_BUFFER_TYPE_VERTEX,0);
+        rtcCommitGeometry(geom);
+        rtcCommitGeometry(geomRef);
+      }
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct GarbageGeometryTest : public VerifyApplication::Test
+  {
+    GarbageGeometryTest (std::string name, int isa)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS) {}
+    
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + "isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+
+      for (size_t i=0; i<size_t(1000*state->intensity); i++)
+      {
+        RandomSampler_init(sampler,int(i*23565));
+        if (i%20 == 0) std::cout << "." << std::flush;
+
+        SceneFlags sflags = getSceneFlags(i); 
+        VerifyScene scene(device,sflags);
+        AssertNoError(device);
+        
+        for (size_t j=0; j<20; j++) 
+        {
+          size_t numPrimitives = random_int()%256;
+          switch (random_int()%10) {
+          case 0: scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createGarbageTriangleMesh(random_int(),numPrimitives,false)); break;
+          case 1: scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createGarbageTriangleMesh(random_int(),numPrimitives,true )); break;
+          case 2: scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createGarbageQuadMesh(random_int(),numPrimitives,false)); break;
+          case 3: scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createGarbageQuadMesh(random_int(),numPrimitives,true )); break;
+          case 4: scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createGarbageGridMesh(random_int(),numPrimitives,false)); break;
+          case 5: scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createGarbageGridMesh(random_int(),numPrimitives,true )); break;
+          case 6: scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createGarbageHair(random_int(),numPrimitives,false)); break;
+          case 7: scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createGarbageHair(random_int(),numPrimitives,true )); break;
+          case 8: scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createGarbageLineSegments(random_int(),numPrimitives,false)); break;
+          case 9: scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createGarbageLineSegments(random_int(),numPrimitives,true )); break;
+          case 10: scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createGarbagePointSet(random_int(),numPrimitives,false)); break;
+          case 11: scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createGarbagePointSet(random_int(),numPrimitives,true )); break;
+            //case 12: scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createGarbageSubdivMesh(random_int(),numPrimitives,false)); break; // FIXME: not working yet
+            //case 13: scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createGarbageSubdivMesh(random_int(),numPrimitives,true )); break;
+          }
+          AssertNoError(device);
+        }
+        
+        rtcCommitScene(scene);
+        AssertNoError(device);
+      }
+      AssertNoError(device);
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  /////////////////////////////////////////////////////////////////////////////////
+  /////////////////////////////////////////////////////////////////////////////////
+  /////////////////////////////////////////////////////////////////////////////////
+  /////////////////////////////////////////////////////////////////////////////////
+
+  const size_t num_interpolation_vertices = 16;
+  const size_t num_interpolation_quad_faces = 9;
+  const size_t num_interpolation_triangle_faces = 18;
+
+  __aligned(16) float interpolation_vertices[num_interpolation_vertices*3] = {
+    -1.0f, -1.0f, 0.0f,
+    0.0f, -1.0f, 0.0f, 
+    +1.0f, -1.0f, 0.0f,
+    +2.0f, -1.0f, 0.0f,
+    
+    -1.0f,  0.0f, 0.0f,
+    0.0f,  0.0f, 0.0f,
+    +1.0f,  0.0f, 0.0f,
+    +2.0f,  0.0f, 0.0f,
+
+    -1.0f, +1.0f, 0.0f,
+    0.0f, +1.0f, 0.0f,
+    +1.0f, +1.0f, 0.0f,
+    +2.0f, +1.0f, 0.0f,
+
+    -1.0f, +2.0f, 0.0f,
+    0.0f, +2.0f, 0.0f,
+    +1.0f, +2.0f, 0.0f,
+    +2.0f, +2.0f, 0.0f,
+  };
+
+  __aligned(16) int interpolation_quad_indices[num_interpolation_quad_faces*4] = {
+    0, 1, 5, 4,
+    1, 2, 6, 5,
+    2, 3, 7, 6,
+    4, 5, 9, 8, 
+    5, 6, 10, 9,
+    6, 7, 11, 10,
+    8, 9, 13, 12,
+    9, 10, 14, 13,
+    10, 11, 15, 14
+  };
+
+  __aligned(16) int interpolation_triangle_indices[num_interpolation_triangle_faces*3] = {
+    0, 1, 5,  0, 5, 4,
+    1, 2, 6,  1, 6, 5,
+    2, 3, 7,  2, 7, 6,
+    4, 5, 9,  4, 9, 8, 
+    5, 6, 10,  5, 10, 9,
+    6, 7, 11,  6, 11, 10,
+    8, 9, 13,   8, 13, 12,
+    9, 10, 14,   9, 14, 13,
+    10, 11, 15,  10, 15, 14
+  };
+
+  __aligned(16) int interpolation_quad_faces[num_interpolation_quad_faces] = {
+    4, 4, 4, 4, 4, 4, 4, 4, 4
+  };
+
+  __aligned(16) float interpolation_vertex_crease_weights[2] = {
+    inf, inf
+  };
+
+  __aligned(16) unsigned int interpolation_vertex_crease_indices[2] = {
+    12, 15
+  };
+
+  __aligned(16) float interpolation_edge_crease_weights[3] = {
+    inf, inf, inf
+  };
+
+  __aligned(16) unsigned int interpolation_edge_crease_indices[6] = 
+  {
+    8,9, 9,10, 10,11
+  };
+
+  struct InterpolateSubdivTest : public VerifyApplication::Test
+  {
+    unsigned int N;
+    
+    InterpolateSubdivTest (std::string name, int isa, unsigned int N)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), N(N) {}
+
+    bool checkInterpolation2D(RTCGeometry geom, int primID, float u, float v, int v0, RTCBufferType bufferType, unsigned int bufferSlot, float* data, unsigned int N, unsigned int N_total)
+    {
+      assert(N < 256);
+      bool passed = true;
+      float P[256], dPdu[256], dPdv[256];
+      rtcInterpolate1(geom,primID,u,v,bufferType,bufferSlot,P,dPdu,dPdv,N);
+      
       for (size_t i=0; i<N; i++) {
         float p0 = (1.0f/6.0f)*(1.0f*data[(v0-4-1)*N_total+i] + 4.0f*data[(v0-4+0)*N_total+i] + 1.0f*data[(v0-4+1)*N_total+i]);
         float p1 = (1.0f/6.0f)*(1.0f*data[(v0+0-1)*N_total+i] + 4.0f*data[(v0+0+0)*N_total+i] + 1.0f*data[(v0+0+1)*N_total+i]);
@@ -1875,153 +2588,671 @@ namespace embree
       return passed;
     }
     
-    bool checkInterpolation1D(RTCGeometry geom, int primID, float u, float v, int v0, int v1, int v2, RTCBufferType bufferType, unsigned int bufferSlot, float* data, unsigned int N, unsigned int N_total)
+    bool checkInterpolation1D(RTCGeometry geom, int primID, float u, float v, int v0, int v1, int v2, RTCBufferType bufferType, unsigned int bufferSlot, float* data, unsigned int N, unsigned int N_total)
+    {
+      assert(N < 256);
+      bool passed = true;
+      float P[256], dPdu[256], dPdv[256];
+      rtcInterpolate1(geom,primID,u,v,bufferType,bufferSlot,P,dPdu,dPdv,(unsigned int)N);
+      
+      for (size_t i=0; i<N; i++) {
+        float v = (1.0f/6.0f)*(1.0f*data[v0*N_total+i] + 4.0f*data[v1*N_total+i] + 1.0f*data[v2*N_total+i]);
+        passed &= fabsf(v-P[i]) < 0.001f;
+      }
+      return passed;
+    }
+    
+    bool checkInterpolationSharpVertex(RTCGeometry geom, int primID, float u, float v, int v0, RTCBufferType bufferType, unsigned int bufferSlot, float* data, size_t N, size_t N_total)
+    {
+      assert(N < 256);
+      bool passed = true;
+      float P[256], dPdu[256], dPdv[256];
+      rtcInterpolate1(geom,primID,u,v,bufferType,bufferSlot,P,dPdu,dPdv,(unsigned int)N);
+      
+      for (size_t i=0; i<N; i++) {
+        float v = data[v0*N_total+i];
+        passed &= fabs(v-P[i]) < 1E-3f;
+      }
+      return passed;
+    }
+    
+    bool checkSubdivInterpolation(const RTCDeviceRef& device, RTCGeometry geom, RTCBufferType bufferType, unsigned int bufferSlot, float* vertices0, unsigned int N, unsigned int N_total)
+    {
+      rtcSetGeometrySubdivisionMode(geom,0,RTC_SUBDIVISION_MODE_SMOOTH_BOUNDARY);
+      AssertNoError(device);
+      rtcCommitGeometry(geom);
+      AssertNoError(device);
+      bool passed = true;
+      passed &= checkInterpolation1D(geom,0,0.0f,0.0f,4,0,1,bufferType,bufferSlot,vertices0,N,N_total);
+      passed &= checkInterpolation1D(geom,2,1.0f,0.0f,2,3,7,bufferType,bufferSlot,vertices0,N,N_total);
+      
+      passed &= checkInterpolation2D(geom,3,1.0f,0.0f,5,bufferType,bufferSlot,vertices0,N,N_total);
+      passed &= checkInterpolation2D(geom,1,1.0f,1.0f,6,bufferType,bufferSlot,vertices0,N,N_total);
+      
+      //passed &= checkInterpolation1D(geom,3,1.0f,1.0f,8,9,10,bufferType,bufferSlot,vertices0,N,N_total);
+      //passed &= checkInterpolation1D(geom,7,1.0f,0.0f,9,10,11,bufferType,bufferSlot,vertices0,N,N_total);
+      
+      passed &= checkInterpolationSharpVertex(geom,6,0.0f,1.0f,12,bufferType,bufferSlot,vertices0,N,N_total);
+      passed &= checkInterpolationSharpVertex(geom,8,1.0f,1.0f,15,bufferType,bufferSlot,vertices0,N,N_total);
+      
+      rtcSetGeometrySubdivisionMode(geom,0,RTC_SUBDIVISION_MODE_PIN_CORNERS);
+      rtcCommitGeometry(geom);
+      AssertNoError(device);
+      
+      passed &= checkInterpolationSharpVertex(geom,0,0.0f,0.0f,0,bufferType,bufferSlot,vertices0,N,N_total);
+      passed &= checkInterpolationSharpVertex(geom,2,1.0f,0.0f,3,bufferType,bufferSlot,vertices0,N,N_total);
+      return passed;
+    }
+    
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+      size_t M = num_interpolation_vertices*N+16; // padds the arrays with some valid data
+      
+      RTCGeometry geom = rtcNewGeometry(device, RTC_GEOMETRY_TYPE_SUBDIVISION);
+      AssertNoError(device);
+      rtcSetGeometryVertexAttributeCount(geom,2);
+      
+      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_INDEX,                0, RTC_FORMAT_UINT,  interpolation_quad_indices,          0, sizeof(unsigned int),   num_interpolation_quad_faces*4);
+      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_FACE,                 0, RTC_FORMAT_UINT,  interpolation_quad_faces,            0, sizeof(unsigned int),   num_interpolation_quad_faces);
+      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_EDGE_CREASE_INDEX,    0, RTC_FORMAT_UINT2, interpolation_edge_crease_indices,   0, 2*sizeof(unsigned int), 3);
+      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_EDGE_CREASE_WEIGHT,   0, RTC_FORMAT_FLOAT, interpolation_edge_crease_weights,   0, sizeof(float),          3);
+      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX_CREASE_INDEX,  0, RTC_FORMAT_UINT,  interpolation_vertex_crease_indices, 0, sizeof(unsigned int),   2);
+      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX_CREASE_WEIGHT, 0, RTC_FORMAT_FLOAT, interpolation_vertex_crease_weights, 0, sizeof(float),          2);
+      AssertNoError(device);
+      
+      std::vector<float> vertices0(M);
+      for (size_t i=0; i<M; i++) vertices0[i] = random_float();
+      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX, 0, RTC_FORMAT_FLOAT3, vertices0.data(), 0, N*sizeof(float), num_interpolation_vertices);
+      AssertNoError(device);
+      
+      /*std::vector<float> vertices1(M);
+        for (size_t i=0; i<M; i++) vertices1[i] = random_float();
+        rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX, 1, RTC_FORMAT_FLOAT3, vertices1.data(), 0, N*sizeof(float), num_interpolation_vertices);
+        AssertNoError(device);*/
+      
+      std::vector<float> user_vertices0(M);
+      for (size_t i=0; i<M; i++) user_vertices0[i] = random_float();
+      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE, 0, RTCFormat(RTC_FORMAT_FLOAT+N), user_vertices0.data(), 0, N*sizeof(float), num_interpolation_vertices);
+      AssertNoError(device);
+      
+      std::vector<float> user_vertices1(M);
+      for (size_t i=0; i<M; i++) user_vertices1[i] = random_float();
+      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE, 1, RTCFormat(RTC_FORMAT_FLOAT+N), user_vertices1.data(), 0, N*sizeof(float), num_interpolation_vertices);
+      AssertNoError(device);
+      
+      bool passed = true;
+      if (N >= 3) {
+        passed &= checkSubdivInterpolation(device,geom,RTC_BUFFER_TYPE_VERTEX,0,vertices0.data(),3,N);
+        //passed &= checkSubdivInterpolation(device,geom,RTC_BUFFER_TYPE_VERTEX,1,vertices1.data(),3,N);
+      }
+      passed &= checkSubdivInterpolation(device,geom,RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE,0,user_vertices0.data(),N,N);
+      passed &= checkSubdivInterpolation(device,geom,RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE,1,user_vertices1.data(),N,N);
+      
+      passed &= checkSubdivInterpolation(device,geom,RTC_BUFFER_TYPE_VERTEX,0,vertices0.data(),1,N);
+      //passed &= checkSubdivInterpolation(device,geom,RTC_BUFFER_TYPE_VERTEX,1,vertices1.data(),1,N);
+      passed &= checkSubdivInterpolation(device,geom,RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE,0,user_vertices0.data(),1,N);
+      passed &= checkSubdivInterpolation(device,geom,RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE,1,user_vertices1.data(),1,N);
+
+      rtcReleaseGeometry(geom);
+      AssertNoError(device);
+
+      return (VerifyApplication::TestReturnValue) passed;
+    }
+  };
+
+  struct InterpolateTrianglesTest : public VerifyApplication::Test
+  {
+    size_t N;
+    
+    InterpolateTrianglesTest (std::string name, int isa, size_t N)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), N(N) {}
+    
+    bool checkTriangleInterpolation(RTCGeometry geom, int primID, float u, float v, int v0, int v1, int v2, RTCBufferType bufferType, unsigned int bufferSlot, float* data, size_t N, size_t N_total)
+    {
+      assert(N<256);
+      bool passed = true;
+      float P[256], dPdu[256], dPdv[256];
+      rtcInterpolate1(geom,primID,u,v,bufferType,bufferSlot,P,dPdu,dPdv,(unsigned int)N);
+      
+      for (size_t i=0; i<N; i++) {
+        float p0 = data[v0*N_total+i];
+        float p1 = data[v1*N_total+i];
+        float p2 = data[v2*N_total+i];
+        float p = (1.0f-u-v)*p0 + u*p1 + v*p2;
+        passed &= fabs(p-P[i]) < 1E-4f;
+      }
+      return passed;
+    }
+    
+    bool checkTriangleInterpolation(RTCGeometry geom, RTCBufferType bufferType, unsigned int bufferSlot, float* vertices0, size_t N, size_t N_total)
+    {
+      bool passed = true;
+      passed &= checkTriangleInterpolation(geom,0,0.0f,0.0f,0,1,5,bufferType,bufferSlot,vertices0,N,N_total);
+      passed &= checkTriangleInterpolation(geom,0,0.5f,0.5f,0,1,5,bufferType,bufferSlot,vertices0,N,N_total);
+      passed &= checkTriangleInterpolation(geom,17,0.0f,0.0f,10,15,14,bufferType,bufferSlot,vertices0,N,N_total);
+      passed &= checkTriangleInterpolation(geom,17,0.5f,0.5f,10,15,14,bufferType,bufferSlot,vertices0,N,N_total);
+      return passed;
+    }
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+
+      size_t M = num_interpolation_vertices*N+16; // padds the arrays with some valid data
+      
+      RTCGeometry geom = rtcNewGeometry(device, RTC_GEOMETRY_TYPE_TRIANGLE);
+      AssertNoError(device);
+      rtcSetGeometryVertexAttributeCount(geom,2);
+      
+      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_INDEX, 0, RTC_FORMAT_UINT3, interpolation_triangle_indices, 0, 3*sizeof(unsigned int), num_interpolation_triangle_faces*3);
+      AssertNoError(device);
+      
+      std::vector<float> vertices0(M);
+      for (size_t i=0; i<M; i++) vertices0[i] = random_float();
+      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX, 0, RTC_FORMAT_FLOAT3, vertices0.data(), 0, N*sizeof(float), num_interpolation_vertices);
+      AssertNoError(device);
+      
+      /*std::vector<float> vertices1(M);
+        for (size_t i=0; i<M; i++) vertices1[i] = random_float();
+        rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX, 1, RTC_FORMAT_FLOAT3, vertices1.data(), 0, N*sizeof(float), num_interpolation_vertices);
+        AssertNoError(device);*/
+      
+      std::vector<float> user_vertices0(M);
+      for (size_t i=0; i<M; i++) user_vertices0[i] = random_float();
+      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE, 0, RTCFormat(RTC_FORMAT_FLOAT+N), user_vertices0.data(), 0, N*sizeof(float), num_interpolation_vertices);
+      AssertNoError(device);
+      
+      std::vector<float> user_vertices1(M);
+      for (size_t i=0; i<M; i++) user_vertices1[i] = random_float();
+      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE, 1, RTCFormat(RTC_FORMAT_FLOAT+N), user_vertices1.data(), 0, N*sizeof(float), num_interpolation_vertices);
+      AssertNoError(device);
+      
+      rtcDisableGeometry(geom);
+      AssertNoError(device);
+      rtcCommitGeometry(geom);
+      AssertNoError(device);
+      
+      bool passed = true;
+      if (N >= 3) {
+        passed &= checkTriangleInterpolation(geom,RTC_BUFFER_TYPE_VERTEX,0,vertices0.data(),3,N);
+        //passed &= checkTriangleInterpolation(geom,RTC_BUFFER_TYPE_VERTEX,1,vertices1.data(),3,N);
+      }
+      passed &= checkTriangleInterpolation(geom,RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE,0,user_vertices0.data(),N,N);
+      passed &= checkTriangleInterpolation(geom,RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE,1,user_vertices1.data(),N,N);
+      
+      passed &= checkTriangleInterpolation(geom,RTC_BUFFER_TYPE_VERTEX,0,vertices0.data(),1,N);
+      //passed &= checkTriangleInterpolation(geom,RTC_BUFFER_TYPE_VERTEX,1,vertices1.data(),1,N);
+      passed &= checkTriangleInterpolation(geom,RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE,0,user_vertices0.data(),1,N);
+      passed &= checkTriangleInterpolation(geom,RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE,1,user_vertices1.data(),1,N);
+
+      rtcReleaseGeometry(geom);
+      AssertNoError(device);
+
+      return (VerifyApplication::TestReturnValue) passed;
+    }
+  };
+
+  __aligned(16) RTCGrid interpolation_grids[1];
+  
+  struct InterpolateGridTest : public VerifyApplication::Test
+  {
+    size_t N;
+    
+    InterpolateGridTest (std::string name, int isa, size_t N)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), N(N) {}
+    
+    bool checkGridInterpolation(RTCGeometry geom, int primID, float u, float v, RTCBufferType bufferType, unsigned int bufferSlot, size_t N)
     {
-      assert(N < 256);
+      assert(N<256);
       bool passed = true;
       float P[256], dPdu[256], dPdv[256];
       rtcInterpolate1(geom,primID,u,v,bufferType,bufferSlot,P,dPdu,dPdv,(unsigned int)N);
       
-      for (size_t i=0; i<N; i++) {
-        float v = (1.0f/6.0f)*(1.0f*data[v0*N_total+i] + 4.0f*data[v1*N_total+i] + 1.0f*data[v2*N_total+i]);
-        passed &= fabsf(v-P[i]) < 0.001f;
+      for (size_t i=0; i<N; i++)
+      {
+        float p = (2.0f*u+3.0f*v)+float(i);
+        passed &= fabs(p-P[i]) < 1E-4f;
       }
       return passed;
     }
     
-    bool checkInterpolationSharpVertex(RTCGeometry geom, int primID, float u, float v, int v0, RTCBufferType bufferType, unsigned int bufferSlot, float* data, size_t N, size_t N_total)
+    bool checkGridInterpolation(RTCGeometry geom, RTCBufferType bufferType, unsigned int bufferSlot, size_t N)
     {
-      assert(N < 256);
+      bool passed = true;
+      for (size_t i=0; i<100; i++) {
+        const float u = random_float();
+        const float v = random_float();
+        passed &= checkGridInterpolation(geom,0,u,v,bufferType,bufferSlot,N);
+      }
+      return passed;
+    }
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+
+      size_t M = 16*N+16; // padds the arrays with some valid data
+      
+      RTCGeometry geom = rtcNewGeometry(device, RTC_GEOMETRY_TYPE_GRID);
+      AssertNoError(device);
+
+      interpolation_grids[0].startVertexID = 0;
+      interpolation_grids[0].stride = 4;
+      interpolation_grids[0].width = 4;
+      interpolation_grids[0].height = 4;
+      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_GRID, 0, RTC_FORMAT_GRID, interpolation_grids, 0, sizeof(RTCGrid), 1);
+      AssertNoError(device);
+      
+      std::vector<float> vertices0(M);
+      for (size_t y=0; y<4; y++)
+        for (size_t x=0; x<4; x++)
+          for (size_t i=0; i<N; i++)
+            vertices0[(y*4+x)*N+i] = (2.0f*float(x)/3.0f + 3.0f*y/3.0f)+float(i);
+      
+      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX, 0, RTC_FORMAT_FLOAT3, vertices0.data(), 0, N*sizeof(float), 4*4);
+      AssertNoError(device);
+      
+      rtcCommitGeometry(geom);
+      AssertNoError(device);
+      
+      bool passed = true;
+      passed &= checkGridInterpolation(geom,RTC_BUFFER_TYPE_VERTEX,0,N);
+      rtcReleaseGeometry(geom);
+      AssertNoError(device);
+
+      return (VerifyApplication::TestReturnValue) passed;
+    }
+  };
+  
+  const size_t num_interpolation_hair_vertices = 13;
+  const size_t num_interpolation_hairs = 4;
+
+  __aligned(16) int interpolation_hair_indices[num_interpolation_hairs] = {
+    0, 3, 6, 9
+  };
+
+  struct InterpolateHairTest : public VerifyApplication::Test
+  {
+    size_t N;
+    
+    InterpolateHairTest (std::string name, int isa, size_t N)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), N(N) {}
+    
+    bool checkHairInterpolation(RTCGeometry geom, int primID, float u, float v, int v0, RTCBufferType bufferType, unsigned int bufferSlot, float* data, size_t N, size_t N_total)
+    {
+      assert(N<256);
       bool passed = true;
       float P[256], dPdu[256], dPdv[256];
       rtcInterpolate1(geom,primID,u,v,bufferType,bufferSlot,P,dPdu,dPdv,(unsigned int)N);
       
       for (size_t i=0; i<N; i++) {
-        float v = data[v0*N_total+i];
-        passed &= fabs(v-P[i]) < 1E-3f;
+        const float p00 = data[(v0+0)*N_total+i];
+        const float p01 = data[(v0+1)*N_total+i];
+        const float p02 = data[(v0+2)*N_total+i];
+        const float p03 = data[(v0+3)*N_total+i];
+        const float t0 = 1.0f - u, t1 = u;
+        const float p10 = p00 * t0 + p01 * t1;
+        const float p11 = p01 * t0 + p02 * t1;
+        const float p12 = p02 * t0 + p03 * t1;
+        const float p20 = p10 * t0 + p11 * t1;
+        const float p21 = p11 * t0 + p12 * t1;
+        const float p30 = p20 * t0 + p21 * t1;
+        passed &= fabs(p30-P[i]) < 1E-4f;
       }
       return passed;
     }
-    
-    bool checkSubdivInterpolation(const RTCDeviceRef& device, RTCGeometry geom, RTCBufferType bufferType, unsigned int bufferSlot, float* vertices0, unsigned int N, unsigned int N_total)
+    
+    bool checkHairInterpolation(RTCGeometry geom, RTCBufferType bufferType, unsigned int bufferSlot, float* vertices0, size_t N, size_t N_total)
+    {
+      bool passed = true;
+      passed &= checkHairInterpolation(geom,0,0.0f,0.0f,0,bufferType,bufferSlot,vertices0,N,N_total);
+      passed &= checkHairInterpolation(geom,1,0.5f,0.0f,3,bufferType,bufferSlot,vertices0,N,N_total);
+      passed &= checkHairInterpolation(geom,2,0.0f,0.0f,6,bufferType,bufferSlot,vertices0,N,N_total);
+      passed &= checkHairInterpolation(geom,3,0.2f,0.0f,9,bufferType,bufferSlot,vertices0,N,N_total);
+      return passed;
+    }
+    
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+
+      size_t M = num_interpolation_hair_vertices*N+16; // padds the arrays with some valid data
+      
+      RTCGeometry geom = rtcNewGeometry(device, RTC_GEOMETRY_TYPE_ROUND_BEZIER_CURVE);
+      AssertNoError(device);
+      rtcSetGeometryVertexAttributeCount(geom,2);
+      
+      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_INDEX, 0, RTC_FORMAT_UINT, interpolation_hair_indices, 0, sizeof(unsigned int), num_interpolation_hairs);
+      AssertNoError(device);
+      
+      std::vector<float> vertices0(M);
+      for (size_t i=0; i<M; i++) vertices0[i] = random_float();
+      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX, 0, RTC_FORMAT_FLOAT4, vertices0.data(), 0, N*sizeof(float), num_interpolation_hair_vertices);
+      AssertNoError(device);
+      
+      /*std::vector<float> vertices1(M);
+        for (size_t i=0; i<M; i++) vertices1[i] = random_float();
+        rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX, 1, RTC_FORMAT_FLOAT4, vertices1.data(), 0, N*sizeof(float), num_interpolation_hair_vertices);
+        AssertNoError(device);*/
+      
+      std::vector<float> user_vertices0(M);
+      for (size_t i=0; i<M; i++) user_vertices0[i] = random_float();
+      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE, 0, RTCFormat(RTC_FORMAT_FLOAT+N), user_vertices0.data(), 0, N*sizeof(float), num_interpolation_hair_vertices);
+      AssertNoError(device);
+      
+      std::vector<float> user_vertices1(M);
+      for (size_t i=0; i<M; i++) user_vertices1[i] = random_float();
+      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE, 1, RTCFormat(RTC_FORMAT_FLOAT+N), user_vertices1.data(), 0, N*sizeof(float), num_interpolation_hair_vertices);
+      AssertNoError(device);
+      
+      rtcDisableGeometry(geom);
+      AssertNoError(device);
+      rtcCommitGeometry(geom);
+      AssertNoError(device);
+      
+      bool passed = true;
+      if (N >= 4) {
+        passed &= checkHairInterpolation(geom,RTC_BUFFER_TYPE_VERTEX,0,vertices0.data(),4,N);
+        //passed &= checkHairInterpolation(geom,RTC_BUFFER_TYPE_VERTEX,1,vertices1.data(),4,N);
+      }
+      passed &= checkHairInterpolation(geom,RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE,0,user_vertices0.data(),N,N);
+      passed &= checkHairInterpolation(geom,RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE,1,user_vertices1.data(),N,N);
+      
+      passed &= checkHairInterpolation(geom,RTC_BUFFER_TYPE_VERTEX,0,vertices0.data(),1,N);
+      //passed &= checkHairInterpolation(geom,RTC_BUFFER_TYPE_VERTEX,1,vertices1.data(),1,N);
+      passed &= checkHairInterpolation(geom,RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE,0,user_vertices0.data(),1,N);
+      passed &= checkHairInterpolation(geom,RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE,1,user_vertices1.data(),1,N);
+
+      rtcReleaseGeometry(geom);
+      AssertNoError(device);
+
+      return (VerifyApplication::TestReturnValue) passed;
+    }
+  };
+
+  /////////////////////////////////////////////////////////////////////////////////
+  /////////////////////////////////////////////////////////////////////////////////
+  /////////////////////////////////////////////////////////////////////////////////
+  /////////////////////////////////////////////////////////////////////////////////
+
+  struct TriangleHitTest : public VerifyApplication::IntersectTest
+  {
+    SceneFlags sflags; 
+    RTCBuildQuality quality; 
+
+    TriangleHitTest (std::string name, int isa, SceneFlags sflags, RTCBuildQuality quality, IntersectMode imode, IntersectVariant ivariant)
+      : VerifyApplication::IntersectTest(name,isa,imode,ivariant,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags), quality(quality) {}
+
+    inline Vec3fa uniformSampleTriangle(const Vec3fa &a, const Vec3fa &b, const Vec3fa &c, float &u, float& v)
+    {
+      const float su = sqrtf(u);
+      v *= su;
+      u = 1.0f-su;
+      if (u < 0.001f || v < 0.001f || (u+v) > 0.999f) { u = 0.333f; v = 0.333f; } // avoid hitting edges
+      return c + u * (a-c) + v * (b-c);
+    }
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+      if (!supportsIntersectMode(device,imode))
+        return VerifyApplication::SKIPPED;
+     
+      Vec3f vertices[4] = {
+        Vec3f(0.0f,0.0f,0.0f),
+        Vec3f(1.0f,0.0f,0.0f),
+        Vec3f(0.0f,1.0f,0.0f),
+        Vec3f(zero) // dummy vertex for 16 byte padding
+      };
+      Triangle triangles[1] = {
+        Triangle(0,1,2)
+      };
+      RTCSceneRef scene = rtcNewScene(device);
+      rtcSetSceneFlags(scene,sflags.sflags);
+      rtcSetSceneBuildQuality(scene,sflags.qflags);
+      
+      RTCGeometry geom = rtcNewGeometry (device, RTC_GEOMETRY_TYPE_TRIANGLE);
+      rtcSetGeometryBuildQuality(geom,quality);
+      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX, 0, RTC_FORMAT_FLOAT3, vertices , 0, sizeof(Vec3f), 3);
+      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_INDEX , 0, RTC_FORMAT_UINT3,  triangles, 0, sizeof(Triangle), 1);
+      rtcCommitGeometry(geom);
+      rtcAttachGeometry(scene,geom);
+      rtcReleaseGeometry(geom);
+      rtcCommitScene (scene);
+      AssertNoError(device);
+
+      float u[256], v[256];
+      RTCRayHit rays[256];
+      for (size_t i=0; i<256; i++)
+      {
+        u[i] = random_float(); 
+        v[i] = random_float();
+        Vec3fa from(0.0f,0.0f,-1.0f);
+        Vec3fa to = uniformSampleTriangle(vertices[1],vertices[2],vertices[0],u[i],v[i]);
+        rays[i] = makeRay(from,to-from);
+      }
+      IntersectWithMode(imode,ivariant,scene,rays,256);
+
+      for (size_t i=0; i<256; i++)
+      {
+        
+        if (!(ivariant & VARIANT_INTERSECT)) 
+        {
+          if (rays[i].ray.tfar != float(neg_inf)) return VerifyApplication::FAILED;          
+          continue;
+        }
+
+
+        if (rays[i].hit.geomID != 0) return VerifyApplication::FAILED;
+        if (rays[i].hit.primID != 0) return VerifyApplication::FAILED;
+        if (abs(rays[i].hit.u - u[i]) > 16.0f*float(ulp)) return VerifyApplication::FAILED;
+        if (abs(rays[i].hit.v - v[i]) > 16.0f*float(ulp)) return VerifyApplication::FAILED;
+        if (abs(rays[i].ray.tfar - 1.0f) > 16.0f*float(ulp)) return VerifyApplication::FAILED;
+        const Vec3fa org(rays[i].ray.org_x,rays[i].ray.org_y,rays[i].ray.org_z);
+        const Vec3fa dir(rays[i].ray.dir_x,rays[i].ray.dir_y,rays[i].ray.dir_z);
+        const Vec3fa ht  = org + rays[i].ray.tfar*dir;
+        const Vec3fa huv = vertices[0] + rays[i].hit.u*(vertices[1]-vertices[0]) + rays[i].hit.v*(vertices[2]-vertices[0]);
+        if (reduce_max(abs(ht-huv)) > 16.0f*float(ulp)) return VerifyApplication::FAILED;
+        const Vec3fa Ng = Vec3fa(rays[i].hit.Ng_x,rays[i].hit.Ng_y,rays[i].hit.Ng_z);
+        if (reduce_max(abs(Ng - Vec3fa(0.0f,0.0f,1.0f))) > 16.0f*float(ulp)) return VerifyApplication::FAILED;
+      }
+      AssertNoError(device);
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct QuadHitTest : public VerifyApplication::IntersectTest
+  {
+    SceneFlags sflags; 
+    RTCBuildQuality quality; 
+
+    QuadHitTest (std::string name, int isa, SceneFlags sflags, RTCBuildQuality quality, IntersectMode imode, IntersectVariant ivariant)
+      : VerifyApplication::IntersectTest(name,isa,imode,ivariant,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags), quality(quality) {}
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
     {
-      rtcSetGeometrySubdivisionMode(geom,0,RTC_SUBDIVISION_MODE_SMOOTH_BOUNDARY);
-      AssertNoError(device);
-      rtcCommitGeometry(geom);
-      AssertNoError(device);
-      bool passed = true;
-      passed &= checkInterpolation1D(geom,0,0.0f,0.0f,4,0,1,bufferType,bufferSlot,vertices0,N,N_total);
-      passed &= checkInterpolation1D(geom,2,1.0f,0.0f,2,3,7,bufferType,bufferSlot,vertices0,N,N_total);
-      
-      passed &= checkInterpolation2D(geom,3,1.0f,0.0f,5,bufferType,bufferSlot,vertices0,N,N_total);
-      passed &= checkInterpolation2D(geom,1,1.0f,1.0f,6,bufferType,bufferSlot,vertices0,N,N_total);
-      
-      //passed &= checkInterpolation1D(geom,3,1.0f,1.0f,8,9,10,bufferType,bufferSlot,vertices0,N,N_total);
-      //passed &= checkInterpolation1D(geom,7,1.0f,0.0f,9,10,11,bufferType,bufferSlot,vertices0,N,N_total);
-      
-      passed &= checkInterpolationSharpVertex(geom,6,0.0f,1.0f,12,bufferType,bufferSlot,vertices0,N,N_total);
-      passed &= checkInterpolationSharpVertex(geom,8,1.0f,1.0f,15,bufferType,bufferSlot,vertices0,N,N_total);
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+      if (!supportsIntersectMode(device,imode))
+        return VerifyApplication::SKIPPED;
+     
+      Vec3f vertices[5] = {
+        Vec3f(0.0f,0.0f,0.0f),
+        Vec3f(1.0f,0.0f,0.0f),
+        Vec3f(1.0f,1.0f,0.0f),
+        Vec3f(0.0f,1.0f,0.0f),
+        Vec3f(zero) // dummy vertex for 16 byte padding
+      };
+      int quads[4] = {
+        0,1,2,3
+      };
+      RTCSceneRef scene = rtcNewScene(device);
+      rtcSetSceneFlags(scene,sflags.sflags);
+      rtcSetSceneBuildQuality(scene,sflags.qflags);
       
-      rtcSetGeometrySubdivisionMode(geom,0,RTC_SUBDIVISION_MODE_PIN_CORNERS);
+      RTCGeometry geom = rtcNewGeometry (device, RTC_GEOMETRY_TYPE_QUAD);
+      rtcSetGeometryBuildQuality(geom, quality);
+      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX, 0, RTC_FORMAT_FLOAT3, vertices , 0, sizeof(Vec3f), 4);
+      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_INDEX , 0, RTC_FORMAT_UINT4,  quads, 0, 4*sizeof(int), 1);
       rtcCommitGeometry(geom);
+      rtcAttachGeometry(scene,geom);
+      rtcReleaseGeometry(geom);
+      rtcCommitScene (scene);
+      AssertNoError(device);
+
+      float u[256], v[256];
+      RTCRayHit rays[256];
+      for (size_t i=0; i<256; i++)
+      {
+        u[i] = random_float(); 
+        v[i] = random_float();
+        if (u[i] < 0.001f || v[i] < 0.001f || u[i] > 0.999f || v[i] > 0.999f) { u[i] = 0.333f; v[i] = 0.333f; } // avoid hitting edges
+        Vec3fa from(0.0f,0.0f,-1.0f);
+        Vec3fa to = vertices[0] + u[i]*(vertices[1]-vertices[0]) + v[i]*(vertices[3]-vertices[0]);
+        rays[i] = makeRay(from,to-from);
+      }
+      IntersectWithMode(imode,ivariant,scene,rays,256);
+
+      for (size_t i=0; i<256; i++)
+      {
+        if (!(ivariant & VARIANT_INTERSECT))
+        {
+          if (rays[i].ray.tfar != float(neg_inf)) return VerifyApplication::FAILED;          
+          continue;
+        }
+        if (rays[i].hit.primID != 0) return VerifyApplication::FAILED;
+        if (abs(rays[i].hit.u - u[i]) > 16.0f*float(ulp)) return VerifyApplication::FAILED;
+        if (abs(rays[i].hit.v - v[i]) > 16.0f*float(ulp)) return VerifyApplication::FAILED;
+        if (abs(rays[i].ray.tfar - 1.0f) > 16.0f*float(ulp)) return VerifyApplication::FAILED;
+
+        const Vec3fa org(rays[i].ray.org_x,rays[i].ray.org_y,rays[i].ray.org_z);
+        const Vec3fa dir(rays[i].ray.dir_x,rays[i].ray.dir_y,rays[i].ray.dir_z);
+        const Vec3fa ht  = org + rays[i].ray.tfar*dir;
+        const Vec3fa huv = vertices[0] + rays[i].hit.u*(vertices[1]-vertices[0]) + rays[i].hit.v*(vertices[3]-vertices[0]);
+        if (reduce_max(abs(ht-huv)) > 16.0f*float(ulp)) return VerifyApplication::FAILED;
+        const Vec3fa Ng = Vec3fa(rays[i].hit.Ng_x,rays[i].hit.Ng_y,rays[i].hit.Ng_z);
+        if (reduce_max(abs(Ng - Vec3fa(0.0f,0.0f,1.0f))) > 16.0f*float(ulp)) return VerifyApplication::FAILED;
+      }
       AssertNoError(device);
       
-      passed &= checkInterpolationSharpVertex(geom,0,0.0f,0.0f,0,bufferType,bufferSlot,vertices0,N,N_total);
-      passed &= checkInterpolationSharpVertex(geom,2,1.0f,0.0f,3,bufferType,bufferSlot,vertices0,N,N_total);
-      return passed;
+      return VerifyApplication::PASSED;
     }
-    
+  };
+  
+  struct QuaternionInstanceTest : public VerifyApplication::IntersectTest
+  {
+    SceneFlags sflags;
+
+    QuaternionInstanceTest (std::string name, int isa, SceneFlags sflags, IntersectMode imode, IntersectVariant ivariant)
+      : VerifyApplication::IntersectTest(name,isa,imode,ivariant,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+
     VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
     {
       std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
       RTCDeviceRef device = rtcNewDevice(cfg.c_str());
       errorHandler(nullptr,rtcGetDeviceError(device));
-      size_t M = num_interpolation_vertices*N+16; // padds the arrays with some valid data
-      
-      RTCGeometry geom = rtcNewGeometry(device, RTC_GEOMETRY_TYPE_SUBDIVISION);
-      AssertNoError(device);
-      rtcSetGeometryVertexAttributeCount(geom,2);
-      
-      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_INDEX,                0, RTC_FORMAT_UINT,  interpolation_quad_indices,          0, sizeof(unsigned int),   num_interpolation_quad_faces*4);
-      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_FACE,                 0, RTC_FORMAT_UINT,  interpolation_quad_faces,            0, sizeof(unsigned int),   num_interpolation_quad_faces);
-      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_EDGE_CREASE_INDEX,    0, RTC_FORMAT_UINT2, interpolation_edge_crease_indices,   0, 2*sizeof(unsigned int), 3);
-      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_EDGE_CREASE_WEIGHT,   0, RTC_FORMAT_FLOAT, interpolation_edge_crease_weights,   0, sizeof(float),          3);
-      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX_CREASE_INDEX,  0, RTC_FORMAT_UINT,  interpolation_vertex_crease_indices, 0, sizeof(unsigned int),   2);
-      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX_CREASE_WEIGHT, 0, RTC_FORMAT_FLOAT, interpolation_vertex_crease_weights, 0, sizeof(float),          2);
-      AssertNoError(device);
-      
-      std::vector<float> vertices0(M);
-      for (size_t i=0; i<M; i++) vertices0[i] = random_float();
-      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX, 0, RTC_FORMAT_FLOAT3, vertices0.data(), 0, N*sizeof(float), num_interpolation_vertices);
+      if (!supportsIntersectMode(device,imode))
+        return VerifyApplication::SKIPPED;
+
+      VerifyScene object(device,sflags);
+      object.addSphere(sampler,RTC_BUILD_QUALITY_MEDIUM,Vec3fa(2.0f,0.0f,0.0f),0.5f,10);
+      rtcCommitScene (object);
       AssertNoError(device);
-      
-      /*std::vector<float> vertices1(M);
-        for (size_t i=0; i<M; i++) vertices1[i] = random_float();
-        rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX, 1, RTC_FORMAT_FLOAT3, vertices1.data(), 0, N*sizeof(float), num_interpolation_vertices);
-        AssertNoError(device);*/
-      
-      std::vector<float> user_vertices0(M);
-      for (size_t i=0; i<M; i++) user_vertices0[i] = random_float();
-      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE, 0, RTCFormat(RTC_FORMAT_FLOAT+N), user_vertices0.data(), 0, N*sizeof(float), num_interpolation_vertices);
+
+      /* rotate the sphere by 90 degrees around the z axis per time step, the
+         interpolated matrices would pull it towards the rotation center */
+      const unsigned int numTimeSteps = 3;
+      VerifyScene scene(device,sflags);
+      RTCGeometry instance = rtcNewGeometry(device,RTC_GEOMETRY_TYPE_INSTANCE);
+      rtcSetGeometryInstancedScene(instance,object);
+      rtcSetGeometryTimeStepCount(instance,numTimeSteps);
+      for (unsigned int t=0; t<numTimeSteps; t++)
+      {
+        const Quaternion3f q = Quaternion3f::rotate(Vec3f(0.0f,0.0f,1.0f),float(t)*0.5f*float(pi));
+        RTCQuaternionDecomposition qd;
+        qd.scale_x = qd.scale_y = qd.scale_z = 1.0f;
+        qd.skew_xy = qd.skew_xz = qd.skew_yz = 0.0f;
+        qd.shift_x = qd.shift_y = qd.shift_z = 0.0f;
+        qd.quaternion_r = q.r; qd.quaternion_i = q.i; qd.quaternion_j = q.j; qd.quaternion_k = q.k;
+        qd.translation_x = 0.0f; qd.translation_y = 0.0f; qd.translation_z = 1.0f;
+        rtcSetGeometryTransformQuaternion(instance,t,&qd);
+      }
+      rtcCommitGeometry(instance);
+      unsigned int instID = rtcAttachGeometry(scene,instance);
+      rtcReleaseGeometry(instance);
+      rtcCommitScene (scene);
       AssertNoError(device);
-      
-      std::vector<float> user_vertices1(M);
-      for (size_t i=0; i<M; i++) user_vertices1[i] = random_float();
-      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE, 1, RTCFormat(RTC_FORMAT_FLOAT+N), user_vertices1.data(), 0, N*sizeof(float), num_interpolation_vertices);
+
+      float xfm[12];
+      rtcGetGeometryTransform(instance,0.25f,RTC_FORMAT_FLOAT3X4_COLUMN_MAJOR,xfm);
       AssertNoError(device);
-      
-      bool passed = true;
-      if (N >= 3) {
-        passed &= checkSubdivInterpolation(device,geom,RTC_BUFFER_TYPE_VERTEX,0,vertices0.data(),3,N);
-        //passed &= checkSubdivInterpolation(device,geom,RTC_BUFFER_TYPE_VERTEX,1,vertices1.data(),3,N);
+      const Vec3fa p = 2.0f*Vec3fa(xfm[0],xfm[1],xfm[2]) + Vec3fa(xfm[9],xfm[10],xfm[11]);
+      if (reduce_max(abs(p-Vec3fa(sqrtf(2.0f),sqrtf(2.0f),1.0f))) > 1E-4f)
+        return VerifyApplication::FAILED;
+
+      const unsigned int numTestRays = 17;
+      RTCRayHit testRays[numTestRays];
+      for (unsigned int i=0; i<numTestRays; i++)
+      {
+        const float time = float(i)/float(numTestRays-1);
+        const float phi = time*float(pi);
+        RTCRayHit ray = makeRay(Vec3fa(2.0f*cosf(phi),2.0f*sinf(phi),-10.0f),Vec3fa(0.0f,0.0f,1.0f));
+        ray.ray.time = time;
+        testRays[i] = ray;
       }
-      passed &= checkSubdivInterpolation(device,geom,RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE,0,user_vertices0.data(),N,N);
-      passed &= checkSubdivInterpolation(device,geom,RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE,1,user_vertices1.data(),N,N);
-      
-      passed &= checkSubdivInterpolation(device,geom,RTC_BUFFER_TYPE_VERTEX,0,vertices0.data(),1,N);
-      //passed &= checkSubdivInterpolation(device,geom,RTC_BUFFER_TYPE_VERTEX,1,vertices1.data(),1,N);
-      passed &= checkSubdivInterpolation(device,geom,RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE,0,user_vertices0.data(),1,N);
-      passed &= checkSubdivInterpolation(device,geom,RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE,1,user_vertices1.data(),1,N);
 
-      rtcReleaseGeometry(geom);
+      const unsigned int numRays = 64;
+      RTCRayHit rays[numRays];
+      for (unsigned int i=0; i<numRays; i++) rays[i] = testRays[i%numTestRays];
+      IntersectWithMode(imode,ivariant,scene,rays,numRays);
+      for (unsigned int i=0; i<numRays; i++)
+      {
+        if (!(ivariant & VARIANT_INTERSECT)) {
+          if (rays[i].ray.tfar != float(neg_inf)) return VerifyApplication::FAILED;
+          continue;
+        }
+        if (rays[i].hit.instID[0] != instID) return VerifyApplication::FAILED;
+        if (abs(rays[i].ray.tfar-10.5f) > 0.1f) return VerifyApplication::FAILED;
+      }
       AssertNoError(device);
 
-      return (VerifyApplication::TestReturnValue) passed;
+      return VerifyApplication::PASSED;
     }
   };
 
-  struct InterpolateTrianglesTest : public VerifyApplication::Test
+  struct InstanceLevelOfDetailTest : public VerifyApplication::IntersectTest
   {
-    size_t N;
-    
-    InterpolateTrianglesTest (std::string name, int isa, size_t N)
-      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), N(N) {}
-    
-    bool checkTriangleInterpolation(RTCGeometry geom, int primID, float u, float v, int v0, int v1, int v2, RTCBufferType bufferType, unsigned int bufferSlot, float* data, size_t N, size_t N_total)
-    {
-      assert(N<256);
-      bool passed = true;
-      float P[256], dPdu[256], dPdv[256];
-      rtcInterpolate1(geom,primID,u,v,bufferType,bufferSlot,P,dPdu,dPdv,(unsigned int)N);
-      
-      for (size_t i=0; i<N; i++) {
-        float p0 = data[v0*N_total+i];
-        float p1 = data[v1*N_total+i];
-        float p2 = data[v2*N_total+i];
-        float p = (1.0f-u-v)*p0 + u*p1 + v*p2;
-        passed &= fabs(p-P[i]) < 1E-4f;
-      }
-      return passed;
-    }
-    
-    bool checkTriangleInterpolation(RTCGeometry geom, RTCBufferType bufferType, unsigned int bufferSlot, float* vertices0, size_t N, size_t N_total)
+    SceneFlags sflags;
+
+    InstanceLevelOfDetailTest (std::string name, int isa, SceneFlags sflags, IntersectMode imode, IntersectVariant ivariant)
+      : VerifyApplication::IntersectTest(name,isa,imode,ivariant,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+
+    /* adds a large triangle in the plane at height z */
+    static void addTriangle(RTCDevice device, RTCScene scene, float z)
     {
-      bool passed = true;
-      passed &= checkTriangleInterpolation(geom,0,0.0f,0.0f,0,1,5,bufferType,bufferSlot,vertices0,N,N_total);
-      passed &= checkTriangleInterpolation(geom,0,0.5f,0.5f,0,1,5,bufferType,bufferSlot,vertices0,N,N_total);
-      passed &= checkTriangleInterpolation(geom,17,0.0f,0.0f,10,15,14,bufferType,bufferSlot,vertices0,N,N_total);
-      passed &= checkTriangleInterpolation(geom,17,0.5f,0.5f,10,15,14,bufferType,bufferSlot,vertices0,N,N_total);
-      return passed;
+      RTCGeometry geom = rtcNewGeometry(device,RTC_GEOMETRY_TYPE_TRIANGLE);
+      Vec3fa* vertices = (Vec3fa*) rtcSetNewGeometryBuffer(geom,RTC_BUFFER_TYPE_VERTEX,0,RTC_FORMAT_FLOAT3,sizeof(Vec3fa),3);
+      vertices[0] = Vec3fa(-100.0f,-100.0f,z);
+      vertices[1] = Vec3fa(+100.0f,-100.0f,z);
+      vertices[2] = Vec3fa(   0.0f,+100.0f,z);
+      unsigned int* indices = (unsigned int*) rtcSetNewGeometryBuffer(geom,RTC_BUFFER_TYPE_INDEX,0,RTC_FORMAT_UINT3,3*sizeof(unsigned int),1);
+      indices[0] = 0; indices[1] = 1; indices[2] = 2;
+      rtcCommitGeometry(geom);
+      rtcAttachGeometry(scene,geom);
+      rtcReleaseGeometry(geom);
     }
 
     VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
@@ -2029,94 +3260,271 @@ namespace embree
       std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
       RTCDeviceRef device = rtcNewDevice(cfg.c_str());
       errorHandler(nullptr,rtcGetDeviceError(device));
+      if (!supportsIntersectMode(device,imode))
+        return VerifyApplication::SKIPPED;
 
-      size_t M = num_interpolation_vertices*N+16; // padds the arrays with some valid data
-      
-      RTCGeometry geom = rtcNewGeometry(device, RTC_GEOMETRY_TYPE_TRIANGLE);
-      AssertNoError(device);
-      rtcSetGeometryVertexAttributeCount(geom,2);
-      
-      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_INDEX, 0, RTC_FORMAT_UINT3, interpolation_triangle_indices, 0, 3*sizeof(unsigned int), num_interpolation_triangle_faces*3);
-      AssertNoError(device);
-      
-      std::vector<float> vertices0(M);
-      for (size_t i=0; i<M; i++) vertices0[i] = random_float();
-      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX, 0, RTC_FORMAT_FLOAT3, vertices0.data(), 0, N*sizeof(float), num_interpolation_vertices);
+      /* the l'th level of detail is a triangle at height -l */
+      VerifyScene level0(device,sflags); addTriangle(device,level0, 0.0f); rtcCommitScene(level0);
+      VerifyScene level1(device,sflags); addTriangle(device,level1,-1.0f); rtcCommitScene(level1);
+      VerifyScene level2(device,sflags); addTriangle(device,level2,-2.0f); rtcCommitScene(level2);
       AssertNoError(device);
-      
-      /*std::vector<float> vertices1(M);
-        for (size_t i=0; i<M; i++) vertices1[i] = random_float();
-        rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX, 1, RTC_FORMAT_FLOAT3, vertices1.data(), 0, N*sizeof(float), num_interpolation_vertices);
-        AssertNoError(device);*/
-      
-      std::vector<float> user_vertices0(M);
-      for (size_t i=0; i<M; i++) user_vertices0[i] = random_float();
-      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE, 0, RTCFormat(RTC_FORMAT_FLOAT+N), user_vertices0.data(), 0, N*sizeof(float), num_interpolation_vertices);
+
+      VerifyScene scene(device,sflags);
+      RTCGeometry instance = rtcNewGeometry(device,RTC_GEOMETRY_TYPE_INSTANCE);
+      rtcSetGeometryInstancedScene(instance,level0);
+      rtcSetGeometryInstancedSceneLevel(instance,1,level1,10.0f);
+      rtcSetGeometryInstancedSceneLevel(instance,2,level2,100.0f);
       AssertNoError(device);
-      
-      std::vector<float> user_vertices1(M);
-      for (size_t i=0; i<M; i++) user_vertices1[i] = random_float();
-      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE, 1, RTCFormat(RTC_FORMAT_FLOAT+N), user_vertices1.data(), 0, N*sizeof(float), num_interpolation_vertices);
+
+      /* levels have to be appended with increasing distances */
+      rtcSetGeometryInstancedSceneLevel(instance,0,level1,1.0f);
+      AssertError(device,RTC_ERROR_INVALID_ARGUMENT);
+      rtcSetGeometryInstancedSceneLevel(instance,4,level1,1000.0f);
+      AssertError(device,RTC_ERROR_INVALID_ARGUMENT);
+      rtcSetGeometryInstancedSceneLevel(instance,3,level1,50.0f);
+      AssertError(device,RTC_ERROR_INVALID_ARGUMENT);
+
+      const float xfm[12] = { 1.0f,0.0f,0.0f, 0.0f,1.0f,0.0f, 0.0f,0.0f,1.0f, 0.0f,0.0f,5.0f };
+      rtcSetGeometryTransform(instance,0,RTC_FORMAT_FLOAT3X4_COLUMN_MAJOR,xfm);
+      rtcCommitGeometry(instance);
+      unsigned int instID = rtcAttachGeometry(scene,instance);
+      rtcReleaseGeometry(instance);
+      rtcCommitScene(scene);
       AssertNoError(device);
-      
-      rtcDisableGeometry(geom);
+
+      /* the instance bounds contain all levels */
+      RTCBounds bounds;
+      rtcGetSceneBounds(scene,&bounds);
+      if (bounds.lower_z > 3.0f || bounds.upper_z < 5.0f)
+        return VerifyApplication::FAILED;
+
+      /* rays starting at distance d hit the triangle of the selected level l at distance d+l */
+      const unsigned int numTestRays = 4;
+      const float distance[numTestRays] = { 5.0f, 50.0f, 500.0f, 9.9f };
+      const float expected[numTestRays] = { 5.0f, 51.0f, 502.0f, 9.9f };
+      const unsigned int numRays = 64;
+      RTCRayHit rays[numRays];
+      for (unsigned int i=0; i<numRays; i++)
+        rays[i] = makeRay(Vec3fa(0.0f,0.0f,5.0f+distance[i%numTestRays]),Vec3fa(0.0f,0.0f,-1.0f));
+      IntersectWithMode(imode,ivariant,scene,rays,numRays);
+      for (unsigned int i=0; i<numRays; i++)
+      {
+        if (!(ivariant & VARIANT_INTERSECT)) {
+          if (rays[i].ray.tfar != float(neg_inf)) return VerifyApplication::FAILED;
+          continue;
+        }
+        if (rays[i].hit.instID[0] != instID) return VerifyApplication::FAILED;
+        if (abs(rays[i].ray.tfar-expected[i%numTestRays]) > 1E-3f) return VerifyApplication::FAILED;
+      }
       AssertNoError(device);
+
+      if (imode == MODE_INTERSECT1 && (ivariant & VARIANT_INTERSECT))
+      {
+        /* a larger lod scale selects coarser levels closer to the instance */
+        RTCIntersectContext context;
+        rtcInitIntersectContext(&context);
+        context.lodScale = 10.0f;
+        RTCRayHit ray0 = makeRay(Vec3fa(0.0f,0.0f,10.0f),Vec3fa(0.0f,0.0f,-1.0f));
+        rtcIntersect1(scene,&context,&ray0);
+        if (abs(ray0.ray.tfar-6.0f) > 1E-3f) return VerifyApplication::FAILED;
+
+        /* removing a level falls back to the next finer level */
+        rtcSetGeometryInstancedSceneLevel(instance,2,nullptr,0.0f);
+        rtcCommitGeometry(instance);
+        rtcCommitScene(scene);
+        AssertNoError(device);
+        rtcInitIntersectContext(&context);
+        RTCRayHit ray1 = makeRay(Vec3fa(0.0f,0.0f,505.0f),Vec3fa(0.0f,0.0f,-1.0f));
+        rtcIntersect1(scene,&context,&ray1);
+        if (abs(ray1.ray.tfar-501.0f) > 1E-3f) return VerifyApplication::FAILED;
+      }
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct LazyInstanceTest : public VerifyApplication::IntersectTest
+  {
+    SceneFlags sflags;
+
+    LazyInstanceTest (std::string name, int isa, SceneFlags sflags, IntersectMode imode, IntersectVariant ivariant)
+      : VerifyApplication::IntersectTest(name,isa,imode,ivariant,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+
+    struct LazyObject
+    {
+      RTCDevice device;
+      std::atomic<size_t> numBuilds;
+    };
+
+    /* creates a triangle around the origin of the lazy scene */
+    static void buildLazyObject(void* ptr, RTCScene scene)
+    {
+      LazyObject* object = (LazyObject*) ptr;
+      object->numBuilds++;
+      RTCGeometry geom = rtcNewGeometry(object->device,RTC_GEOMETRY_TYPE_TRIANGLE);
+      Vec3fa* vertices = (Vec3fa*) rtcSetNewGeometryBuffer(geom,RTC_BUFFER_TYPE_VERTEX,0,RTC_FORMAT_FLOAT3,sizeof(Vec3fa),3);
+      vertices[0] = Vec3fa(-1.0f,-1.0f,0.0f);
+      vertices[1] = Vec3fa(+1.0f,-1.0f,0.0f);
+      vertices[2] = Vec3fa( 0.0f,+1.0f,0.0f);
+      unsigned int* indices = (unsigned int*) rtcSetNewGeometryBuffer(geom,RTC_BUFFER_TYPE_INDEX,0,RTC_FORMAT_UINT3,3*sizeof(unsigned int),1);
+      indices[0] = 0; indices[1] = 1; indices[2] = 2;
       rtcCommitGeometry(geom);
-      AssertNoError(device);
-      
-      bool passed = true;
-      if (N >= 3) {
-        passed &= checkTriangleInterpolation(geom,RTC_BUFFER_TYPE_VERTEX,0,vertices0.data(),3,N);
-        //passed &= checkTriangleInterpolation(geom,RTC_BUFFER_TYPE_VERTEX,1,vertices1.data(),3,N);
+      rtcAttachGeometry(scene,geom);
+      rtcReleaseGeometry(geom);
+    }
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+      if (!supportsIntersectMode(device,imode))
+        return VerifyApplication::SKIPPED;
+
+      /* the i'th instance of a lazy scene is placed at x = 4*i */
+      const unsigned int numObjects = 8;
+      LazyObject objects[numObjects];
+      std::vector<std::unique_ptr<VerifyScene>> lazyScenes;
+      VerifyScene scene(device,sflags);
+      const RTCBounds bounds = { -1.0f, -1.0f, -1.0f, 0.0f, +1.0f, +1.0f, +1.0f, 0.0f };
+      for (unsigned int i=0; i<numObjects; i++)
+      {
+        objects[i].device = device;
+        objects[i].numBuilds = 0;
+        lazyScenes.push_back(std::unique_ptr<VerifyScene>(new VerifyScene(device,sflags)));
+        rtcSetSceneLazyBuildFunction(*lazyScenes[i],buildLazyObject,&objects[i],&bounds);
+
+        RTCGeometry instance = rtcNewGeometry(device,RTC_GEOMETRY_TYPE_INSTANCE);
+        rtcSetGeometryInstancedScene(instance,*lazyScenes[i]);
+        const float xfm[12] = { 1.0f,0.0f,0.0f, 0.0f,1.0f,0.0f, 0.0f,0.0f,1.0f, 4.0f*float(i),0.0f,0.0f };
+        rtcSetGeometryTransform(instance,0,RTC_FORMAT_FLOAT3X4_COLUMN_MAJOR,xfm);
+        rtcCommitGeometry(instance);
+        rtcAttachGeometryByID(scene,instance,i);
+        rtcReleaseGeometry(instance);
       }
-      passed &= checkTriangleInterpolation(geom,RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE,0,user_vertices0.data(),N,N);
-      passed &= checkTriangleInterpolation(geom,RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE,1,user_vertices1.data(),N,N);
-      
-      passed &= checkTriangleInterpolation(geom,RTC_BUFFER_TYPE_VERTEX,0,vertices0.data(),1,N);
-      //passed &= checkTriangleInterpolation(geom,RTC_BUFFER_TYPE_VERTEX,1,vertices1.data(),1,N);
-      passed &= checkTriangleInterpolation(geom,RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE,0,user_vertices0.data(),1,N);
-      passed &= checkTriangleInterpolation(geom,RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE,1,user_vertices1.data(),1,N);
+      rtcSetSceneLazyBuildFunction(*lazyScenes[0],buildLazyObject,&objects[0],nullptr);
+      AssertError(device,RTC_ERROR_INVALID_ARGUMENT);
+      rtcCommitScene(scene);
+      AssertNoError(device);
 
-      rtcReleaseGeometry(geom);
+      /* the top level gets built from the specified bounds only */
+      for (unsigned int i=0; i<numObjects; i++)
+        if (objects[i].numBuilds != 0) return VerifyApplication::FAILED;
+
+      /* only the instances hit by rays get built */
+      const unsigned int numRays = 64;
+      RTCRayHit rays[numRays];
+      for (unsigned int i=0; i<numRays; i++)
+        rays[i] = makeRay(Vec3fa(4.0f*float(i%(numObjects/2)),0.0f,10.0f),Vec3fa(0.0f,0.0f,-1.0f));
+      IntersectWithMode(imode,ivariant,scene,rays,numRays);
       AssertNoError(device);
+      for (unsigned int i=0; i<numRays; i++)
+      {
+        if (!(ivariant & VARIANT_INTERSECT)) {
+          if (rays[i].ray.tfar != float(neg_inf)) return VerifyApplication::FAILED;
+          continue;
+        }
+        if (rays[i].hit.instID[0] != i%(numObjects/2)) return VerifyApplication::FAILED;
+        if (abs(rays[i].ray.tfar-10.0f) > 1E-4f) return VerifyApplication::FAILED;
+      }
+      for (unsigned int i=0; i<numObjects; i++)
+        if (objects[i].numBuilds != (i < numObjects/2 ? 1 : 0)) return VerifyApplication::FAILED;
 
-      return (VerifyApplication::TestReturnValue) passed;
+      /* concurrent rays entering an unbuilt instance build it only once */
+      if (imode == MODE_INTERSECT1 && (ivariant & VARIANT_INTERSECT))
+      {
+        parallel_for(size_t(0),size_t(1024),[&] (const range<size_t>& r) {
+          for (size_t i=r.begin(); i<r.end(); i++) {
+            RTCIntersectContext context;
+            rtcInitIntersectContext(&context);
+            RTCRayHit ray = makeRay(Vec3fa(4.0f*float(numObjects/2+i%(numObjects/2)),0.0f,10.0f),Vec3fa(0.0f,0.0f,-1.0f));
+            rtcIntersect1(scene,&context,&ray);
+          }
+        });
+        AssertNoError(device);
+        for (unsigned int i=0; i<numObjects; i++)
+          if (objects[i].numBuilds != 1) return VerifyApplication::FAILED;
+      }
+
+      return VerifyApplication::PASSED;
     }
   };
 
-  __aligned(16) RTCGrid interpolation_grids[1];
-  
-  struct InterpolateGridTest : public VerifyApplication::Test
+  struct UserGeometryBatchTest : public VerifyApplication::IntersectTest
   {
-    size_t N;
-    
-    InterpolateGridTest (std::string name, int isa, size_t N)
-      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), N(N) {}
-    
-    bool checkGridInterpolation(RTCGeometry geom, int primID, float u, float v, RTCBufferType bufferType, unsigned int bufferSlot, size_t N)
+    SceneFlags sflags;
+    static const unsigned int numPrimitives = 256;
+
+    UserGeometryBatchTest (std::string name, int isa, SceneFlags sflags, IntersectMode imode, IntersectVariant ivariant)
+      : VerifyApplication::IntersectTest(name,isa,imode,ivariant,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+
+    struct Squares
     {
-      assert(N<256);
-      bool passed = true;
-      float P[256], dPdu[256], dPdv[256];
-      rtcInterpolate1(geom,primID,u,v,bufferType,bufferSlot,P,dPdu,dPdv,(unsigned int)N);
-      
-      for (size_t i=0; i<N; i++)
+      unsigned int geomID;
+      std::atomic<unsigned int> maxPrimCount;
+    };
+
+    /* the i'th primitive is the unit square [i,i+1]x[0,1] of the z=0 plane */
+    static void boundsFunc(const struct RTCBoundsFunctionArguments* const args)
+    {
+      args->bounds_o->lower_x = float(args->primID+0); args->bounds_o->lower_y = 0.0f; args->bounds_o->lower_z = 0.0f;
+      args->bounds_o->upper_x = float(args->primID+1); args->bounds_o->upper_y = 1.0f; args->bounds_o->upper_z = 0.0f;
+    }
+
+    static void recordPrimCount(Squares* squares, unsigned int primCount)
+    {
+      unsigned int count = squares->maxPrimCount;
+      while (primCount > count && !squares->maxPrimCount.compare_exchange_weak(count,primCount));
+    }
+
+    static bool hitSquare(RTCRayN* ray, unsigned int N, unsigned int i, unsigned int primID, float& t)
+    {
+      t = -RTCRayN_org_z(ray,N,i)/RTCRayN_dir_z(ray,N,i);
+      if (!(t >= RTCRayN_tnear(ray,N,i) && t <= RTCRayN_tfar(ray,N,i))) return false;
+      const float x = RTCRayN_org_x(ray,N,i)+t*RTCRayN_dir_x(ray,N,i);
+      const float y = RTCRayN_org_y(ray,N,i)+t*RTCRayN_dir_y(ray,N,i);
+      return x >= float(primID) && x < float(primID+1) && y >= 0.0f && y < 1.0f;
+    }
+
+    static void intersectFuncN(const struct RTCIntersectFunctionNArguments* const args)
+    {
+      Squares* squares = (Squares*) args->geometryUserPtr;
+      recordPrimCount(squares,args->primCount);
+      RTCRayN* ray = RTCRayHitN_RayN(args->rayhit,args->N);
+      RTCHitN* hit = RTCRayHitN_HitN(args->rayhit,args->N);
+      for (unsigned int j=0; j<args->primCount; j++)
       {
-        float p = (2.0f*u+3.0f*v)+float(i);
-        passed &= fabs(p-P[i]) < 1E-4f;
+        const unsigned int primID = args->primIDs[j];
+        for (unsigned int i=0; i<args->N; i++)
+        {
+          float t;
+          if (!args->valid[i] || !hitSquare(ray,args->N,i,primID,t)) continue;
+          RTCRayN_tfar(ray,args->N,i) = t;
+          RTCHitN_Ng_x(hit,args->N,i) = 0.0f;
+          RTCHitN_Ng_y(hit,args->N,i) = 0.0f;
+          RTCHitN_Ng_z(hit,args->N,i) = 1.0f;
+          RTCHitN_u(hit,args->N,i) = 0.0f;
+          RTCHitN_v(hit,args->N,i) = 0.0f;
+          RTCHitN_primID(hit,args->N,i) = primID;
+          RTCHitN_geomID(hit,args->N,i) = squares->geomID;
+          RTCHitN_instID(hit,args->N,i,0) = args->context->instID[0];
+        }
       }
-      return passed;
     }
-    
-    bool checkGridInterpolation(RTCGeometry geom, RTCBufferType bufferType, unsigned int bufferSlot, size_t N)
+
+    static void occludedFuncN(const struct RTCOccludedFunctionNArguments* const args)
     {
-      bool passed = true;
-      for (size_t i=0; i<100; i++) {
-        const float u = random_float();
-        const float v = random_float();
-        passed &= checkGridInterpolation(geom,0,u,v,bufferType,bufferSlot,N);
+      Squares* squares = (Squares*) args->geometryUserPtr;
+      recordPrimCount(squares,args->primCount);
+      for (unsigned int j=0; j<args->primCount; j++)
+      {
+        for (unsigned int i=0; i<args->N; i++)
+        {
+          float t;
+          if (!args->valid[i] || !hitSquare(args->ray,args->N,i,args->primIDs[j],t)) continue;
+          RTCRayN_tfar(args->ray,args->N,i) = neg_inf;
+        }
       }
-      return passed;
     }
 
     VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
@@ -2124,168 +3532,135 @@ namespace embree
       std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
       RTCDeviceRef device = rtcNewDevice(cfg.c_str());
       errorHandler(nullptr,rtcGetDeviceError(device));
+      if (!supportsIntersectMode(device,imode))
+        return VerifyApplication::SKIPPED;
 
-      size_t M = 16*N+16; // padds the arrays with some valid data
-      
-      RTCGeometry geom = rtcNewGeometry(device, RTC_GEOMETRY_TYPE_GRID);
+      Squares squares;
+      VerifyScene scene(device,sflags);
+      RTCGeometry geom = rtcNewGeometry(device,RTC_GEOMETRY_TYPE_USER);
+      rtcSetGeometryUserPrimitiveCount(geom,numPrimitives);
+      rtcSetGeometryUserData(geom,&squares);
+      rtcSetGeometryBoundsFunction(geom,boundsFunc,nullptr);
+      rtcSetGeometryIntersectFunction(geom,intersectFuncN);
+      rtcSetGeometryOccludedFunction(geom,occludedFuncN);
+      rtcSetGeometryUserPrimitiveBatchSize(geom,0);
+      AssertError(device,RTC_ERROR_INVALID_ARGUMENT);
+      squares.geomID = rtcAttachGeometry(scene,geom);
       AssertNoError(device);
 
-      interpolation_grids[0].startVertexID = 0;
-      interpolation_grids[0].stride = 4;
-      interpolation_grids[0].width = 4;
-      interpolation_grids[0].height = 4;
-      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_GRID, 0, RTC_FORMAT_GRID, interpolation_grids, 0, sizeof(RTCGrid), 1);
-      AssertNoError(device);
-      
-      std::vector<float> vertices0(M);
-      for (size_t y=0; y<4; y++)
-        for (size_t x=0; x<4; x++)
-          for (size_t i=0; i<N; i++)
-            vertices0[(y*4+x)*N+i] = (2.0f*float(x)/3.0f + 3.0f*y/3.0f)+float(i);
-      
-      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX, 0, RTC_FORMAT_FLOAT3, vertices0.data(), 0, N*sizeof(float), 4*4);
-      AssertNoError(device);
-      
-      rtcCommitGeometry(geom);
-      AssertNoError(device);
-      
-      bool passed = true;
-      passed &= checkGridInterpolation(geom,RTC_BUFFER_TYPE_VERTEX,0,N);
+      for (unsigned int batchSize : { 1, 4 })
+      {
+        rtcSetGeometryUserPrimitiveBatchSize(geom,batchSize);
+        rtcCommitGeometry(geom);
+        rtcCommitScene(scene);
+        AssertNoError(device);
+
+        squares.maxPrimCount = 0;
+        const unsigned int numRays = 64;
+        RTCRayHit rays[numRays];
+        for (unsigned int i=0; i<numRays; i++)
+          rays[i] = makeRay(Vec3fa(float((4*i+1)%numPrimitives)+0.5f,0.5f,10.0f),Vec3fa(0.0f,0.0f,-1.0f));
+        IntersectWithMode(imode,ivariant,scene,rays,numRays);
+        AssertNoError(device);
+
+        for (unsigned int i=0; i<numRays; i++)
+        {
+          if (!(ivariant & VARIANT_INTERSECT)) {
+            if (rays[i].ray.tfar != float(neg_inf)) return VerifyApplication::FAILED;
+            continue;
+          }
+          if (rays[i].hit.geomID != squares.geomID) return VerifyApplication::FAILED;
+          if (rays[i].hit.primID != (4*i+1)%numPrimitives) return VerifyApplication::FAILED;
+          if (abs(rays[i].ray.tfar-10.0f) > 1E-4f) return VerifyApplication::FAILED;
+        }
+
+        /* the callbacks never see more primitives than the batch size, but get entire leaves */
+        if (squares.maxPrimCount > batchSize) return VerifyApplication::FAILED;
+        if (batchSize > 1 && imode == MODE_INTERSECT1 && squares.maxPrimCount < 2)
+          return VerifyApplication::FAILED;
+      }
       rtcReleaseGeometry(geom);
-      AssertNoError(device);
 
-      return (VerifyApplication::TestReturnValue) passed;
+      RTCGeometry triangles = rtcNewGeometry(device,RTC_GEOMETRY_TYPE_TRIANGLE);
+      rtcSetGeometryUserPrimitiveBatchSize(triangles,4);
+      AssertError(device,RTC_ERROR_INVALID_OPERATION);
+      rtcReleaseGeometry(triangles);
+      return VerifyApplication::PASSED;
     }
   };
-  
-  const size_t num_interpolation_hair_vertices = 13;
-  const size_t num_interpolation_hairs = 4;
-
-  __aligned(16) int interpolation_hair_indices[num_interpolation_hairs] = {
-    0, 3, 6, 9
-  };
 
-  struct InterpolateHairTest : public VerifyApplication::Test
+  struct RayMasksTest : public VerifyApplication::IntersectTest
   {
-    size_t N;
-    
-    InterpolateHairTest (std::string name, int isa, size_t N)
-      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), N(N) {}
-    
-    bool checkHairInterpolation(RTCGeometry geom, int primID, float u, float v, int v0, RTCBufferType bufferType, unsigned int bufferSlot, float* data, size_t N, size_t N_total)
-    {
-      assert(N<256);
-      bool passed = true;
-      float P[256], dPdu[256], dPdv[256];
-      rtcInterpolate1(geom,primID,u,v,bufferType,bufferSlot,P,dPdu,dPdv,(unsigned int)N);
-      
-      for (size_t i=0; i<N; i++) {
-        const float p00 = data[(v0+0)*N_total+i];
-        const float p01 = data[(v0+1)*N_total+i];
-        const float p02 = data[(v0+2)*N_total+i];
-        const float p03 = data[(v0+3)*N_total+i];
-        const float t0 = 1.0f - u, t1 = u;
-        const float p10 = p00 * t0 + p01 * t1;
-        const float p11 = p01 * t0 + p02 * t1;
-        const float p12 = p02 * t0 + p03 * t1;
-        const float p20 = p10 * t0 + p11 * t1;
-        const float p21 = p11 * t0 + p12 * t1;
-        const float p30 = p20 * t0 + p21 * t1;
-        passed &= fabs(p30-P[i]) < 1E-4f;
-      }
-      return passed;
-    }
-    
-    bool checkHairInterpolation(RTCGeometry geom, RTCBufferType bufferType, unsigned int bufferSlot, float* vertices0, size_t N, size_t N_total)
-    {
-      bool passed = true;
-      passed &= checkHairInterpolation(geom,0,0.0f,0.0f,0,bufferType,bufferSlot,vertices0,N,N_total);
-      passed &= checkHairInterpolation(geom,1,0.5f,0.0f,3,bufferType,bufferSlot,vertices0,N,N_total);
-      passed &= checkHairInterpolation(geom,2,0.0f,0.0f,6,bufferType,bufferSlot,vertices0,N,N_total);
-      passed &= checkHairInterpolation(geom,3,0.2f,0.0f,9,bufferType,bufferSlot,vertices0,N,N_total);
-      return passed;
-    }
-    
+    SceneFlags sflags; 
+    RTCBuildQuality quality; 
+
+    RayMasksTest (std::string name, int isa, SceneFlags sflags, RTCBuildQuality quality, IntersectMode imode, IntersectVariant ivariant)
+      : VerifyApplication::IntersectTest(name,isa,imode,ivariant,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags), quality(quality) {}
+
     VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
     {
       std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
       RTCDeviceRef device = rtcNewDevice(cfg.c_str());
       errorHandler(nullptr,rtcGetDeviceError(device));
+      if (!supportsIntersectMode(device,imode))
+        return VerifyApplication::SKIPPED;
 
-      size_t M = num_interpolation_hair_vertices*N+16; // padds the arrays with some valid data
-      
-      RTCGeometry geom = rtcNewGeometry(device, RTC_GEOMETRY_TYPE_ROUND_BEZIER_CURVE);
-      AssertNoError(device);
-      rtcSetGeometryVertexAttributeCount(geom,2);
-      
-      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_INDEX, 0, RTC_FORMAT_UINT, interpolation_hair_indices, 0, sizeof(unsigned int), num_interpolation_hairs);
-      AssertNoError(device);
-      
-      std::vector<float> vertices0(M);
-      for (size_t i=0; i<M; i++) vertices0[i] = random_float();
-      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX, 0, RTC_FORMAT_FLOAT4, vertices0.data(), 0, N*sizeof(float), num_interpolation_hair_vertices);
-      AssertNoError(device);
-      
-      /*std::vector<float> vertices1(M);
-        for (size_t i=0; i<M; i++) vertices1[i] = random_float();
-        rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX, 1, RTC_FORMAT_FLOAT4, vertices1.data(), 0, N*sizeof(float), num_interpolation_hair_vertices);
-        AssertNoError(device);*/
-      
-      std::vector<float> user_vertices0(M);
-      for (size_t i=0; i<M; i++) user_vertices0[i] = random_float();
-      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE, 0, RTCFormat(RTC_FORMAT_FLOAT+N), user_vertices0.data(), 0, N*sizeof(float), num_interpolation_hair_vertices);
-      AssertNoError(device);
-      
-      std::vector<float> user_vertices1(M);
-      for (size_t i=0; i<M; i++) user_vertices1[i] = random_float();
-      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE, 1, RTCFormat(RTC_FORMAT_FLOAT+N), user_vertices1.data(), 0, N*sizeof(float), num_interpolation_hair_vertices);
-      AssertNoError(device);
+      bool passed = true;
+      Vec3fa pos0 = Vec3fa(-10,0,-10);
+      Vec3fa pos1 = Vec3fa(-10,0,+10);
+      Vec3fa pos2 = Vec3fa(+10,0,-10);
+      Vec3fa pos3 = Vec3fa(+10,0,+10);
       
-      rtcDisableGeometry(geom);
-      AssertNoError(device);
-      rtcCommitGeometry(geom);
+      VerifyScene scene(device,sflags);
+      unsigned int geom0 = scene.addSphere      (sampler,quality,pos0,1.0f,50).first;
+      unsigned int geom1 = scene.addQuadSphere  (sampler,quality,pos1,1.0f,50).first; 
+      unsigned int geom2 = scene.addSubdivSphere(sampler,quality,pos2,1.0f,5,4).first;
+      unsigned int geom3 = scene.addHair        (sampler,quality,pos3,1.0f,1.0f,1).first;
+      RTCGeometry hgeom0 = rtcGetGeometry(scene,geom0);
+      RTCGeometry hgeom1 = rtcGetGeometry(scene,geom1);
+      RTCGeometry hgeom2 = rtcGetGeometry(scene,geom2);
+      RTCGeometry hgeom3 = rtcGetGeometry(scene,geom3);
+      rtcSetGeometryMask(hgeom0,1);
+      rtcSetGeometryMask(hgeom1,2);
+      rtcSetGeometryMask(hgeom2,4);
+      rtcSetGeometryMask(hgeom3,8);
+      rtcCommitScene (scene);
       AssertNoError(device);
       
-      bool passed = true;
-      if (N >= 4) {
-        passed &= checkHairInterpolation(geom,RTC_BUFFER_TYPE_VERTEX,0,vertices0.data(),4,N);
-        //passed &= checkHairInterpolation(geom,RTC_BUFFER_TYPE_VERTEX,1,vertices1.data(),4,N);
+      for (unsigned i=0; i<16; i++) 
+      {
+        unsigned mask0 = i;
+        unsigned mask1 = i+1;
+        unsigned mask2 = i+2;
+        unsigned mask3 = i+3;
+        unsigned masks[4] = { mask0, mask1, mask2, mask3 };
+        RTCRayHit ray0 = makeRay(pos0+Vec3fa(0,10,0),Vec3fa(0,-1,0)); ray0.ray.mask = mask0;
+        RTCRayHit ray1 = makeRay(pos1+Vec3fa(0,10,0),Vec3fa(0,-1,0)); ray1.ray.mask = mask1;
+        RTCRayHit ray2 = makeRay(pos2+Vec3fa(0,10,0),Vec3fa(0,-1,0)); ray2.ray.mask = mask2;
+        RTCRayHit ray3 = makeRay(pos3+Vec3fa(0,10,0),Vec3fa(0,-1,0)); ray3.ray.mask = mask3;
+        RTCRayHit rays[4] = { ray0, ray1, ray2, ray3 };
+        IntersectWithMode(imode,ivariant,scene,rays,4);
+        for (size_t j=0; j<4; j++)
+          passed &= masks[j] & (1<<j) ? rays[j].hit.geomID != RTC_INVALID_GEOMETRY_ID : rays[j].hit.geomID == RTC_INVALID_GEOMETRY_ID;
       }
-      passed &= checkHairInterpolation(geom,RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE,0,user_vertices0.data(),N,N);
-      passed &= checkHairInterpolation(geom,RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE,1,user_vertices1.data(),N,N);
-      
-      passed &= checkHairInterpolation(geom,RTC_BUFFER_TYPE_VERTEX,0,vertices0.data(),1,N);
-      //passed &= checkHairInterpolation(geom,RTC_BUFFER_TYPE_VERTEX,1,vertices1.data(),1,N);
-      passed &= checkHairInterpolation(geom,RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE,0,user_vertices0.data(),1,N);
-      passed &= checkHairInterpolation(geom,RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE,1,user_vertices1.data(),1,N);
-
-      rtcReleaseGeometry(geom);
       AssertNoError(device);
 
       return (VerifyApplication::TestReturnValue) passed;
     }
   };
 
-  /////////////////////////////////////////////////////////////////////////////////
-  /////////////////////////////////////////////////////////////////////////////////
-  /////////////////////////////////////////////////////////////////////////////////
-  /////////////////////////////////////////////////////////////////////////////////
-
-  struct TriangleHitTest : public VerifyApplication::IntersectTest
+  struct RayMaskUpdateTest : public VerifyApplication::IntersectTest
   {
-    SceneFlags sflags; 
-    RTCBuildQuality quality; 
+    static const unsigned int numGeometries = 12;
 
-    TriangleHitTest (std::string name, int isa, SceneFlags sflags, RTCBuildQuality quality, IntersectMode imode, IntersectVariant ivariant)
-      : VerifyApplication::IntersectTest(name,isa,imode,ivariant,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags), quality(quality) {}
+    SceneFlags sflags;
 
-    inline Vec3fa uniformSampleTriangle(const Vec3fa &a, const Vec3fa &b, const Vec3fa &c, float &u, float& v)
-    {
-      const float su = sqrtf(u);
-      v *= su;
-      u = 1.0f-su;
-      if (u < 0.001f || v < 0.001f || (u+v) > 0.999f) { u = 0.333f; v = 0.333f; } // avoid hitting edges
-      return c + u * (a-c) + v * (b-c);
+    RayMaskUpdateTest (std::string name, int isa, SceneFlags sflags, IntersectMode imode, IntersectVariant ivariant)
+      : VerifyApplication::IntersectTest(name,isa,imode,ivariant,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+
+    /* rotates the mask bits through the geometries and masks out every 4th geometry entirely */
+    static unsigned int geometryMask(unsigned int i, unsigned int iter) {
+      return (i+iter)%4 == 3 ? 0 : 1 << ((i+iter)%numGeometries);
     }
 
     VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
@@ -2295,79 +3670,68 @@ namespace embree
       errorHandler(nullptr,rtcGetDeviceError(device));
       if (!supportsIntersectMode(device,imode))
         return VerifyApplication::SKIPPED;
-     
-      Vec3f vertices[4] = {
-        Vec3f(0.0f,0.0f,0.0f),
-        Vec3f(1.0f,0.0f,0.0f),
-        Vec3f(0.0f,1.0f,0.0f),
-        Vec3f(zero) // dummy vertex for 16 byte padding
-      };
-      Triangle triangles[1] = {
-        Triangle(0,1,2)
-      };
-      RTCSceneRef scene = rtcNewScene(device);
-      rtcSetSceneFlags(scene,sflags.sflags);
-      rtcSetSceneBuildQuality(scene,sflags.qflags);
-      
-      RTCGeometry geom = rtcNewGeometry (device, RTC_GEOMETRY_TYPE_TRIANGLE);
-      rtcSetGeometryBuildQuality(geom,quality);
-      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX, 0, RTC_FORMAT_FLOAT3, vertices , 0, sizeof(Vec3f), 3);
-      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_INDEX , 0, RTC_FORMAT_UINT3,  triangles, 0, sizeof(Triangle), 1);
-      rtcCommitGeometry(geom);
-      rtcAttachGeometry(scene,geom);
-      rtcReleaseGeometry(geom);
-      rtcCommitScene (scene);
-      AssertNoError(device);
 
-      float u[256], v[256];
-      RTCRayHit rays[256];
-      for (size_t i=0; i<256; i++)
+      /* row of triangle, quad and hair geometries */
+      VerifyScene scene(device,sflags);
+      Vec3fa pos[numGeometries];
+      RTCGeometry geom[numGeometries];
+      for (unsigned int i=0; i<numGeometries; i++)
       {
-        u[i] = random_float(); 
-        v[i] = random_float();
-        Vec3fa from(0.0f,0.0f,-1.0f);
-        Vec3fa to = uniformSampleTriangle(vertices[1],vertices[2],vertices[0],u[i],v[i]);
-        rays[i] = makeRay(from,to-from);
+        pos[i] = Vec3fa(4.0f*float(i),0.0f,0.0f);
+        unsigned int geomID = 0;
+        switch (i%3) {
+        case 0 : geomID = scene.addSphere    (sampler,RTC_BUILD_QUALITY_MEDIUM,pos[i],1.0f,50).first; break;
+        case 1 : geomID = scene.addQuadSphere(sampler,RTC_BUILD_QUALITY_MEDIUM,pos[i],1.0f,50).first; break;
+        default: geomID = scene.addHair      (sampler,RTC_BUILD_QUALITY_MEDIUM,pos[i],1.0f,1.0f,1).first; break;
+        }
+        geom[i] = rtcGetGeometry(scene,geomID);
+        rtcSetGeometryMask(geom[i],geometryMask(i,0));
       }
-      IntersectWithMode(imode,ivariant,scene,rays,256);
+      rtcCommitScene (scene);
+      AssertNoError(device);
 
-      for (size_t i=0; i<256; i++)
+      bool passed = true;
+      for (unsigned int iter=0; iter<8; iter++)
       {
-        
-        if (!(ivariant & VARIANT_INTERSECT)) 
+        /* every other ray only sees the geometry it is shot at */
+        RTCRayHit rays[numGeometries];
+        bool hit[numGeometries];
+        for (unsigned int j=0; j<numGeometries; j++)
         {
-          if (rays[i].ray.tfar != float(neg_inf)) return VerifyApplication::FAILED;          
-          continue;
+          const unsigned int mask = (j+iter)%2 ? geometryMask(j,iter) : ~geometryMask(j,iter);
+          rays[j] = makeRay(pos[j]+Vec3fa(0,10,0),Vec3fa(0,-1,0));
+          rays[j].ray.mask = mask;
+          hit[j] = (mask & geometryMask(j,iter)) != 0;
+        }
+        IntersectWithMode(imode,ivariant,scene,rays,numGeometries);
+        for (unsigned int j=0; j<numGeometries; j++)
+        {
+          if (ivariant & VARIANT_INTERSECT)
+            passed &= hit[j] == (rays[j].hit.geomID != RTC_INVALID_GEOMETRY_ID);
+          else
+            passed &= hit[j] == (rays[j].ray.tfar == float(neg_inf));
         }
 
-
-        if (rays[i].hit.geomID != 0) return VerifyApplication::FAILED;
-        if (rays[i].hit.primID != 0) return VerifyApplication::FAILED;
-        if (abs(rays[i].hit.u - u[i]) > 16.0f*float(ulp)) return VerifyApplication::FAILED;
-        if (abs(rays[i].hit.v - v[i]) > 16.0f*float(ulp)) return VerifyApplication::FAILED;
-        if (abs(rays[i].ray.tfar - 1.0f) > 16.0f*float(ulp)) return VerifyApplication::FAILED;
-        const Vec3fa org(rays[i].ray.org_x,rays[i].ray.org_y,rays[i].ray.org_z);
-        const Vec3fa dir(rays[i].ray.dir_x,rays[i].ray.dir_y,rays[i].ray.dir_z);
-        const Vec3fa ht  = org + rays[i].ray.tfar*dir;
-        const Vec3fa huv = vertices[0] + rays[i].hit.u*(vertices[1]-vertices[0]) + rays[i].hit.v*(vertices[2]-vertices[0]);
-        if (reduce_max(abs(ht-huv)) > 16.0f*float(ulp)) return VerifyApplication::FAILED;
-        const Vec3fa Ng = Vec3fa(rays[i].hit.Ng_x,rays[i].hit.Ng_y,rays[i].hit.Ng_z);
-        if (reduce_max(abs(Ng - Vec3fa(0.0f,0.0f,1.0f))) > 16.0f*float(ulp)) return VerifyApplication::FAILED;
+        /* change the masks without committing the geometries */
+        for (unsigned int i=0; i<numGeometries; i++)
+          rtcSetGeometryMask(geom[i],geometryMask(i,iter+1));
+        rtcCommitScene (scene);
+        AssertNoError(device);
       }
-      AssertNoError(device);
 
-      return VerifyApplication::PASSED;
+      return (VerifyApplication::TestReturnValue) passed;
     }
   };
 
-  struct QuadHitTest : public VerifyApplication::IntersectTest
+  struct BackfaceCullingTest : public VerifyApplication::IntersectTest
   {
-    SceneFlags sflags; 
-    RTCBuildQuality quality; 
-
-    QuadHitTest (std::string name, int isa, SceneFlags sflags, RTCBuildQuality quality, IntersectMode imode, IntersectVariant ivariant)
-      : VerifyApplication::IntersectTest(name,isa,imode,ivariant,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags), quality(quality) {}
+    SceneFlags sflags;
+    RTCBuildQuality quality;
+    GeometryType gtype;
 
+    BackfaceCullingTest (std::string name, int isa, SceneFlags sflags, RTCBuildQuality quality, GeometryType gtype, IntersectMode imode, IntersectVariant ivariant)
+      : VerifyApplication::IntersectTest(name,isa,imode,ivariant,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags), quality(quality), gtype(gtype) {}
+    
     VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
     {
       std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
@@ -2375,77 +3739,90 @@ namespace embree
       errorHandler(nullptr,rtcGetDeviceError(device));
       if (!supportsIntersectMode(device,imode))
         return VerifyApplication::SKIPPED;
-     
-      Vec3f vertices[5] = {
-        Vec3f(0.0f,0.0f,0.0f),
-        Vec3f(1.0f,0.0f,0.0f),
-        Vec3f(1.0f,1.0f,0.0f),
-        Vec3f(0.0f,1.0f,0.0f),
-        Vec3f(zero) // dummy vertex for 16 byte padding
-      };
-      int quads[4] = {
-        0,1,2,3
-      };
-      RTCSceneRef scene = rtcNewScene(device);
-      rtcSetSceneFlags(scene,sflags.sflags);
-      rtcSetSceneBuildQuality(scene,sflags.qflags);
+       
+      /* create triangle that is front facing for a right handed 
+         coordinate system if looking along the z direction */
+      VerifyScene scene(device,sflags);
+      AssertNoError(device);
+      const Vec3fa p0 = Vec3fa(0.0f);
+      const Vec3fa dx = Vec3fa(0.0f,1.0f,0.0f);
+      const Vec3fa dy = Vec3fa(1.0f,0.0f,0.0f);
+      switch (gtype) {
+      case TRIANGLE_MESH:    scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createTrianglePlane(p0,dx,dy,1,1)); break;
+      case TRIANGLE_MESH_MB: scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createTrianglePlane(p0,dx,dy,1,1)->set_motion_vector(zero)); break;
+      case QUAD_MESH:        scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createQuadPlane(p0,dx,dy,1,1)); break;
+      case QUAD_MESH_MB:     scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createQuadPlane(p0,dx,dy,1,1)->set_motion_vector(zero)); break;
+      case GRID_MESH:        scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createGridPlane(p0,dx,dy,1,1)); break;
+      case GRID_MESH_MB:     scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createGridPlane(p0,dx,dy,1,1)->set_motion_vector(zero)); break;
+      case SUBDIV_MESH:      scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createSubdivPlane(p0,dx,dy,1,1,4.0f)); break;
+      case SUBDIV_MESH_MB:   scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createSubdivPlane(p0,dx,dy,1,1,4.0f)->set_motion_vector(zero)); break;
+      default:               throw std::runtime_error("unsupported geometry type: "+to_string(gtype)); 
+      }
       
-      RTCGeometry geom = rtcNewGeometry (device, RTC_GEOMETRY_TYPE_QUAD);
-      rtcSetGeometryBuildQuality(geom, quality);
-      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX, 0, RTC_FORMAT_FLOAT3, vertices , 0, sizeof(Vec3f), 4);
-      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_INDEX , 0, RTC_FORMAT_UINT4,  quads, 0, 4*sizeof(int), 1);
-      rtcCommitGeometry(geom);
-      rtcAttachGeometry(scene,geom);
-      rtcReleaseGeometry(geom);
+      AssertNoError(device);
       rtcCommitScene (scene);
       AssertNoError(device);
 
-      float u[256], v[256];
-      RTCRayHit rays[256];
-      for (size_t i=0; i<256; i++)
-      {
-        u[i] = random_float(); 
-        v[i] = random_float();
-        if (u[i] < 0.001f || v[i] < 0.001f || u[i] > 0.999f || v[i] > 0.999f) { u[i] = 0.333f; v[i] = 0.333f; } // avoid hitting edges
-        Vec3fa from(0.0f,0.0f,-1.0f);
-        Vec3fa to = vertices[0] + u[i]*(vertices[1]-vertices[0]) + v[i]*(vertices[3]-vertices[0]);
-        rays[i] = makeRay(from,to-from);
-      }
-      IntersectWithMode(imode,ivariant,scene,rays,256);
+      const size_t numRays = 1000;
+      RTCRayHit rays[numRays];
+      bool passed = true;
 
-      for (size_t i=0; i<256; i++)
+      for (size_t i=0; i<numRays; i++) {
+        const float rx = random_float();
+        const float ry = random_float();
+        if (i%2) rays[i] = makeRay(Vec3fa(rx,ry,+1),Vec3fa(0,0,-1)); 
+        else     rays[i] = makeRay(Vec3fa(rx,ry,-1),Vec3fa(0,0,+1)); 
+      }
+      
+      IntersectWithMode(imode,ivariant,scene,rays,numRays);
+      
+      for (size_t i=0; i<numRays; i++) 
       {
-        if (!(ivariant & VARIANT_INTERSECT))
-        {
-          if (rays[i].ray.tfar != float(neg_inf)) return VerifyApplication::FAILED;          
-          continue;
+        Vec3fa dir(rays[i].ray.dir_x,rays[i].ray.dir_y,rays[i].ray.dir_z);
+        Vec3fa Ng (rays[i].hit.Ng_x, rays[i].hit.Ng_y, rays[i].hit.Ng_z);
+        if (i%2) passed &= rays[i].hit.geomID == RTC_INVALID_GEOMETRY_ID;
+        else {
+          passed &= rays[i].hit.geomID == 0;
+          if (ivariant & VARIANT_INTERSECT)
+            passed &= dot(dir,Ng) < 0.0f;
         }
-        if (rays[i].hit.primID != 0) return VerifyApplication::FAILED;
-        if (abs(rays[i].hit.u - u[i]) > 16.0f*float(ulp)) return VerifyApplication::FAILED;
-        if (abs(rays[i].hit.v - v[i]) > 16.0f*float(ulp)) return VerifyApplication::FAILED;
-        if (abs(rays[i].ray.tfar - 1.0f) > 16.0f*float(ulp)) return VerifyApplication::FAILED;
-
-        const Vec3fa org(rays[i].ray.org_x,rays[i].ray.org_y,rays[i].ray.org_z);
-        const Vec3fa dir(rays[i].ray.dir_x,rays[i].ray.dir_y,rays[i].ray.dir_z);
-        const Vec3fa ht  = org + rays[i].ray.tfar*dir;
-        const Vec3fa huv = vertices[0] + rays[i].hit.u*(vertices[1]-vertices[0]) + rays[i].hit.v*(vertices[3]-vertices[0]);
-        if (reduce_max(abs(ht-huv)) > 16.0f*float(ulp)) return VerifyApplication::FAILED;
-        const Vec3fa Ng = Vec3fa(rays[i].hit.Ng_x,rays[i].hit.Ng_y,rays[i].hit.Ng_z);
-        if (reduce_max(abs(Ng - Vec3fa(0.0f,0.0f,1.0f))) > 16.0f*float(ulp)) return VerifyApplication::FAILED;
       }
       AssertNoError(device);
-      
-      return VerifyApplication::PASSED;
+
+      return (VerifyApplication::TestReturnValue) passed;
     }
   };
-  
-  struct RayMasksTest : public VerifyApplication::IntersectTest
+
+  struct ContextFlagsTest : public VerifyApplication::IntersectTest
   {
-    SceneFlags sflags; 
-    RTCBuildQuality quality; 
+    SceneFlags sflags;
+    GeometryType gtype;
 
-    RayMasksTest (std::string name, int isa, SceneFlags sflags, RTCBuildQuality quality, IntersectMode imode, IntersectVariant ivariant)
-      : VerifyApplication::IntersectTest(name,isa,imode,ivariant,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags), quality(quality) {}
+    ContextFlagsTest (std::string name, int isa, SceneFlags sflags, GeometryType gtype, IntersectMode imode, IntersectVariant ivariant)
+      : VerifyApplication::IntersectTest(name,isa,imode,ivariant,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags), gtype(gtype) {}
+
+    static void rejectAllFilter(const RTCFilterFunctionNArguments* args)
+    {
+      for (unsigned int i=0; i<args->N; i++)
+        args->valid[i] = 0;
+    }
+
+    static unsigned int addPlane(VerifyScene& scene, GeometryType gtype, const Vec3fa& p0)
+    {
+      const Vec3fa dx = Vec3fa(0.0f,1.0f,0.0f);
+      const Vec3fa dy = Vec3fa(1.0f,0.0f,0.0f);
+      switch (gtype) {
+      case TRIANGLE_MESH:    return scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createTrianglePlane(p0,dx,dy,1,1));
+      case TRIANGLE_MESH_MB: return scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createTrianglePlane(p0,dx,dy,1,1)->set_motion_vector(zero));
+      case QUAD_MESH:        return scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createQuadPlane(p0,dx,dy,1,1));
+      case QUAD_MESH_MB:     return scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createQuadPlane(p0,dx,dy,1,1)->set_motion_vector(zero));
+      case GRID_MESH:        return scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createGridPlane(p0,dx,dy,1,1));
+      case GRID_MESH_MB:     return scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createGridPlane(p0,dx,dy,1,1)->set_motion_vector(zero));
+      case SUBDIV_MESH:      return scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createSubdivPlane(p0,dx,dy,1,1,4.0f));
+      case SUBDIV_MESH_MB:   return scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createSubdivPlane(p0,dx,dy,1,1,4.0f)->set_motion_vector(zero));
+      default:               throw std::runtime_error("unsupported geometry type: "+to_string(gtype));
+      }
+    }
 
     VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
     {
@@ -2455,43 +3832,66 @@ namespace embree
       if (!supportsIntersectMode(device,imode))
         return VerifyApplication::SKIPPED;
 
-      bool passed = true;
-      Vec3fa pos0 = Vec3fa(-10,0,-10);
-      Vec3fa pos1 = Vec3fa(-10,0,+10);
-      Vec3fa pos2 = Vec3fa(+10,0,-10);
-      Vec3fa pos3 = Vec3fa(+10,0,+10);
-      
+      /* two parallel planes that are front facing for rays along the z
+         direction and that reject all hits through filter functions */
       VerifyScene scene(device,sflags);
-      unsigned int geom0 = scene.addSphere      (sampler,quality,pos0,1.0f,50).first;
-      unsigned int geom1 = scene.addQuadSphere  (sampler,quality,pos1,1.0f,50).first; 
-      unsigned int geom2 = scene.addSubdivSphere(sampler,quality,pos2,1.0f,5,4).first;
-      unsigned int geom3 = scene.addHair        (sampler,quality,pos3,1.0f,1.0f,1).first;
-      RTCGeometry hgeom0 = rtcGetGeometry(scene,geom0);
-      RTCGeometry hgeom1 = rtcGetGeometry(scene,geom1);
-      RTCGeometry hgeom2 = rtcGetGeometry(scene,geom2);
-      RTCGeometry hgeom3 = rtcGetGeometry(scene,geom3);
-      rtcSetGeometryMask(hgeom0,1);
-      rtcSetGeometryMask(hgeom1,2);
-      rtcSetGeometryMask(hgeom2,4);
-      rtcSetGeometryMask(hgeom3,8);
+      const unsigned int geomIDs[2] = { addPlane(scene,gtype,Vec3fa(0.0f,0.0f,0.0f)), addPlane(scene,gtype,Vec3fa(0.0f,0.0f,0.25f)) };
+      for (unsigned int geomID : geomIDs) {
+        RTCGeometry geom = rtcGetGeometry(scene,geomID);
+        rtcSetGeometryIntersectFilterFunction(geom,rejectAllFilter);
+        rtcSetGeometryOccludedFilterFunction(geom,rejectAllFilter);
+      }
       rtcCommitScene (scene);
       AssertNoError(device);
-      
-      for (unsigned i=0; i<16; i++) 
+
+      const RTCIntersectContextFlags opaque = RTC_INTERSECT_CONTEXT_FLAG_OPAQUE;
+      const RTCIntersectContextFlags flags[] = {
+        RTC_INTERSECT_CONTEXT_FLAG_NONE,
+        opaque,
+        RTCIntersectContextFlags(opaque | RTC_INTERSECT_CONTEXT_FLAG_CULL_BACKFACES),
+        RTCIntersectContextFlags(opaque | RTC_INTERSECT_CONTEXT_FLAG_CULL_FRONTFACES),
+        RTCIntersectContextFlags(opaque | RTC_INTERSECT_CONTEXT_FLAG_CULL_BACKFACES | RTC_INTERSECT_CONTEXT_FLAG_CULL_FRONTFACES),
+        RTCIntersectContextFlags(opaque | RTC_INTERSECT_CONTEXT_FLAG_TERMINATE_ON_FIRST_HIT)
+      };
+
+      const size_t numRays = 256;
+      RTCRayHit rays[numRays];
+      bool passed = true;
+
+      for (RTCIntersectContextFlags flag : flags)
       {
-        unsigned mask0 = i;
-        unsigned mask1 = i+1;
-        unsigned mask2 = i+2;
-        unsigned mask3 = i+3;
-        unsigned masks[4] = { mask0, mask1, mask2, mask3 };
-        RTCRayHit ray0 = makeRay(pos0+Vec3fa(0,10,0),Vec3fa(0,-1,0)); ray0.ray.mask = mask0;
-        RTCRayHit ray1 = makeRay(pos1+Vec3fa(0,10,0),Vec3fa(0,-1,0)); ray1.ray.mask = mask1;
-        RTCRayHit ray2 = makeRay(pos2+Vec3fa(0,10,0),Vec3fa(0,-1,0)); ray2.ray.mask = mask2;
-        RTCRayHit ray3 = makeRay(pos3+Vec3fa(0,10,0),Vec3fa(0,-1,0)); ray3.ray.mask = mask3;
-        RTCRayHit rays[4] = { ray0, ray1, ray2, ray3 };
-        IntersectWithMode(imode,ivariant,scene,rays,4);
-        for (size_t j=0; j<4; j++)
-          passed &= masks[j] & (1<<j) ? rays[j].hit.geomID != RTC_INVALID_GEOMETRY_ID : rays[j].hit.geomID == RTC_INVALID_GEOMETRY_ID;
+        /* even rays hit the front side of the planes, odd rays the back side */
+        for (size_t i=0; i<numRays; i++) {
+          const float rx = random_float();
+          const float ry = random_float();
+          if (i%2) rays[i] = makeRay(Vec3fa(rx,ry,+1),Vec3fa(0,0,-1));
+          else     rays[i] = makeRay(Vec3fa(rx,ry,-1),Vec3fa(0,0,+1));
+        }
+
+        IntersectWithMode(imode,ivariant,scene,rays,numRays,flag);
+
+        const bool cullBack  = flag & RTC_INTERSECT_CONTEXT_FLAG_CULL_BACKFACES;
+        const bool cullFront = flag & RTC_INTERSECT_CONTEXT_FLAG_CULL_FRONTFACES;
+        const bool terminate = flag & RTC_INTERSECT_CONTEXT_FLAG_TERMINATE_ON_FIRST_HIT;
+        for (size_t i=0; i<numRays; i++)
+        {
+          const bool visible = (flag & opaque) && !(i%2 ? cullBack : cullFront);
+          if (!(ivariant & VARIANT_INTERSECT)) {
+            passed &= (rays[i].ray.tfar == float(neg_inf)) == visible;
+            continue;
+          }
+          if (!visible) {
+            passed &= rays[i].hit.geomID == RTC_INVALID_GEOMETRY_ID;
+            continue;
+          }
+
+          /* without early termination only the closest plane can be reported */
+          const unsigned int closest = i%2 ? geomIDs[1] : geomIDs[0];
+          if (terminate) passed &= rays[i].hit.geomID == geomIDs[0] || rays[i].hit.geomID == geomIDs[1];
+          else           passed &= rays[i].hit.geomID == closest;
+          const float t = rays[i].hit.geomID == geomIDs[i%2] ? (i%2 ? 0.75f : 1.0f) : (i%2 ? 1.0f : 1.25f);
+          passed &= abs(rays[i].ray.tfar-t) < 1E-4f;
+        }
       }
       AssertNoError(device);
 
@@ -2499,15 +3899,14 @@ namespace embree
     }
   };
 
-  struct BackfaceCullingTest : public VerifyApplication::IntersectTest
+  struct IgnorePrimitiveTest : public VerifyApplication::IntersectTest
   {
     SceneFlags sflags;
-    RTCBuildQuality quality;
     GeometryType gtype;
 
-    BackfaceCullingTest (std::string name, int isa, SceneFlags sflags, RTCBuildQuality quality, GeometryType gtype, IntersectMode imode, IntersectVariant ivariant)
-      : VerifyApplication::IntersectTest(name,isa,imode,ivariant,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags), quality(quality), gtype(gtype) {}
-    
+    IgnorePrimitiveTest (std::string name, int isa, SceneFlags sflags, GeometryType gtype, IntersectMode imode, IntersectVariant ivariant)
+      : VerifyApplication::IntersectTest(name,isa,imode,ivariant,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags), gtype(gtype) {}
+
     VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
     {
       std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
@@ -2515,52 +3914,48 @@ namespace embree
       errorHandler(nullptr,rtcGetDeviceError(device));
       if (!supportsIntersectMode(device,imode))
         return VerifyApplication::SKIPPED;
-       
-      /* create triangle that is front facing for a right handed 
-         coordinate system if looking along the z direction */
+
+      /* two parallel planes, rays start on the first plane */
       VerifyScene scene(device,sflags);
-      AssertNoError(device);
-      const Vec3fa p0 = Vec3fa(0.0f);
-      const Vec3fa dx = Vec3fa(0.0f,1.0f,0.0f);
-      const Vec3fa dy = Vec3fa(1.0f,0.0f,0.0f);
-      switch (gtype) {
-      case TRIANGLE_MESH:    scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createTrianglePlane(p0,dx,dy,1,1)); break;
-      case TRIANGLE_MESH_MB: scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createTrianglePlane(p0,dx,dy,1,1)->set_motion_vector(zero)); break;
-      case QUAD_MESH:        scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createQuadPlane(p0,dx,dy,1,1)); break;
-      case QUAD_MESH_MB:     scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createQuadPlane(p0,dx,dy,1,1)->set_motion_vector(zero)); break;
-      case GRID_MESH:        scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createGridPlane(p0,dx,dy,1,1)); break;
-      case GRID_MESH_MB:     scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createGridPlane(p0,dx,dy,1,1)->set_motion_vector(zero)); break;
-      case SUBDIV_MESH:      scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createSubdivPlane(p0,dx,dy,1,1,4.0f)); break;
-      case SUBDIV_MESH_MB:   scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createSubdivPlane(p0,dx,dy,1,1,4.0f)->set_motion_vector(zero)); break;
-      default:               throw std::runtime_error("unsupported geometry type: "+to_string(gtype)); 
-      }
-      
-      AssertNoError(device);
+      const unsigned int geomID0 = ContextFlagsTest::addPlane(scene,gtype,Vec3fa(0.0f,0.0f,0.0f));
+      const unsigned int geomID1 = ContextFlagsTest::addPlane(scene,gtype,Vec3fa(0.0f,0.0f,0.25f));
       rtcCommitScene (scene);
       AssertNoError(device);
 
-      const size_t numRays = 1000;
-      RTCRayHit rays[numRays];
       bool passed = true;
-
-      for (size_t i=0; i<numRays; i++) {
+      for (size_t i=0; i<64; i++)
+      {
+        /* find the primitive below the ray origin */
         const float rx = random_float();
         const float ry = random_float();
-        if (i%2) rays[i] = makeRay(Vec3fa(rx,ry,+1),Vec3fa(0,0,-1)); 
-        else     rays[i] = makeRay(Vec3fa(rx,ry,-1),Vec3fa(0,0,+1)); 
-      }
-      
-      IntersectWithMode(imode,ivariant,scene,rays,numRays);
-      
-      for (size_t i=0; i<numRays; i++) 
-      {
-        Vec3fa dir(rays[i].ray.dir_x,rays[i].ray.dir_y,rays[i].ray.dir_z);
-        Vec3fa Ng (rays[i].hit.Ng_x, rays[i].hit.Ng_y, rays[i].hit.Ng_z);
-        if (i%2) passed &= rays[i].hit.geomID == RTC_INVALID_GEOMETRY_ID;
-        else {
-          passed &= rays[i].hit.geomID == 0;
-          if (ivariant & VARIANT_INTERSECT)
-            passed &= dot(dir,Ng) < 0.0f;
+        RTCIntersectContext context;
+        rtcInitIntersectContext(&context);
+        RTCRayHit primary = makeRay(Vec3fa(rx,ry,-1),Vec3fa(0,0,1));
+        rtcIntersect1(scene,&context,&primary);
+        if (primary.hit.geomID != geomID0) return VerifyApplication::FAILED;
+
+        /* ignoring that primitive skips the first plane, but only for the matching instance ID */
+        context.ignoreGeomID = primary.hit.geomID;
+        context.ignorePrimID = primary.hit.primID;
+        const unsigned int instIDs[2] = { RTC_INVALID_GEOMETRY_ID, 0 };
+        for (unsigned int instID : instIDs)
+        {
+          context.ignoreInstID = instID;
+          const bool ignored = instID == RTC_INVALID_GEOMETRY_ID;
+          RTCRayHit rays[2] = { makeRay(Vec3fa(rx,ry,-1),Vec3fa(0,0,1)), makeRay(Vec3fa(rx,ry,0),Vec3fa(0,0,1)) };
+          IntersectWithMode(imode,ivariant,scene,rays,2,context);
+
+          if (!(ivariant & VARIANT_INTERSECT)) {
+            passed &= rays[0].ray.tfar == float(neg_inf);
+            passed &= rays[1].ray.tfar == float(neg_inf);
+            continue;
+          }
+          passed &= rays[0].hit.geomID == (ignored ? geomID1 : geomID0);
+          passed &= abs(rays[0].ray.tfar-(ignored ? 1.25f : 1.0f)) < 1E-4f;
+          if (ignored) {
+            passed &= rays[1].hit.geomID == geomID1;
+            passed &= abs(rays[1].ray.tfar-0.25f) < 1E-4f;
+          }
         }
       }
       AssertNoError(device);
@@ -3671,6 +5066,271 @@ namespace embree
     }
   };
 
+  /* emulates the job system of an application by running each spawned task on a new thread */
+  struct SpawnTasksJobSystem
+  {
+    struct Job
+    {
+      Job (SpawnTasksJobSystem* jobs, RTCTaskFunction task, void* taskPtr)
+        : jobs(jobs), task(task), taskPtr(taskPtr) {}
+
+      SpawnTasksJobSystem* jobs;
+      RTCTaskFunction task;
+      void* taskPtr;
+    };
+
+    static void runJob(Job* job)
+    {
+      job->task(job->taskPtr);
+      job->jobs->numExecuted++;
+      delete job;
+    }
+
+    static void spawnTasks(void* userPtr, RTCTaskFunction task, void* taskPtr, unsigned int numTasks)
+    {
+      SpawnTasksJobSystem* jobs = (SpawnTasksJobSystem*) userPtr;
+      Lock<MutexSys> lock(jobs->mutex);
+      for (unsigned int i=0; i<numTasks; i++) {
+        jobs->threads.push_back(createThread((thread_func)runJob,new Job(jobs,task,taskPtr)));
+        jobs->numSpawned++;
+      }
+    }
+
+    void joinAll()
+    {
+      Lock<MutexSys> lock(mutex);
+      for (size_t i=0; i<threads.size(); i++)
+        join(threads[i]);
+      threads.clear();
+    }
+
+    MutexSys mutex;
+    std::vector<thread_t> threads;
+    std::atomic<size_t> numSpawned {0};
+    std::atomic<size_t> numExecuted {0};
+  };
+
+  struct SpawnTasksTest : public VerifyApplication::Test
+  {
+    thread_func func;
+    float intensity;
+    std::vector<IntersectMode> intersectModes;
+
+    SpawnTasksTest (std::string name, int isa, thread_func func, float intensity)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), func(func), intensity(intensity) {}
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+      intersectModes.push_back(MODE_INTERSECT1);
+
+      SpawnTasksJobSystem jobs;
+      rtcSetDeviceSpawnTasksFunction(device,SpawnTasksJobSystem::spawnTasks,&jobs);
+      AssertNoError(device);
+
+      bool passed = true;
+      for (unsigned int sceneIndex=0; sceneIndex < size_t(intensity*state->intensity); sceneIndex++)
+      {
+        RegressionTask task(this,sceneIndex,1,0,false);
+        func(new ThreadRegressionTask(0,0,state,device,intersectModes,&task));
+        passed &= task.errorCounter == 0;
+      }
+
+      rtcSetDeviceSpawnTasksFunction(device,nullptr,nullptr);
+      AssertNoError(device);
+      jobs.joinAll();
+
+      if (!silent) std::cout << " " << jobs.numSpawned << " tasks spawned " << std::flush;
+      if (jobs.numExecuted != jobs.numSpawned)
+        return VerifyApplication::FAILED;
+      
+      return passed ? VerifyApplication::PASSED : VerifyApplication::FAILED;
+    }
+  };
+
+  struct TaskingStatisticsTest : public VerifyApplication::Test
+  {
+    TaskingStatisticsTest (std::string name, int isa)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS) {}
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+
+      const ssize_t work0 = rtcGetDeviceProperty(device,RTC_DEVICE_PROPERTY_TASKING_WORK_TIME);
+      const ssize_t spin0 = rtcGetDeviceProperty(device,RTC_DEVICE_PROPERTY_TASKING_SPIN_TIME);
+      const ssize_t park0 = rtcGetDeviceProperty(device,RTC_DEVICE_PROPERTY_TASKING_PARK_TIME);
+      AssertNoError(device);
+
+      VerifyScene scene(device,SceneFlags(RTC_SCENE_FLAG_NONE,RTC_BUILD_QUALITY_MEDIUM));
+      scene.addSphere(sampler,RTC_BUILD_QUALITY_MEDIUM,zero,1.0f,500);
+      rtcCommitScene (scene);
+      AssertNoError(device);
+
+      const ssize_t work = rtcGetDeviceProperty(device,RTC_DEVICE_PROPERTY_TASKING_WORK_TIME) - work0;
+      const ssize_t spin = rtcGetDeviceProperty(device,RTC_DEVICE_PROPERTY_TASKING_SPIN_TIME) - spin0;
+      const ssize_t park = rtcGetDeviceProperty(device,RTC_DEVICE_PROPERTY_TASKING_PARK_TIME) - park0;
+      AssertNoError(device);
+
+      if (!silent) std::cout << " work = " << work << " us, spin = " << spin << " us, parked = " << park << " us " << std::flush;
+      if (work < 0 || spin < 0 || park < 0)
+        return VerifyApplication::FAILED;
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct BlockPoolTest : public VerifyApplication::Test
+  {
+    bool huge_pages;
+    
+    BlockPoolTest (std::string name, int isa, bool huge_pages)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), huge_pages(huge_pages) {}
+
+    static bool memoryMonitor(void* userPtr, const ssize_t bytes, const bool /*post*/)
+    {
+      *(std::atomic<ssize_t>*)userPtr += bytes;
+      return true;
+    }
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa) + ",block_pool_size=64";
+      if (huge_pages) cfg += ",block_pool_huge_pages=1";
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+
+      /* scenes get created and released repeatedly, thus later builds reuse pooled blocks */
+      std::atomic<ssize_t> bytes(0);
+      rtcSetDeviceMemoryMonitorFunction(device,memoryMonitor,&bytes);
+      for (size_t i=0; i<8; i++)
+      {
+        {
+          const RTCSceneFlags sflags = i%2 ? RTC_SCENE_FLAG_DYNAMIC : RTC_SCENE_FLAG_NONE;
+          VerifyScene scene(device,SceneFlags(sflags,RTC_BUILD_QUALITY_MEDIUM));
+          scene.addSphere(sampler,RTC_BUILD_QUALITY_MEDIUM,zero,1.0f,10+10*i);
+          rtcCommitScene (scene);
+          AssertNoError(device);
+
+          RTCIntersectContext context;
+          rtcInitIntersectContext(&context);
+          RTCRayHit ray = makeRay(Vec3fa(0.0f,0.0f,-10.0f),Vec3fa(0.0f,0.0f,1.0f));
+          rtcIntersect1(scene,&context,&ray);
+          if (ray.hit.geomID == RTC_INVALID_GEOMETRY_ID || abs(ray.ray.tfar-9.0f) > 0.1f)
+            return VerifyApplication::FAILED;
+        }
+
+        /* pooled blocks do not count as used memory */
+        if (bytes != 0) {
+          if (!silent) std::cout << " " << ssize_t(bytes) << " bytes still in use " << std::flush;
+          return VerifyApplication::FAILED;
+        }
+      }
+      rtcSetDeviceMemoryMonitorFunction(device,nullptr,nullptr);
+      AssertNoError(device);
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  /////////////////////////////////////////////////////////////////////////////////
+  /////////////////////////////////////////////////////////////////////////////////
+  /////////////////////////////////////////////////////////////////////////////////
+  /////////////////////////////////////////////////////////////////////////////////
+
+  struct AllocatorTest : public VerifyApplication::Test
+  {
+    struct Allocations
+    {
+      std::atomic<size_t> numAllocs[4];
+      std::atomic<ssize_t> bytes[4];
+      std::atomic<size_t> numMisaligned;
+    };
+    
+    AllocatorTest (std::string name, int isa)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS) {}
+
+    static void* alloc(void* userPtr, size_t bytes, size_t alignment, RTCAllocationCategory category)
+    {
+      Allocations* allocs = (Allocations*) userPtr;
+      void* ptr = alignedMalloc(bytes,max(alignment,size_t(16)));
+      if (size_t(ptr) & (alignment-1)) allocs->numMisaligned++;
+      allocs->numAllocs[category]++;
+      allocs->bytes[category] += bytes;
+      return ptr;
+    }
+
+    static void free(void* userPtr, void* ptr, size_t bytes, RTCAllocationCategory category)
+    {
+      Allocations* allocs = (Allocations*) userPtr;
+      allocs->bytes[category] -= bytes;
+      alignedFree(ptr);
+    }
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      Allocations allocs;
+      for (size_t i=0; i<4; i++) { allocs.numAllocs[i] = 0; allocs.bytes[i] = 0; }
+      allocs.numMisaligned = 0;
+      
+      {
+        std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+        RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+        errorHandler(nullptr,rtcGetDeviceError(device));
+
+        /* allocator cannot get changed while the device holds memory */
+        RTCBuffer buffer = rtcNewBuffer(device,1024);
+        rtcSetDeviceAllocator(device,alloc,free,&allocs);
+        AssertError(device,RTC_ERROR_INVALID_OPERATION);
+        rtcReleaseBuffer(buffer);
+        rtcSetDeviceAllocator(device,alloc,nullptr,&allocs);
+        AssertError(device,RTC_ERROR_INVALID_ARGUMENT);
+        
+        rtcSetDeviceAllocator(device,alloc,free,&allocs);
+        AssertNoError(device);
+        buffer = rtcNewBuffer(device,1024);
+        rtcReleaseBuffer(buffer);
+
+        for (size_t i=0; i<4; i++)
+        {
+          const RTCSceneFlags sflags = i%2 ? RTC_SCENE_FLAG_DYNAMIC : RTC_SCENE_FLAG_NONE;
+          VerifyScene scene(device,SceneFlags(sflags,RTC_BUILD_QUALITY_MEDIUM));
+          scene.addSphere(sampler,RTC_BUILD_QUALITY_MEDIUM,zero,1.0f,50);
+          rtcCommitScene (scene);
+          AssertNoError(device);
+
+          RTCIntersectContext context;
+          rtcInitIntersectContext(&context);
+          RTCRayHit ray = makeRay(Vec3fa(0.0f,0.0f,-10.0f),Vec3fa(0.0f,0.0f,1.0f));
+          rtcIntersect1(scene,&context,&ray);
+          if (ray.hit.geomID == RTC_INVALID_GEOMETRY_ID || abs(ray.ray.tfar-9.0f) > 0.1f)
+            return VerifyApplication::FAILED;
+        }
+      }
+
+      /* all memory got allocated through the application and returned to it */
+      if (allocs.numAllocs[RTC_ALLOCATION_CATEGORY_BVH] == 0 ||
+          allocs.numAllocs[RTC_ALLOCATION_CATEGORY_PRIMREFS] == 0 ||
+          allocs.numAllocs[RTC_ALLOCATION_CATEGORY_BUFFER] == 0)
+        return VerifyApplication::FAILED;
+
+      if (allocs.numMisaligned != 0)
+        return VerifyApplication::FAILED;
+      
+      for (size_t i=0; i<4; i++) {
+        if (allocs.bytes[i] != 0) {
+          if (!silent) std::cout << " " << ssize_t(allocs.bytes[i]) << " bytes of category " << i << " not freed " << std::flush;
+          return VerifyApplication::FAILED;
+        }
+      }
+      return VerifyApplication::PASSED;
+    }
+  };
+
   /////////////////////////////////////////////////////////////////////////////////
   /////////////////////////////////////////////////////////////////////////////////
   /////////////////////////////////////////////////////////////////////////////////
@@ -4260,6 +5920,8 @@ namespace embree
     sceneFlags.push_back(SceneFlags(RTC_SCENE_FLAG_COMPACT,       RTC_BUILD_QUALITY_MEDIUM));
     sceneFlags.push_back(SceneFlags(RTC_SCENE_FLAG_ROBUST | RTC_SCENE_FLAG_COMPACT,RTC_BUILD_QUALITY_MEDIUM));
     sceneFlags.push_back(SceneFlags(RTC_SCENE_FLAG_NONE,       RTC_BUILD_QUALITY_HIGH));
+    sceneFlags.push_back(SceneFlags(RTC_SCENE_FLAG_AUTOTUNE,      RTC_BUILD_QUALITY_MEDIUM));
+    sceneFlags.push_back(SceneFlags(RTC_SCENE_FLAG_AUTOTUNE | RTC_SCENE_FLAG_ROBUST,RTC_BUILD_QUALITY_MEDIUM));
     sceneFlags.push_back(SceneFlags(RTC_SCENE_FLAG_DYNAMIC,       RTC_BUILD_QUALITY_LOW));
     sceneFlags.push_back(SceneFlags(RTC_SCENE_FLAG_DYNAMIC,       RTC_BUILD_QUALITY_MEDIUM));
     sceneFlags.push_back(SceneFlags(RTC_SCENE_FLAG_DYNAMIC | RTC_SCENE_FLAG_ROBUST,        RTC_BUILD_QUALITY_LOW));
@@ -4320,6 +5982,11 @@ namespace embree
       for (auto gtype : gtypes)
         groups.top()->add(new BufferStrideTest(to_string(gtype),isa,gtype));
       groups.pop();
+
+      push(new TestGroup("mapped_buffer",true,true));
+      groups.top()->add(new MappedBufferTest("triangles",isa,RTC_GEOMETRY_TYPE_TRIANGLE));
+      groups.top()->add(new MappedBufferTest("quads",isa,RTC_GEOMETRY_TYPE_QUAD));
+      groups.pop();
       
       /**************************************************************************/
       /*                        Builder Tests                                   */
@@ -4344,6 +6011,11 @@ namespace embree
       for (auto sflags : sceneFlags) 
         groups.top()->add(new BuildTest(to_string(sflags),isa,sflags,RTC_BUILD_QUALITY_MEDIUM));
       groups.pop();
+
+      push(new TestGroup("commit_scenes",true,true));
+      for (auto sflags : sceneFlags) 
+        groups.top()->add(new CommitScenesTest(to_string(sflags),isa,sflags));
+      groups.pop();
       
       push(new TestGroup("overlapping_primitives",true,false));
       for (auto sflags : sceneFlags)
@@ -4372,12 +6044,24 @@ namespace embree
             if (has_variant(imode,ivariant)) {
               groups.top()->add(new UpdateTest("deformable."+to_string(sflags,imode,ivariant),isa,sflags,RTC_BUILD_QUALITY_REFIT,imode,ivariant));
               groups.top()->add(new UpdateTest("dynamic."+to_string(sflags,imode,ivariant),isa,sflags,RTC_BUILD_QUALITY_LOW,imode,ivariant));
+              groups.top()->add(new UpdateMotionBlurTest("deformable_mblur."+to_string(sflags,imode,ivariant),isa,sflags,imode,ivariant));
             }
           }
         }
       }
       groups.pop();
 
+      groups.top()->add(new TessellationCameraTest("tessellation_camera",isa));
+      groups.top()->add(new TessellationCacheStatsTest("tessellation_cache_stats",isa));
+      groups.top()->add(new SubdivPartialUpdateTest("subdiv_partial_update",isa));
+      groups.top()->add(new MeshPartialRefitTest("triangle_partial_refit",isa,RTC_GEOMETRY_TYPE_TRIANGLE));
+      groups.top()->add(new MeshPartialRefitTest("quad_partial_refit",isa,RTC_GEOMETRY_TYPE_QUAD));
+      groups.top()->add(new ReorderVerticesTest("triangle_reorder_vertices_compact",isa,RTC_GEOMETRY_TYPE_TRIANGLE,RTC_SCENE_FLAG_COMPACT,RTC_BUILD_QUALITY_MEDIUM));
+      groups.top()->add(new ReorderVerticesTest("triangle_reorder_vertices_compact_robust",isa,RTC_GEOMETRY_TYPE_TRIANGLE,RTCSceneFlags(RTC_SCENE_FLAG_COMPACT | RTC_SCENE_FLAG_ROBUST),RTC_BUILD_QUALITY_MEDIUM));
+      groups.top()->add(new ReorderVerticesTest("triangle_reorder_vertices_dynamic",isa,RTC_GEOMETRY_TYPE_TRIANGLE,RTCSceneFlags(RTC_SCENE_FLAG_COMPACT | RTC_SCENE_FLAG_DYNAMIC),RTC_BUILD_QUALITY_LOW));
+      groups.top()->add(new ReorderVerticesTest("triangle_reorder_vertices_fast",isa,RTC_GEOMETRY_TYPE_TRIANGLE,RTC_SCENE_FLAG_NONE,RTC_BUILD_QUALITY_MEDIUM));
+      groups.top()->add(new ReorderVerticesTest("quad_reorder_vertices_compact",isa,RTC_GEOMETRY_TYPE_QUAD,RTC_SCENE_FLAG_COMPACT,RTC_BUILD_QUALITY_MEDIUM));
+
 #if !defined(TASKING_PPL) // FIXME: PPL has some issues here!
       groups.top()->add(new GarbageGeometryTest("build_garbage_geom",isa));
 #endif
@@ -4449,6 +6133,38 @@ namespace embree
                 groups.top()->add(new QuadHitTest(to_string(sflags,imode,ivariant),isa,sflags,RTC_BUILD_QUALITY_MEDIUM,imode,ivariant));
       groups.pop();
 
+      push(new TestGroup("quaternion_instance",true,true));
+      for (auto sflags : sceneFlags) 
+        for (auto imode : intersectModes) 
+          for (auto ivariant : intersectVariants)
+            if (has_variant(imode,ivariant))
+                groups.top()->add(new QuaternionInstanceTest(to_string(sflags,imode,ivariant),isa,sflags,imode,ivariant));
+      groups.pop();
+
+      push(new TestGroup("instance_level_of_detail",true,true));
+      for (auto sflags : sceneFlags) 
+        for (auto imode : intersectModes) 
+          for (auto ivariant : intersectVariants)
+            if (has_variant(imode,ivariant))
+                groups.top()->add(new InstanceLevelOfDetailTest(to_string(sflags,imode,ivariant),isa,sflags,imode,ivariant));
+      groups.pop();
+
+      push(new TestGroup("lazy_instance",true,true));
+      for (auto sflags : sceneFlags) 
+        for (auto imode : intersectModes) 
+          for (auto ivariant : intersectVariants)
+            if (has_variant(imode,ivariant))
+                groups.top()->add(new LazyInstanceTest(to_string(sflags,imode,ivariant),isa,sflags,imode,ivariant));
+      groups.pop();
+
+      push(new TestGroup("user_geometry_batch",true,true));
+      for (auto sflags : sceneFlags) 
+        for (auto imode : intersectModes) 
+          for (auto ivariant : intersectVariants)
+            if (has_variant(imode,ivariant))
+                groups.top()->add(new UserGeometryBatchTest(to_string(sflags,imode,ivariant),isa,sflags,imode,ivariant));
+      groups.pop();
+
       if (rtcGetDeviceProperty(device,RTC_DEVICE_PROPERTY_RAY_MASK_SUPPORTED)) 
       {
         push(new TestGroup("ray_masks",true,true));
@@ -4458,6 +6174,14 @@ namespace embree
               if (has_variant(imode,ivariant))
                   groups.top()->add(new RayMasksTest(to_string(sflags,imode,ivariant),isa,sflags,RTC_BUILD_QUALITY_MEDIUM,imode,ivariant));
         groups.pop();
+
+        push(new TestGroup("ray_mask_update",true,true));
+        for (auto sflags : sceneFlags) 
+          for (auto imode : intersectModes) 
+            for (auto ivariant : intersectVariants)
+              if (has_variant(imode,ivariant))
+                  groups.top()->add(new RayMaskUpdateTest(to_string(sflags,imode,ivariant),isa,sflags,imode,ivariant));
+        groups.pop();
       }
       
       if (rtcGetDeviceProperty(device,RTC_DEVICE_PROPERTY_BACKFACE_CULLING_ENABLED)) 
@@ -4471,6 +6195,27 @@ namespace embree
                     groups.top()->add(new BackfaceCullingTest(to_string(gtype,sflags,imode,ivariant),isa,sflags,RTC_BUILD_QUALITY_MEDIUM,gtype,imode,ivariant));
         groups.pop();
       }
+
+      if (rtcGetDeviceProperty(device,RTC_DEVICE_PROPERTY_FILTER_FUNCTION_SUPPORTED))
+      {
+        push(new TestGroup("context_flags",true,true));
+        for (auto gtype : gtypes)
+          for (auto sflags : sceneFlags)
+            for (auto imode : intersectModes)
+              for (auto ivariant : intersectVariants)
+                if (has_variant(imode,ivariant))
+                  groups.top()->add(new ContextFlagsTest(to_string(gtype,sflags,imode,ivariant),isa,sflags,gtype,imode,ivariant));
+        groups.pop();
+      }
+
+      push(new TestGroup("ignore_primitive",true,true));
+      for (auto gtype : gtypes)
+        for (auto sflags : sceneFlags)
+          for (auto imode : intersectModes)
+            for (auto ivariant : intersectVariants)
+              if (has_variant(imode,ivariant))
+                groups.top()->add(new IgnorePrimitiveTest(to_string(gtype,sflags,imode,ivariant),isa,sflags,gtype,imode,ivariant));
+      groups.pop();
       
       push(new TestGroup("intersection_filter",true,true));
       if (rtcGetDeviceProperty(device,RTC_DEVICE_PROPERTY_FILTER_FUNCTION_SUPPORTED)) 
@@ -4620,6 +6365,14 @@ namespace embree
 
       groups.top()->add(new MemoryMonitorTest("regression_static_memory_monitor", isa,rtcore_regression_static_thread,30));
       groups.top()->add(new MemoryMonitorTest("regression_dynamic_memory_monitor",isa,rtcore_regression_dynamic_thread,30));
+
+      if (rtcGetDeviceProperty(device,RTC_DEVICE_PROPERTY_SPAWN_TASKS_FUNCTION_SUPPORTED))
+        groups.top()->add(new SpawnTasksTest("regression_static_spawn_tasks",isa,rtcore_regression_static_thread,10));
+
+      groups.top()->add(new TaskingStatisticsTest("tasking_statistics",isa));
+      groups.top()->add(new BlockPoolTest("block_pool",isa,false));
+      groups.top()->add(new BlockPoolTest("block_pool_huge_pages",isa,true));
+      groups.top()->add(new AllocatorTest("allocator",isa));
       
       /**************************************************************************/
       /*                           Benchmarks                                   */